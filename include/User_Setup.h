@@ -14,7 +14,7 @@
 
 // Hardware SPI on ESP8266 uses:
 // MOSI (D7) = GPIO13
-// MISO (D6) = GPIO12 (not used for display)
+// MISO (D6) = GPIO12 (optional: wire to the module's SDO for SPI clock calibration)
 // SCK  (D5) = GPIO14
 
 // Fonts
@@ -28,7 +28,12 @@
 
 #define SMOOTH_FONT
 
+// Required with the MAX7219 display sink (MAX7219_SINK_ENABLED - the build stops
+// without it) so TFT_eSPI restores its own SPI settings after each MAX7219 write.
+// Disables SPI clock calibration: every write then runs at SPI_FREQUENCY.
+// #define SUPPORT_TRANSACTIONS
+
 // SPI frequency
-#define SPI_FREQUENCY  40000000  // 40 MHz for ESP8266
+#define SPI_FREQUENCY  40000000  // 40 MHz for ESP8266 (replaced at runtime by a calibrated clock, see SPI_CAL_ENABLED)
 #define SPI_READ_FREQUENCY  20000000
 #define SPI_TOUCH_FREQUENCY  2500000
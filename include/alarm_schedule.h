@@ -0,0 +1,228 @@
+/*
+ * alarm_schedule.h - Alarms and Recurring Schedules with a Precomputed Next Trigger
+ *
+ * Every alarm is a local wall-clock time plus a day rule, 12 bytes each:
+ * - one-off:  cycle = 0, fires on `day` only (then disables itself)
+ * - cycle:    cycle = N (1-32) days starting at `day`; bit i of `mask` set =
+ *             fires on day i of each cycle. Daily is N = 1, weekly is N = 7
+ *             anchored on a Sunday (ALARM_SUNDAY), shift rotas are any other
+ *             N, e.g. 4 on / 4 off = N 8, mask 0x0F
+ * Days are local dates counted from 2000-01-01.
+ *
+ * recompute() walks each enabled alarm's days from the local date of `after`
+ * until its first firing day, converts that day's local time to UTC with
+ * mktime() - which applies the DST rule of that date, so a 07:00 alarm stays
+ * at 07:00 across clock changes - and keeps the earliest. All alarms due at
+ * that instant are kept as a bitmask. poll() is then a single comparison per
+ * tick; the full walk only runs after an edit, after an alarm fires, or
+ * when the wall clock or timezone changes.
+ *
+ * Local times that don't exist (spring-forward gap) fire at the equivalent
+ * time after the jump; repeated ones (fall-back) fire once.
+ *
+ * Uses only the C library time functions and the TZ environment variable,
+ * so schedules can be run on a host against a simulated clock.
+ */
+
+#ifndef ALARM_SCHEDULE_H
+#define ALARM_SCHEDULE_H
+
+#include <Arduino.h>
+#include <time.h>
+
+#define ALARM_MAX          16
+#define ALARM_MAX_CYCLE    32
+#define ALARM_SUNDAY       1      // Day 1 (2000-01-02) - anchor for weekly alarms
+#define ALARM_GRACE_SEC    120    // Fire if the clock jumps at most this far past a trigger
+#define ALARM_NONE         ((time_t)-1)
+
+#define ALARM_ENABLED      0x01
+
+enum AlarmAction : uint8_t {
+  ALARM_FLASH = 0,  // Flash the matrix for `arg` seconds
+  ALARM_MODE  = 1   // Switch to display mode `arg`
+};
+
+struct Alarm {
+  uint8_t  hour, minute;
+  uint8_t  cycle;    // 0 = one-off on `day`; 1-32 = repeat every `cycle` days from `day`
+  uint8_t  action;   // AlarmAction
+  uint8_t  arg;
+  uint8_t  flags;    // ALARM_ENABLED
+  uint16_t day;      // Days since 2000-01-01
+  uint32_t mask;     // Bit i = fires on day i of the cycle
+};
+
+class AlarmSchedule {
+public:
+  AlarmSchedule() : alarmCount(0), next(ALARM_NONE), nextMask(0), changed(false), recomputes(0) {}
+
+  // Days since 2000-01-01 for a civil date (proleptic Gregorian)
+  static int32_t dayNumber(int year, int month, int day) {
+    year -= month <= 2;
+    int32_t era = (year >= 0 ? year : year - 399) / 400;
+    int32_t yoe = year - era * 400;
+    int32_t doy = (153 * (month + (month > 2 ? -3 : 9)) + 2) / 5 + day - 1;
+    int32_t doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+    return era * 146097 + doe - 730425;  // Epoch moved from 0000-03-01 to 2000-01-01
+  }
+
+  static void dayToDate(int32_t dayNum, int& year, int& month, int& day) {
+    int32_t z = dayNum + 730425;
+    int32_t era = (z >= 0 ? z : z - 146096) / 146097;
+    int32_t doe = z - era * 146097;
+    int32_t yoe = (doe - doe / 1460 + doe / 36524 - doe / 146096) / 365;
+    int32_t doy = doe - (365 * yoe + yoe / 4 - yoe / 100);
+    int32_t mp = (5 * doy + 2) / 153;
+    day = doy - (153 * mp + 2) / 5 + 1;
+    month = mp < 10 ? mp + 3 : mp - 9;
+    year = yoe + era * 400 + (month <= 2);
+  }
+
+  static bool valid(const Alarm& a) {
+    return a.hour < 24 && a.minute < 60 && a.cycle <= ALARM_MAX_CYCLE &&
+           (a.cycle == 0 || (a.mask & cycleBits(a.cycle)) != 0);
+  }
+
+  // ---- Editing (call recompute() afterwards) ----
+
+  int add(const Alarm& a) {
+    if (alarmCount >= ALARM_MAX || !valid(a)) return -1;
+    alarms[alarmCount] = a;
+    changed = true;
+    return alarmCount++;
+  }
+
+  bool remove(int i) {
+    if (i < 0 || i >= alarmCount) return false;
+    for (int j = i; j < alarmCount - 1; j++) alarms[j] = alarms[j + 1];
+    alarmCount--;
+    changed = true;
+    return true;
+  }
+
+  bool setEnabled(int i, bool on) {
+    if (i < 0 || i >= alarmCount) return false;
+    if (on) alarms[i].flags |= ALARM_ENABLED;
+    else alarms[i].flags &= ~ALARM_ENABLED;
+    changed = true;
+    return true;
+  }
+
+  void clear() {
+    alarmCount = 0;
+    changed = true;
+  }
+
+  // Replace the whole table (e.g. loaded from EEPROM); invalid entries are dropped
+  void load(const Alarm* table, int n) {
+    alarmCount = 0;
+    for (int i = 0; i < n && i < ALARM_MAX; i++) {
+      if (valid(table[i])) alarms[alarmCount++] = table[i];
+    }
+    changed = false;
+  }
+
+  // ---- Next-trigger index ----
+
+  // Earliest trigger strictly after `after` (UTC) and the alarms due then
+  void recompute(time_t after) {
+    recomputes++;
+    next = ALARM_NONE;
+    nextMask = 0;
+
+    struct tm local;
+    localtime_r(&after, &local);
+    int32_t today = dayNumber(local.tm_year + 1900, local.tm_mon + 1, local.tm_mday);
+
+    for (int i = 0; i < alarmCount; i++) {
+      const Alarm& a = alarms[i];
+      if (!(a.flags & ALARM_ENABLED)) continue;
+      time_t t = firstTrigger(a, today, after);
+      if (t == ALARM_NONE) continue;
+      if (next == ALARM_NONE || t < next) {
+        next = t;
+        nextMask = 1U << i;
+      } else if (t == next) {
+        nextMask |= 1U << i;
+      }
+    }
+  }
+
+  // Bitmask of alarms that fire at `now` (0 almost always - one comparison).
+  // One-offs disable themselves; the index moves on to the following trigger.
+  uint16_t poll(time_t now) {
+    if (next == ALARM_NONE || now < next) return 0;
+    uint16_t due = now - next <= ALARM_GRACE_SEC ? nextMask : 0;  // Skip stale triggers after a clock jump
+    for (int i = 0; i < alarmCount; i++) {
+      if ((due & (1U << i)) && alarms[i].cycle == 0) {
+        alarms[i].flags &= ~ALARM_ENABLED;
+        changed = true;
+      }
+    }
+    recompute(now > next ? now : next);
+    return due;
+  }
+
+  time_t nextTrigger() const { return next; }
+  uint16_t nextAlarms() const { return nextMask; }
+  int count() const { return alarmCount; }
+  const Alarm& alarm(int i) const { return alarms[i]; }
+  const Alarm* table() const { return alarms; }
+  uint32_t recomputeCount() const { return recomputes; }
+
+  // Set by edits and fired one-offs; the caller persists and clears it
+  bool needsSave() const { return changed; }
+  void saved() { changed = false; }
+
+private:
+  static uint32_t cycleBits(uint8_t cycle) {
+    return cycle >= 32 ? 0xFFFFFFFFUL : (1UL << cycle) - 1;
+  }
+
+  static bool firesOn(const Alarm& a, int32_t dayNum) {
+    if (a.cycle == 0) return dayNum == a.day;
+    int32_t offset = (dayNum - a.day) % a.cycle;
+    if (offset < 0) offset += a.cycle;
+    return (a.mask >> offset) & 1;
+  }
+
+  // Local hour:minute on dayNum as UTC, with that date's DST rule
+  static time_t localToUtc(int32_t dayNum, uint8_t hour, uint8_t minute) {
+    int y, m, d;
+    dayToDate(dayNum, y, m, d);
+    struct tm t;
+    memset(&t, 0, sizeof(t));
+    t.tm_year = y - 1900;
+    t.tm_mon = m - 1;
+    t.tm_mday = d;
+    t.tm_hour = hour;
+    t.tm_min = minute;
+    t.tm_isdst = -1;
+    return mktime(&t);
+  }
+
+  // Yesterday is included: near midnight a DST shift can move it past `after`
+  static time_t firstTrigger(const Alarm& a, int32_t today, time_t after) {
+    if (a.cycle == 0) {
+      if (a.day < today - 1) return ALARM_NONE;
+      time_t t = localToUtc(a.day, a.hour, a.minute);
+      return t > after ? t : ALARM_NONE;
+    }
+    for (int32_t d = today - 1; d <= today + a.cycle + 1; d++) {
+      if (!firesOn(a, d)) continue;
+      time_t t = localToUtc(d, a.hour, a.minute);
+      if (t > after) return t;
+    }
+    return ALARM_NONE;
+  }
+
+  Alarm alarms[ALARM_MAX];
+  int alarmCount;
+  time_t next;
+  uint16_t nextMask;
+  bool changed;
+  uint32_t recomputes;
+};
+
+#endif // ALARM_SCHEDULE_H
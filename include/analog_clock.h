@@ -0,0 +1,114 @@
+/*
+ * analog_clock.h - Analog Clock Face on the 16-Pixel Matrix
+ *
+ * A 15x15 dial (centre pixel 7,7) composed straight into scr columns:
+ * - 12 hour ticks on the rim, rasterised once in begin()
+ * - minute and hour hands drawn with integer Bresenham lines, each into a
+ *   column bitmap (one uint16_t per column, bit y = row y) that is cached
+ *   per angle (60 positions each), so a hand is rasterised at most once
+ *   and every later tick just ORs the cached columns together
+ * - seconds as a single rim dot, XORed so it stays visible over a tick
+ *
+ * Per tick that is 15 column ORs and one bit flip, with no font lookups.
+ * The cache fills lazily: 2 x 60 x 30 bytes once every angle has been seen.
+ */
+
+#ifndef ANALOG_CLOCK_H
+#define ANALOG_CLOCK_H
+
+#include <Arduino.h>
+#include <math.h>
+
+#define ANALOG_FACE_SIZE    15
+#define ANALOG_CENTER       7
+#define ANALOG_RIM_RADIUS   7
+#define ANALOG_MINUTE_LEN   6
+#define ANALOG_HOUR_LEN     4
+#define ANALOG_POSITIONS    60  // 6 degrees per step
+
+class AnalogClock {
+public:
+  AnalogClock() : minuteValid(0), hourValid(0), rasterised(0), hits(0) {
+    memset(face, 0, sizeof(face));
+  }
+
+  // Rim positions and the static dial
+  void begin() {
+    for (int a = 0; a < ANALOG_POSITIONS; a++) {
+      endpoint(a, ANALOG_RIM_RADIUS, rimX[a], rimY[a]);
+    }
+    memset(face, 0, sizeof(face));
+    for (int a = 0; a < ANALOG_POSITIONS; a += 5) {
+      face[rimX[a]] |= 1 << rimY[a];
+    }
+    face[ANALOG_CENTER] |= 1 << ANALOG_CENTER;
+    minuteValid = hourValid = 0;
+  }
+
+  // Dial into frame columns x0..x0+14 (rows 0-14), e.g. frame = scr.
+  // hour12 is 0-11; the hour hand advances every 12 minutes.
+  void compose(uint8_t* frame, int lineWidth, int x0, int hour12, int minute, int second) {
+    const uint16_t* m = hand(minuteHands, minuteValid, minute % 60, ANALOG_MINUTE_LEN);
+    const uint16_t* h = hand(hourHands, hourValid, (hour12 % 12) * 5 + minute / 12, ANALOG_HOUR_LEN);
+    for (int x = 0; x < ANALOG_FACE_SIZE; x++) {
+      uint16_t col = face[x] | m[x] | h[x];
+      if (x == rimX[second % 60]) col ^= 1 << rimY[second % 60];
+      frame[x0 + x] = col & 0xFF;
+      frame[x0 + x + lineWidth] = col >> 8;
+    }
+  }
+
+  uint32_t rasterCount() const { return rasterised; }  // Hands drawn with Bresenham
+  uint32_t cacheHits() const { return hits; }
+  int cachedAngles() const {
+    return __builtin_popcountll(minuteValid) + __builtin_popcountll(hourValid);
+  }
+
+private:
+  // Offset from centre at angle step a (0 = 12 o'clock, clockwise)
+  static void endpoint(int a, int length, int8_t& x, int8_t& y) {
+    double theta = a * M_PI / 30;
+    x = ANALOG_CENTER + (int8_t)lround(length * sin(theta));
+    y = ANALOG_CENTER - (int8_t)lround(length * cos(theta));
+  }
+
+  const uint16_t* hand(uint16_t (*table)[ANALOG_FACE_SIZE], uint64_t& valid, int a, int length) {
+    if (valid & (1ULL << a)) {
+      hits++;
+      return table[a];
+    }
+    int8_t x, y;
+    endpoint(a, length, x, y);
+    memset(table[a], 0, sizeof(table[a]));
+    line(table[a], ANALOG_CENTER, ANALOG_CENTER, x, y);
+    valid |= 1ULL << a;
+    rasterised++;
+    return table[a];
+  }
+
+  // Integer Bresenham into column bitmaps
+  static void line(uint16_t* cols, int x0, int y0, int x1, int y1) {
+    int dx = abs(x1 - x0), sx = x0 < x1 ? 1 : -1;
+    int dy = -abs(y1 - y0), sy = y0 < y1 ? 1 : -1;
+    int err = dx + dy;
+    for (;;) {
+      cols[x0] |= 1 << y0;
+      if (x0 == x1 && y0 == y1) break;
+      int e2 = 2 * err;
+      if (e2 >= dy) { err += dy; x0 += sx; }
+      if (e2 <= dx) { err += dx; y0 += sy; }
+    }
+  }
+
+  uint16_t face[ANALOG_FACE_SIZE];
+  uint16_t minuteHands[ANALOG_POSITIONS][ANALOG_FACE_SIZE];
+  uint16_t hourHands[ANALOG_POSITIONS][ANALOG_FACE_SIZE];
+  uint64_t minuteValid;  // Bit a set = minuteHands[a] rasterised
+  uint64_t hourValid;
+  int8_t   rimX[ANALOG_POSITIONS];
+  int8_t   rimY[ANALOG_POSITIONS];
+  uint32_t rasterised;
+  uint32_t hits;
+};
+
+#endif // ANALOG_CLOCK_H
@@ -0,0 +1,73 @@
+/*
+ * display_sink.h - Display Backend Interface
+ *
+ * A sink receives the 64-byte scr frame plus a dirty mask and pushes it to
+ * a physical or virtual panel. refreshAll() computes the mask once and
+ * hands the same frame to every registered sink, so firmware logic does not
+ * care whether it drives the TFT, a real MAX7219 chain or a RAM framebuffer.
+ *
+ * Frame layout (same as scr): frame[x + row * LINE_WIDTH], one byte per
+ * 8 vertical pixels, bit 0 = top pixel of the row.
+ *
+ * Dirty mask: bit i set = frame[i] changed since the previous present().
+ *
+ * Panning: before a present() the caller may ask a sink to shift what is
+ * already on the panel left by some columns (wrapping round). A sink that
+ * can do that in hardware returns true and is then given the dirty mask
+ * against the shifted picture, so only the columns that differ from it
+ * are drawn.
+ */
+
+#ifndef DISPLAY_SINK_H
+#define DISPLAY_SINK_H
+
+#include <Arduino.h>
+#include "led_renderer.h"
+
+#if !defined(LINE_WIDTH) || !defined(DISPLAY_ROWS)
+  #error "Define LINE_WIDTH and DISPLAY_ROWS before including display_sink.h"
+#endif
+
+#define FRAME_BYTES      (LINE_WIDTH * DISPLAY_ROWS)
+#define FRAME_ALL_DIRTY  0xFFFFFFFFFFFFFFFFULL
+#define MAX_DISPLAY_SINKS 4
+
+#if FRAME_BYTES > 64
+  #error "Dirty mask is 64 bits - one bit per frame byte"
+#endif
+
+class DisplaySink {
+public:
+  virtual ~DisplaySink() {}
+  virtual const char* name() const = 0;
+  virtual void begin() {}
+  virtual void present(const uint8_t* frame, uint64_t dirty, const LedStyle& style) = 0;
+  virtual bool pan(int columns) { return false; }
+};
+
+// Bit i of the result is set where frame[i] differs from previous[i];
+// previous is updated to match frame.
+inline uint64_t frameDiff(const uint8_t* frame, uint8_t* previous) {
+  uint64_t dirty = 0;
+  for (int i = 0; i < FRAME_BYTES; i++) {
+    if (frame[i] != previous[i]) {
+      dirty |= 1ULL << i;
+      previous[i] = frame[i];
+    }
+  }
+  return dirty;
+}
+
+// As frameDiff(), against previous with each row shifted left by `columns`
+// (wrapping) - what a panel shows after pan(columns). previous is not updated.
+inline uint64_t frameDiffPanned(const uint8_t* frame, const uint8_t* previous, int columns) {
+  uint64_t dirty = 0;
+  for (int i = 0; i < FRAME_BYTES; i++) {
+    int row = i / LINE_WIDTH;
+    int x = (i % LINE_WIDTH + columns) % LINE_WIDTH;
+    if (frame[i] != previous[x + row * LINE_WIDTH]) dirty |= 1ULL << i;
+  }
+  return dirty;
+}
+
+#endif // DISPLAY_SINK_H
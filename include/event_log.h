@@ -0,0 +1,167 @@
+/*
+ * event_log.h - Deferred Ring-Buffer Logger
+ *
+ * Logging a message stores a compact binary record (timestamp, module,
+ * level, format pointer, up to LOG_MAX_ARGS integer args) in a RAM ring -
+ * about a microsecond, no formatting and no Serial I/O. drain() formats
+ * records later, from idle time, and only writes as many bytes as the
+ * UART FIFO can take without blocking.
+ *
+ * Rules for callers:
+ * - format strings must be literals (records keep the pointer); LOG()
+ *   wraps them in PSTR() so they live in flash
+ * - args are integers, chars or pointers to strings that outlive the
+ *   record (literals, const tables) - no floats, no temporary Strings
+ *
+ * Usage (expects a global EventLog named eventLog):
+ *   LOG(LOG_NTP, LOG_INFO, "Time synced: %02d:%02d", h, m);
+ *
+ * Per-module levels are checked before anything is stored, so filtered
+ * messages cost one compare. When the ring wraps, the oldest records are
+ * overwritten and counted as dropped for the serial drain.
+ */
+
+#ifndef EVENT_LOG_H
+#define EVENT_LOG_H
+
+#include <Arduino.h>
+#include <type_traits>
+
+#define LOG_RING_SIZE   48
+#define LOG_MAX_ARGS    6
+#define LOG_LINE_MAX    128
+
+enum LogLevel : uint8_t { LOG_ERROR = 0, LOG_WARN, LOG_INFO, LOG_DEBUG };
+enum LogModule : uint8_t { LOG_SYS = 0, LOG_DISPLAY, LOG_WIFI, LOG_NTP, LOG_SENSOR, LOG_HTTP, LOG_MODULES };
+
+static const char* const logModuleNames[LOG_MODULES] = {"sys", "display", "wifi", "ntp", "sensor", "http"};
+static const char* const logLevelNames[] = {"error", "warn", "info", "debug"};
+
+struct LogRecord {
+  uint32_t    ms;
+  uint8_t     module;
+  uint8_t     level;
+  const char* fmt;          // PROGMEM format string
+  uintptr_t   args[LOG_MAX_ARGS];
+};
+
+class EventLog {
+public:
+  EventLog() : head(0), total(0), drained(0), dropped(0), linePos(0), lineLen(0) {
+    for (int i = 0; i < LOG_MODULES; i++) levels[i] = LOG_INFO;
+  }
+
+  bool enabled(uint8_t module, uint8_t level) const {
+    return module < LOG_MODULES && level <= levels[module];
+  }
+
+  template <typename... Args>
+  void log(uint8_t module, uint8_t level, const char* fmt, Args... args) {
+    static_assert(sizeof...(Args) <= LOG_MAX_ARGS, "Too many log arguments");
+    if (!enabled(module, level)) return;
+    LogRecord& r = ring[head];
+    r.ms = millis();
+    r.module = module;
+    r.level = level;
+    r.fmt = fmt;
+    storeArgs(r.args, args...);
+    head = (head + 1) % LOG_RING_SIZE;
+    total++;
+  }
+
+  // Write pending records to out without blocking. Returns bytes written.
+  template <class Out>
+  size_t drain(Out& out) {
+    size_t written = 0;
+    for (;;) {
+      if (linePos >= lineLen) {
+        if (drained == total) break;
+        if (total - drained > LOG_RING_SIZE) {  // Overwritten before we got to them
+          dropped += total - drained - LOG_RING_SIZE;
+          drained = total - LOG_RING_SIZE;
+        }
+        lineLen = format(recordAt(drained), line, sizeof(line) - 1);
+        line[lineLen++] = '\n';
+        linePos = 0;
+        drained++;
+      }
+      int room = out.availableForWrite();
+      if (room <= 0) break;
+      size_t chunk = lineLen - linePos;
+      if ((size_t)room < chunk) chunk = room;
+      out.write((const uint8_t*)line + linePos, chunk);
+      linePos += chunk;
+      written += chunk;
+    }
+    return written;
+  }
+
+  // "[   12.345] ntp     info  Time synced ..." into buf, returns length
+  size_t format(const LogRecord& r, char* buf, size_t size) const {
+    char msg[LOG_LINE_MAX];
+    snprintf_P(msg, sizeof(msg), r.fmt, r.args[0], r.args[1], r.args[2], r.args[3], r.args[4], r.args[5]);
+    int len = snprintf(buf, size, "[%6lu.%03lu] %-7s %-5s %s",
+                       (unsigned long)(r.ms / 1000), (unsigned long)(r.ms % 1000),
+                       logModuleNames[r.module], logLevelNames[r.level], msg);
+    if (len < 0) return 0;
+    return (size_t)len < size ? (size_t)len : size - 1;
+  }
+
+  // Message text only (no timestamp/module prefix)
+  size_t formatMessage(const LogRecord& r, char* buf, size_t size) const {
+    int len = snprintf_P(buf, size, r.fmt, r.args[0], r.args[1], r.args[2], r.args[3], r.args[4], r.args[5]);
+    if (len < 0) return 0;
+    return (size_t)len < size ? (size_t)len : size - 1;
+  }
+
+  // i = 0 is the oldest record still in the ring
+  int available() const { return total < LOG_RING_SIZE ? total : LOG_RING_SIZE; }
+  const LogRecord& recent(int i) const { return recordAt(total - available() + i); }
+
+  void setLevel(uint8_t module, uint8_t level) {
+    if (module < LOG_MODULES && level <= LOG_DEBUG) levels[module] = level;
+  }
+  uint8_t level(uint8_t module) const { return levels[module]; }
+
+  static int moduleByName(const char* name) {
+    for (int i = 0; i < LOG_MODULES; i++) {
+      if (strcmp(name, logModuleNames[i]) == 0) return i;
+    }
+    return -1;
+  }
+
+  uint32_t totalRecords() const { return total; }
+  uint32_t droppedRecords() const { return dropped; }
+  uint32_t pendingRecords() const { return total - drained; }
+
+private:
+  const LogRecord& recordAt(uint32_t seq) const { return ring[seq % LOG_RING_SIZE]; }
+
+  static void storeArgs(uintptr_t* out) {
+    (void)out;
+  }
+  template <typename T, typename... Rest>
+  static void storeArgs(uintptr_t* out, T first, Rest... rest) {
+    *out = toArg(first);
+    storeArgs(out + 1, rest...);
+  }
+  template <typename T>
+  static uintptr_t toArg(T value) {
+    static_assert(!std::is_floating_point<T>::value, "Log floats as scaled integers");
+    return (uintptr_t)value;
+  }
+
+  LogRecord ring[LOG_RING_SIZE];
+  uint8_t levels[LOG_MODULES];
+  uint32_t head;
+  uint32_t total;     // Records ever logged (sequence number of the next one)
+  uint32_t drained;   // Records already written to serial
+  uint32_t dropped;   // Overwritten before reaching serial
+  char line[LOG_LINE_MAX + 32];
+  size_t linePos;
+  size_t lineLen;
+};
+
+#define LOG(module, level, fmt, ...) eventLog.log(module, level, PSTR(fmt), ##__VA_ARGS__)
+
+#endif // EVENT_LOG_H
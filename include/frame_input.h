@@ -0,0 +1,145 @@
+/*
+ * frame_input.h - Realtime Frame Input Protocol
+ *
+ * Lets an external sender (shop server, animation script) drive the matrix
+ * over UDP. Packets carry either a whole scr[] bitmap or a list of changed
+ * bytes, with a sequence number; frames replace the clock until no packet
+ * has arrived for the timeout, then the clock takes over again.
+ *
+ * Packet layout (little-endian):
+ *   0  'R' 'F'        magic
+ *   2  type           FRAME_PKT_FULL | FRAME_PKT_DELTA | FRAME_PKT_RELEASE
+ *   3  flags          reserved, send 0
+ *   4  seq (uint16)   incremented per packet, wraps
+ *   6  timeout (u16)  ms to hold the last frame, 0 = FRAME_INPUT_TIMEOUT
+ *   8  payload        FULL:  FRAME_BYTES bytes in scr[] order
+ *                     DELTA: (offset, value) byte pairs
+ *                     RELEASE: none - hand the display back to the clock now
+ *
+ * Packets older than the last accepted one (by 16-bit serial arithmetic)
+ * are dropped; a gap counts the missing packets as lost. A new session
+ * (first packet after a timeout) accepts any sequence number.
+ *
+ * The decoder is transport-agnostic - the caller feeds it datagrams - so it
+ * runs unchanged off-target.
+ */
+
+#ifndef FRAME_INPUT_H
+#define FRAME_INPUT_H
+
+#include <Arduino.h>
+#include "display_sink.h"
+
+#ifndef FRAME_INPUT_TIMEOUT
+  #define FRAME_INPUT_TIMEOUT 2000
+#endif
+
+#define FRAME_PKT_HEADER   8
+#define FRAME_PKT_FULL     0x01
+#define FRAME_PKT_DELTA    0x02
+#define FRAME_PKT_RELEASE  0x03
+#define FRAME_PKT_MAX      (FRAME_PKT_HEADER + FRAME_BYTES * 2)
+
+struct FrameInputStats {
+  uint32_t packets;    // Datagrams received
+  uint32_t frames;     // Accepted FULL/DELTA packets
+  uint32_t stale;      // Out-of-order or duplicate, dropped
+  uint32_t lost;       // Sequence gaps
+  uint32_t malformed;  // Bad magic/type/length
+  uint32_t sessions;   // Times external input took over from the clock
+};
+
+class FrameInput {
+public:
+  FrameInput() : active(false), dirty(false), lastSeq(0), lastPacketMs(0), holdMs(FRAME_INPUT_TIMEOUT) {
+    memset(frame, 0, sizeof(frame));
+    memset(&stats, 0, sizeof(stats));
+  }
+
+  // Decode one datagram. Returns true if the frame changed.
+  bool handlePacket(const uint8_t* data, size_t len, uint32_t nowMs) {
+    stats.packets++;
+    if (len < FRAME_PKT_HEADER || data[0] != 'R' || data[1] != 'F') {
+      stats.malformed++;
+      return false;
+    }
+    uint8_t type = data[2];
+    uint16_t seq = data[4] | (data[5] << 8);
+    uint16_t timeout = data[6] | (data[7] << 8);
+    const uint8_t* payload = data + FRAME_PKT_HEADER;
+    size_t payloadLen = len - FRAME_PKT_HEADER;
+
+    if ((type == FRAME_PKT_FULL && payloadLen != FRAME_BYTES) ||
+        (type == FRAME_PKT_DELTA && (payloadLen & 1)) ||
+        (type < FRAME_PKT_FULL || type > FRAME_PKT_RELEASE)) {
+      stats.malformed++;
+      return false;
+    }
+
+    expire(nowMs);
+    if (active) {
+      int16_t ahead = (int16_t)(seq - lastSeq);
+      if (ahead <= 0) {
+        stats.stale++;
+        return false;
+      }
+      stats.lost += ahead - 1;
+    }
+    lastSeq = seq;
+
+    if (type == FRAME_PKT_RELEASE) {
+      active = false;
+      return false;
+    }
+
+    if (!active) {
+      active = true;
+      stats.sessions++;
+    }
+    lastPacketMs = nowMs;
+    holdMs = timeout ? timeout : FRAME_INPUT_TIMEOUT;
+    stats.frames++;
+
+    if (type == FRAME_PKT_FULL) {
+      memcpy(frame, payload, FRAME_BYTES);
+    } else {
+      for (size_t i = 0; i + 1 < payloadLen; i += 2) {
+        if (payload[i] < FRAME_BYTES) frame[payload[i]] = payload[i + 1];
+      }
+    }
+    dirty = true;
+    return true;
+  }
+
+  // Drop back to the clock once the sender goes quiet. Returns true on the
+  // transition so the caller can redraw the clock.
+  bool expire(uint32_t nowMs) {
+    if (active && nowMs - lastPacketMs >= holdMs) {
+      active = false;
+      return true;
+    }
+    return false;
+  }
+
+  bool isActive() const { return active; }
+
+  // Copy the pending frame into dst if it changed since the last call
+  bool takeFrame(uint8_t* dst) {
+    if (!dirty) return false;
+    memcpy(dst, frame, FRAME_BYTES);
+    dirty = false;
+    return true;
+  }
+
+  FrameInputStats stats;
+
+private:
+  uint8_t frame[FRAME_BYTES];
+  bool active;
+  bool dirty;
+  uint16_t lastSeq;
+  uint32_t lastPacketMs;
+  uint32_t holdMs;
+};
+
+#endif // FRAME_INPUT_H
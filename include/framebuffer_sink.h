@@ -0,0 +1,122 @@
+/*
+ * framebuffer_sink.h - Headless In-Memory RGB565 Framebuffer Sink
+ *
+ * Renders the simulated LED matrix into RAM using exactly the same cell
+ * rasterizer as the TFT (led_renderer.h), so its contents match what the
+ * panel shows pixel for pixel. Used for off-target rendering, golden-image
+ * comparison and render benchmarking; can be exported as binary PPM (P6).
+ *
+ * Memory: (LED_SIZE * 32) x (LED_SIZE * 16 + LED_ROW_GAP) x 2 bytes
+ * (~105KB at LED_SIZE 10) - too large for the ESP8266 heap at full size,
+ * so it is only registered when HEADLESS_FRAMEBUFFER is defined.
+ */
+
+#ifndef FRAMEBUFFER_SINK_H
+#define FRAMEBUFFER_SINK_H
+
+#include <Arduino.h>
+#include "display_sink.h"
+
+#define FB_WIDTH   (LED_SIZE * LINE_WIDTH)
+#define FB_HEIGHT  (LED_SIZE * DISPLAY_ROWS * 8 + LED_ROW_GAP)
+
+class FramebufferSink : public DisplaySink {
+public:
+  FramebufferSink() : pixels(nullptr), presents(0), cellsDrawn(0) {}
+  ~FramebufferSink() { free(pixels); }
+
+  const char* name() const override { return "framebuffer"; }
+
+  void begin() override {
+    if (pixels == nullptr) {
+      pixels = (uint16_t*)malloc(FB_WIDTH * FB_HEIGHT * sizeof(uint16_t));
+    }
+    if (pixels != nullptr) {
+      memset(pixels, 0, FB_WIDTH * FB_HEIGHT * sizeof(uint16_t));
+    }
+  }
+
+  void present(const uint8_t* frame, uint64_t dirty, const LedStyle& style) override {
+    if (pixels == nullptr) return;
+    presents++;
+    for (int i = 0; i < FRAME_BYTES; i++) {
+      if (dirty & (1ULL << i)) {
+        renderLEDColumn(*this, 0, 0, i % LINE_WIDTH, i / LINE_WIDTH, frame[i], style);
+        cellsDrawn += 8;
+      }
+    }
+  }
+
+  // ---- Canvas interface used by renderLEDCell() ----
+  void fillRect(int32_t x, int32_t y, int32_t w, int32_t h, uint32_t color) {
+    for (int32_t py = y; py < y + h; py++) {
+      for (int32_t px = x; px < x + w; px++) {
+        drawPixel(px, py, color);
+      }
+    }
+  }
+
+  void drawPixel(int32_t x, int32_t y, uint32_t color) {
+    if (x < 0 || x >= FB_WIDTH || y < 0 || y >= FB_HEIGHT) return;
+    pixels[y * FB_WIDTH + x] = (uint16_t)color;
+  }
+
+  uint16_t pixel(int x, int y) const { return pixels[y * FB_WIDTH + x]; }
+  const uint16_t* data() const { return pixels; }
+  int width() const { return FB_WIDTH; }
+  int height() const { return FB_HEIGHT; }
+  uint32_t presentCount() const { return presents; }
+  uint32_t cellCount() const { return cellsDrawn; }
+
+  // FNV-1a hash of the whole image - cheap equality check against a golden
+  uint32_t hash() const {
+    uint32_t h = 2166136261UL;
+    for (int i = 0; i < FB_WIDTH * FB_HEIGHT; i++) {
+      h = (h ^ (pixels[i] & 0xFF)) * 16777619UL;
+      h = (h ^ (pixels[i] >> 8)) * 16777619UL;
+    }
+    return h;
+  }
+
+  // Binary PPM (P6, RGB888). Out needs write(const uint8_t*, size_t) - any Print works.
+  template <class Out>
+  void writePPM(Out& out) const {
+    char header[32];
+    int len = snprintf(header, sizeof(header), "P6\n%d %d\n255\n", FB_WIDTH, FB_HEIGHT);
+    out.write((const uint8_t*)header, len);
+
+    uint8_t row[FB_WIDTH * 3];
+    for (int y = 0; y < FB_HEIGHT; y++) {
+      for (int x = 0; x < FB_WIDTH; x++) {
+        uint16_t c = pixels[y * FB_WIDTH + x];
+        uint8_t r = (c >> 11) & 0x1F, g = (c >> 5) & 0x3F, b = c & 0x1F;
+        row[x * 3]     = (r << 3) | (r >> 2);
+        row[x * 3 + 1] = (g << 2) | (g >> 4);
+        row[x * 3 + 2] = (b << 3) | (b >> 2);
+      }
+      out.write(row, sizeof(row));
+    }
+  }
+
+#ifndef ARDUINO
+  // Host builds: write straight to a file
+  bool writePPM(const char* path) const {
+    FILE* f = fopen(path, "wb");
+    if (f == nullptr) return false;
+    struct FileOut {
+      FILE* f;
+      size_t write(const uint8_t* data, size_t len) { return fwrite(data, 1, len, f); }
+    } out = {f};
+    writePPM(out);
+    fclose(f);
+    return true;
+  }
+#endif
+
+private:
+  uint16_t* pixels;
+  uint32_t presents;
+  uint32_t cellsDrawn;
+};
+
+#endif // FRAMEBUFFER_SINK_H
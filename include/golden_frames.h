@@ -0,0 +1,168 @@
+/*
+ * golden_frames.h - Golden Display Frames for the Display Self-Test
+ *
+ * Each case fixes the inputs of one display mode (time, date, sensor
+ * values, 12/24h and unit flags) and stores the exact 64-byte scr frame
+ * that mode must compose, plus the hash of the full-redraw image in each
+ * style at the default colors. The device self-test (/api/selftest)
+ * checks frames; the host suite (test/test_golden, pio test -e native)
+ * renders through the framebuffer sink and checks both. Every mode in
+ * displayModes[] needs at least one case or both fail.
+ *
+ * Regenerate after confirming a new rendering is intended: the host suite
+ * prints the frame and hashes it got for each case that doesn't match.
+ */
+
+#ifndef GOLDEN_FRAMES_H
+#define GOLDEN_FRAMES_H
+
+#include <Arduino.h>
+
+#define GOLDEN_24H         0x01
+#define GOLDEN_FAHRENHEIT  0x02
+#define GOLDEN_NO_SENSOR   0x04
+#define GOLDEN_TENTHS      0x08  // Timer precision 1 (default hundredths)
+
+#define GOLDEN_COUNTDOWN_MS  300000UL  // Countdown cases run from 5:00
+#define GOLDEN_PRESSURE      1013      // hPa, every case
+
+struct GoldenCase {
+  char     mode[12];     // displayModes[] name - indices shift with the *_ENABLED flags
+  uint8_t  hour24, minute, second;
+  uint8_t  day, month;
+  uint16_t year;
+  int8_t   temperature;  // Celsius
+  uint8_t  humidity;
+  uint8_t  flags;
+  uint8_t  frame[64];    // scr[x + row * 32]
+  uint32_t image[2];     // FramebufferSink::hash() of a full redraw, per display style
+  uint32_t state;        // Stopwatch/Countdown: ms elapsed on a running timer;
+                         // Marquee: scroll position (columns)
+};
+
+const GoldenCase goldenCases[] PROGMEM = {
+  // Time+Temp, 09:05:07 18/12/2025, 23C 45%
+  {"Time+Temp", 9, 5, 7, 18, 12, 2025, 23, 45, 0, {
+    0x0E, 0x91, 0x91, 0xFF, 0x7E, 0x00, 0x00, 0x7E, 0x81, 0x81, 0xFF, 0x7E, 0x00, 0x8F, 0x89, 0x89, 0xF9, 0x71, 0x00, 0xF8, 0x88, 0xF8, 0x00, 0x08, 0x08, 0xF8, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x04, 0x7C, 0x04, 0x00, 0x79, 0x49, 0x4F, 0x00, 0x41, 0x49, 0x7F, 0x00, 0x38, 0x44, 0x44, 0x00, 0x00, 0x00, 0x00, 0x7C, 0x10, 0x7C, 0x00, 0x1F, 0x10, 0x7C, 0x00, 0x4F, 0x49, 0x79, 0x00, 0x00},
+    {0xBDC80A25, 0x6186A72D}, 0},
+  // Time+Temp, 12:00:00 01/01/2026, F, -5C 88%
+  {"Time+Temp", 12, 0, 0, 1, 1, 2026, -5, 88, GOLDEN_FAHRENHEIT, {
+    0x04, 0x02, 0xFF, 0xFF, 0x00, 0xF1, 0x89, 0x89, 0x8F, 0x86, 0x24, 0x00, 0x7E, 0x81, 0x81, 0xFF, 0x7E, 0x00, 0x7E, 0x81, 0x81, 0xFF, 0x7E, 0x00, 0xF8, 0x88, 0xF8, 0x00, 0xF8, 0x88, 0xF8, 0x00,
+    0x04, 0x7C, 0x04, 0x00, 0x79, 0x49, 0x4F, 0x00, 0x41, 0x49, 0x7F, 0x00, 0x7C, 0x14, 0x04, 0x00, 0x00, 0x00, 0x00, 0x7C, 0x10, 0x7C, 0x00, 0x7F, 0x49, 0x7F, 0x00, 0x7F, 0x49, 0x7F, 0x00, 0x00},
+    {0x049F6B45, 0x746A6FE5}, 0},
+  // Time+Temp, 23:59:58 31/12/2025, 24h, 31C 30%
+  {"Time+Temp", 23, 59, 58, 31, 12, 2025, 31, 30, GOLDEN_24H, {
+    0xF1, 0x89, 0x89, 0x8F, 0x86, 0x00, 0x81, 0x89, 0x89, 0xFF, 0x76, 0x24, 0x00, 0x8F, 0x89, 0x89, 0xF9, 0x71, 0x00, 0x0E, 0x91, 0x91, 0xFF, 0x7E, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x04, 0x7C, 0x04, 0x00, 0x41, 0x49, 0x7F, 0x00, 0x04, 0x02, 0x7F, 0x00, 0x38, 0x44, 0x44, 0x00, 0x00, 0x00, 0x00, 0x7C, 0x10, 0x7C, 0x00, 0x41, 0x49, 0x7F, 0x00, 0x7F, 0x41, 0x7F, 0x00, 0x00},
+    {0xB78649C5, 0x022C9BC5}, 0},
+  // Time+Temp, 07:30:45 05/06/2026, no sensor
+  {"Time+Temp", 7, 30, 45, 5, 6, 2026, 20, 50, GOLDEN_NO_SENSOR, {
+    0x01, 0xC1, 0xF1, 0x3F, 0x0F, 0x00, 0x00, 0x81, 0x89, 0x89, 0xFF, 0x76, 0x00, 0x7E, 0x81, 0x81, 0xFF, 0x7E, 0x00, 0x38, 0x20, 0xF8, 0x00, 0xB8, 0xA8, 0xE8, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x7C, 0x04, 0x78, 0x00, 0x38, 0x44, 0x38, 0x00, 0x00, 0x00, 0x00, 0x48, 0x54, 0x24, 0x00, 0x7C, 0x54, 0x44, 0x00, 0x7C, 0x04, 0x78, 0x00, 0x48, 0x54, 0x24, 0x00, 0x38, 0x44, 0x38, 0x00, 0x00},
+    {0x375121C5, 0x19E58BA5}, 0},
+  // Time Large, 09:05:07 18/12/2025, 23C 45%
+  {"Time Large", 9, 5, 7, 18, 12, 2025, 23, 45, 0, {
+    0x00, 0x00, 0x00, 0x7E, 0x81, 0x81, 0xFF, 0xFE, 0x00, 0xFE, 0x01, 0x01, 0xFF, 0xFE, 0x00, 0xFF, 0x81, 0x81, 0x81, 0x01, 0x00, 0x7F, 0x41, 0x7F, 0x00, 0x01, 0x71, 0x0F, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x40, 0x80, 0x80, 0xFF, 0x7F, 0x00, 0x7F, 0x80, 0x80, 0xFF, 0x7F, 0x00, 0x40, 0x80, 0x80, 0xFF, 0x7F, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00},
+    {0xA61EF7A5, 0xAF63AC8D}, 0},
+  // Time Large, 12:00:01 01/01/2026, 23C 45%
+  {"Time Large", 12, 0, 1, 1, 1, 2026, 23, 45, 0, {
+    0x04, 0x02, 0xFF, 0xFF, 0x00, 0x02, 0x81, 0x81, 0xFF, 0x7E, 0x00, 0xFE, 0x01, 0x01, 0xFF, 0xFE, 0x00, 0xFE, 0x01, 0x01, 0xFF, 0xFE, 0x00, 0x7F, 0x41, 0x7F, 0x00, 0x04, 0x02, 0x7F, 0x00, 0x00,
+    0x00, 0x00, 0xFF, 0xFF, 0x00, 0xFF, 0x80, 0x80, 0x80, 0x80, 0x00, 0x7F, 0x80, 0x80, 0xFF, 0x7F, 0x00, 0x7F, 0x80, 0x80, 0xFF, 0x7F, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00},
+    {0x1E5DBB85, 0xAEE5DD35}, 0},
+  // Time Large, 23:59:58 31/12/2025, 24h, 23C 45%
+  {"Time Large", 23, 59, 58, 31, 12, 2025, 23, 45, GOLDEN_24H, {
+    0x02, 0x81, 0x81, 0xFF, 0x7E, 0x00, 0x02, 0x81, 0x81, 0xFF, 0x7E, 0x20, 0xFF, 0x81, 0x81, 0x81, 0x01, 0x00, 0x7E, 0x81, 0x81, 0xFF, 0xFE, 0x00, 0x4F, 0x49, 0x79, 0x00, 0x7F, 0x49, 0x7F, 0x00,
+    0xFF, 0x80, 0x80, 0x80, 0x80, 0x00, 0x40, 0x80, 0x80, 0xFF, 0x7F, 0x02, 0x40, 0x80, 0x80, 0xFF, 0x7F, 0x00, 0x40, 0x80, 0x80, 0xFF, 0x7F, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00},
+    {0xF7F8DBC5, 0x592CC185}, 0},
+  // Time Large, 00:00:00 01/01/2026, 24h, 23C 45%
+  {"Time Large", 0, 0, 0, 1, 1, 2026, 23, 45, GOLDEN_24H, {
+    0x00, 0x00, 0x00, 0xFE, 0x01, 0x01, 0xFF, 0xFE, 0x20, 0xFE, 0x01, 0x01, 0xFF, 0xFE, 0x00, 0xFE, 0x01, 0x01, 0xFF, 0xFE, 0x00, 0x7F, 0x41, 0x7F, 0x00, 0x7F, 0x41, 0x7F, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x7F, 0x80, 0x80, 0xFF, 0x7F, 0x02, 0x7F, 0x80, 0x80, 0xFF, 0x7F, 0x00, 0x7F, 0x80, 0x80, 0xFF, 0x7F, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00},
+    {0x30AF3C85, 0x01E63BF5}, 0},
+  // Time+Date, 09:05:07 18/12/2025, 23C 45%
+  {"Time+Date", 9, 5, 7, 18, 12, 2025, 23, 45, 0, {
+    0x0E, 0x91, 0x91, 0xFF, 0x7E, 0x00, 0x00, 0x7E, 0x81, 0x81, 0xFF, 0x7E, 0x00, 0x8F, 0x89, 0x89, 0xF9, 0x71, 0x00, 0xF8, 0x88, 0xF8, 0x00, 0x08, 0x08, 0xF8, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x04, 0x02, 0x7F, 0x00, 0x7F, 0x49, 0x7F, 0x00, 0x00, 0x00, 0x04, 0x02, 0x7F, 0x00, 0x79, 0x49, 0x4F, 0x00, 0x00, 0x00, 0x79, 0x49, 0x4F, 0x00, 0x4F, 0x49, 0x79, 0x00, 0x00, 0x00},
+    {0xB7B82A25, 0x279719CD}, 0},
+  // Time+Date, 12:00:01 01/01/2026, 23C 45%
+  {"Time+Date", 12, 0, 1, 1, 1, 2026, 23, 45, 0, {
+    0x04, 0x02, 0xFF, 0xFF, 0x00, 0xF1, 0x89, 0x89, 0x8F, 0x86, 0x00, 0x00, 0x7E, 0x81, 0x81, 0xFF, 0x7E, 0x00, 0x7E, 0x81, 0x81, 0xFF, 0x7E, 0x00, 0xF8, 0x88, 0xF8, 0x00, 0x00, 0x10, 0xF8, 0x00,
+    0x00, 0x00, 0x7F, 0x41, 0x7F, 0x00, 0x04, 0x02, 0x7F, 0x00, 0x00, 0x00, 0x7F, 0x41, 0x7F, 0x00, 0x04, 0x02, 0x7F, 0x00, 0x00, 0x00, 0x79, 0x49, 0x4F, 0x00, 0x7F, 0x49, 0x79, 0x00, 0x00, 0x00},
+    {0xCF6F9BA5, 0x9BF5D0AD}, 0},
+  // Time+Date, 23:59:58 31/12/2025, 24h, 23C 45%
+  {"Time+Date", 23, 59, 58, 31, 12, 2025, 23, 45, GOLDEN_24H, {
+    0xF1, 0x89, 0x89, 0x8F, 0x86, 0x00, 0x81, 0x89, 0x89, 0xFF, 0x76, 0x24, 0x00, 0x8F, 0x89, 0x89, 0xF9, 0x71, 0x00, 0x0E, 0x91, 0x91, 0xFF, 0x7E, 0x00, 0xB8, 0xA8, 0xE8, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x41, 0x49, 0x7F, 0x00, 0x04, 0x02, 0x7F, 0x00, 0x00, 0x00, 0x04, 0x02, 0x7F, 0x00, 0x79, 0x49, 0x4F, 0x00, 0x00, 0x00, 0x79, 0x49, 0x4F, 0x00, 0x4F, 0x49, 0x79, 0x00, 0x00, 0x00},
+    {0x443D6005, 0xC0EA36F5}, 0},
+  // Time+Date, 00:09:10 29/02/2028, 24h, 23C 45%
+  {"Time+Date", 0, 9, 10, 29, 2, 2028, 23, 45, GOLDEN_24H, {
+    0x7E, 0x81, 0x81, 0xFF, 0x7E, 0x24, 0x00, 0x7E, 0x81, 0x81, 0xFF, 0x7E, 0x00, 0x0E, 0x91, 0x91, 0xFF, 0x7E, 0x00, 0x00, 0x10, 0xF8, 0x00, 0xF8, 0x88, 0xF8, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x79, 0x49, 0x4F, 0x00, 0x4F, 0x49, 0x7F, 0x00, 0x00, 0x00, 0x7F, 0x41, 0x7F, 0x00, 0x79, 0x49, 0x4F, 0x00, 0x00, 0x00, 0x79, 0x49, 0x4F, 0x00, 0x7F, 0x49, 0x7F, 0x00, 0x00, 0x00},
+    {0x34064A85, 0xF22CD4B5}, 0},
+  // Life, first generation from Time+Temp 09:05:07 18/12/2025, 23C 45%
+  {"Life", 9, 5, 7, 18, 12, 2025, 23, 45, 0, {
+    0x0E, 0x15, 0x85, 0x01, 0x01, 0x3C, 0xBC, 0x7E, 0x3D, 0x3D, 0x01, 0x01, 0x61, 0x0F, 0xD9, 0xAF, 0x8B, 0x88, 0x88, 0xF8, 0x04, 0xF8, 0xE8, 0x00, 0xEC, 0x78, 0xF0, 0x00, 0x80, 0x00, 0x00, 0x04,
+    0x34, 0xB6, 0x35, 0xB9, 0xF9, 0xC1, 0x0F, 0x84, 0x01, 0x48, 0x7E, 0x43, 0x38, 0x54, 0x01, 0x01, 0x80, 0x00, 0x38, 0x38, 0x01, 0x38, 0x01, 0x1E, 0x01, 0x38, 0x41, 0x0F, 0xC1, 0x78, 0x30, 0x00},
+    {0xE7AAB1A5, 0xFF2B722D}, 0},
+  // Life, first generation from Time+Temp 07:30:45 05/06/2026, no sensor
+  {"Life", 7, 30, 45, 5, 6, 2026, 20, 50, GOLDEN_NO_SENSOR, {
+    0x00, 0x83, 0x85, 0x00, 0x01, 0x06, 0x00, 0x00, 0xC3, 0xA1, 0x81, 0x81, 0x00, 0x7E, 0xBD, 0xBD, 0x81, 0x81, 0x40, 0x30, 0x00, 0x70, 0x80, 0x28, 0x8C, 0xA0, 0x40, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0xBC, 0x04, 0x38, 0x40, 0xB8, 0x44, 0x38, 0x10, 0x81, 0x81, 0x80, 0xA8, 0x54, 0x28, 0xC4, 0x55, 0x56, 0xA8, 0x54, 0x3C, 0x04, 0x38, 0x48, 0x28, 0x55, 0x28, 0x28, 0x38, 0x44, 0x38, 0x10, 0x38},
+    {0xE12DC3E5, 0xB8999CFD}, 0},
+  // Analog, 09:05:07 18/12/2025
+  {"Analog", 9, 5, 7, 18, 12, 2025, 23, 45, 0, {
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x80, 0x08, 0x00, 0x80, 0x82, 0x80, 0x80, 0x81, 0x60, 0x18, 0x06, 0x00, 0x04, 0x08, 0x80, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x08, 0x00, 0x00, 0x20, 0x00, 0x00, 0x40, 0x00, 0x00, 0x20, 0x00, 0x00, 0x04, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00},
+    {0x3F124E65, 0x760EB23D}, 0},
+  // Analog, 12:00:00 01/01/2026 - all hands up
+  {"Analog", 12, 0, 0, 1, 1, 2026, 23, 45, 0, {
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x80, 0x08, 0x00, 0x00, 0x02, 0x00, 0x00, 0xFE, 0x00, 0x00, 0x02, 0x00, 0x00, 0x08, 0x80, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x08, 0x00, 0x00, 0x20, 0x00, 0x00, 0x40, 0x00, 0x00, 0x20, 0x00, 0x00, 0x04, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00},
+    {0x5EFC0685, 0xBC92A675}, 0},
+  // Analog, 15:30:45 05/06/2026, 24h
+  {"Analog", 15, 30, 45, 5, 6, 2026, 23, 45, GOLDEN_24H, {
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x08, 0x00, 0x00, 0x02, 0x00, 0x00, 0x81, 0x80, 0x00, 0x02, 0x00, 0x00, 0x08, 0x80, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x08, 0x00, 0x00, 0x20, 0x00, 0x00, 0x7F, 0x00, 0x01, 0x21, 0x01, 0x00, 0x04, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00},
+    {0xC87D0405, 0x6C0F2755}, 0},
+  // Stopwatch running, 12:34.12
+  {"Stopwatch", 9, 5, 7, 18, 12, 2025, 23, 45, 0, {
+    0x04, 0x02, 0xFF, 0xFF, 0x00, 0x02, 0x81, 0x81, 0xFF, 0x7E, 0x20, 0x02, 0x81, 0x81, 0xFF, 0x7E, 0x00, 0xFF, 0x00, 0x00, 0xFE, 0xFE, 0x00, 0x04, 0x02, 0x7F, 0x00, 0x79, 0x49, 0x4F, 0x00, 0x00,
+    0x00, 0x00, 0xFF, 0xFF, 0x00, 0xFF, 0x80, 0x80, 0x80, 0x80, 0x02, 0x40, 0x80, 0x80, 0xFF, 0x7F, 0x00, 0x01, 0x01, 0x01, 0xFF, 0xFF, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00},
+    {0x2DC11265, 0x3DB48DFD}, 754125},
+  // Stopwatch running, tenths, 0:07.3
+  {"Stopwatch", 9, 5, 7, 18, 12, 2025, 23, 45, GOLDEN_TENTHS, {
+    0x00, 0x00, 0x00, 0xFE, 0x01, 0x01, 0xFF, 0xFE, 0x20, 0xFE, 0x01, 0x01, 0xFF, 0xFE, 0x00, 0x01, 0x01, 0xC1, 0xFF, 0x3F, 0x00, 0x41, 0x49, 0x7F, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x7F, 0x80, 0x80, 0xFF, 0x7F, 0x02, 0x7F, 0x80, 0x80, 0xFF, 0x7F, 0x00, 0x00, 0xFC, 0xFF, 0x03, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00},
+    {0x03198A25, 0xA0FC1D8D}, 7345},
+  // Stopwatch running past an hour, 1:02 03
+  {"Stopwatch", 9, 5, 7, 18, 12, 2025, 23, 45, 0, {
+    0x00, 0x00, 0x00, 0x04, 0x02, 0xFF, 0xFF, 0x20, 0xFE, 0x01, 0x01, 0xFF, 0xFE, 0x00, 0x02, 0x81, 0x81, 0xFF, 0x7E, 0x00, 0x7F, 0x41, 0x7F, 0x00, 0x41, 0x49, 0x7F, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0xFF, 0xFF, 0x02, 0x7F, 0x80, 0x80, 0xFF, 0x7F, 0x00, 0xFF, 0x80, 0x80, 0x80, 0x80, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00},
+    {0x87B03765, 0xABCCBC1D}, 3723455},
+  // Countdown from 5:00 running, 3:05.38 left
+  {"Countdown", 9, 5, 7, 18, 12, 2025, 23, 45, 0, {
+    0x00, 0x00, 0x00, 0x02, 0x81, 0x81, 0xFF, 0x7E, 0x20, 0xFE, 0x01, 0x01, 0xFF, 0xFE, 0x00, 0xFF, 0x81, 0x81, 0x81, 0x01, 0x00, 0x41, 0x49, 0x7F, 0x00, 0x7F, 0x49, 0x7F, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x40, 0x80, 0x80, 0xFF, 0x7F, 0x02, 0x7F, 0x80, 0x80, 0xFF, 0x7F, 0x00, 0x40, 0x80, 0x80, 0xFF, 0x7F, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00},
+    {0x3ADD65A5, 0xF313284D}, 114615},
+  // Marquee, 09:05 18/12/2025 clock text from the left edge
+  {"Marquee", 9, 5, 7, 18, 12, 2025, 23, 45, 0, {
+    0x7F, 0x41, 0x7F, 0x00, 0x4F, 0x49, 0x7F, 0x00, 0x00, 0x00, 0x7F, 0x41, 0x7F, 0x00, 0x4F, 0x49, 0x79, 0x00, 0x78, 0x24, 0x78, 0x00, 0x78, 0x04, 0x38, 0x04, 0x78, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x79, 0x49, 0x4F, 0x00, 0x41, 0x49, 0x7F, 0x00, 0x38, 0x44, 0x44, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x1F, 0x10, 0x7C, 0x00, 0x4F, 0x49, 0x79, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00},
+    {0x8456C5E5, 0xBFA06BDD}, 0},
+  // Marquee, 23:59 31/12/2025, 24h, F, 40 columns in
+  {"Marquee", 23, 59, 58, 31, 12, 2025, -5, 88, GOLDEN_24H | GOLDEN_FAHRENHEIT, {
+    0x00, 0x41, 0x49, 0x7F, 0x00, 0x04, 0x02, 0x7F, 0x00, 0x00, 0x00, 0x00, 0x7C, 0x44, 0x38, 0x00, 0x7C, 0x54, 0x44, 0x00, 0x38, 0x44, 0x44, 0x00, 0x00, 0x00, 0x00, 0x79, 0x49, 0x4F, 0x00, 0x7F,
+    0x7F, 0x00, 0x04, 0x02, 0x7F, 0x00, 0x41, 0x49, 0x7F, 0x00, 0x7C, 0x10, 0x7C, 0x00, 0x7C, 0x24, 0x18, 0x00, 0x78, 0x24, 0x78, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00},
+    {0x6B541B05, 0xBE58AB55}, 40},
+  // Marquee, 12:00 29/02/2028, wrapping: blank gap then the text head again
+  {"Marquee", 12, 0, 0, 29, 2, 2028, 23, 45, 0, {
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x04, 0x02, 0x7F, 0x00, 0x79, 0x49, 0x4F, 0x00, 0x00, 0x00, 0x7F, 0x41, 0x7F, 0x00, 0x7F, 0x41, 0x7F, 0x00, 0x7C,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x79, 0x49, 0x4F, 0x00, 0x41, 0x49, 0x7F, 0x00, 0x38, 0x44, 0x44, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x1F},
+    {0xDFDD35C5, 0x8A31F105}, 110}
+};
+
+const int numGoldenCases = sizeof(goldenCases) / sizeof(goldenCases[0]);
+
+#endif // GOLDEN_FRAMES_H
@@ -0,0 +1,114 @@
+/*
+ * hw_scroll.h - Horizontal Pan of the Matrix via the Panel's Scroll Registers
+ *
+ * ILI9341-class controllers can scroll the picture along their 320-line
+ * axis in hardware: VSCRDEF (0x33) splits the lines into a fixed top area,
+ * a scroll area and a fixed bottom area, and VSCRSADD (0x37) selects which
+ * memory line is shown first in the scroll area. In landscape (row/column
+ * exchange) those lines run left to right, so the "vertical" scroll is a
+ * horizontal pan of every pixel row on the screen.
+ *
+ * The matrix is LINE_WIDTH LED columns wide, so the scroll area is used as
+ * a ring of column slots: pan(1) moves the picture one column left for 3
+ * bytes of SPI, the column that scrolled off re-appears at the right edge,
+ * and only that slot has to be redrawn with the new content. Frame column x
+ * lives in slot (x + offsetColumns()) % columns.
+ *
+ * Rotation decides the direction: with the row order reversed (rotation 3)
+ * logical x runs against the memory lines, so the start line moves the
+ * other way (`reversed`).
+ *
+ * Templated on the panel - TFT_eSPI on the device, a mock off-target. A
+ * Panel must provide:
+ *   void writecommand(uint8_t cmd);
+ *   void writedata(uint8_t data);
+ */
+
+#ifndef HW_SCROLL_H
+#define HW_SCROLL_H
+
+#include <Arduino.h>
+
+#define SCROLL_CMD_VSCRDEF   0x33  // Scroll area definition: TFA, VSA, BFA (16 bits each)
+#define SCROLL_CMD_VSCRSADD  0x37  // Scroll start address (16 bits)
+
+template <class Panel>
+class HwScroll {
+public:
+  explicit HwScroll(Panel& panel)
+    : panel(panel), top(0), width(0), step(0), columns(0), reversed(false), ready(false),
+      offset(0), pans(0), sent(0) {}
+
+  // panelLines = lines along the scroll axis (tft.width() in landscape);
+  // the scroll area is `cols` columns of `colWidth` px from logical x = x0
+  bool begin(int panelLines, int x0, int cols, int colWidth, bool reverse) {
+    ready = false;
+    width = cols * colWidth;
+    if (cols <= 0 || colWidth <= 0 || x0 < 0 || x0 + width > panelLines) return false;
+    columns = cols;
+    step = colWidth;
+    reversed = reverse;
+    top = reversed ? panelLines - x0 - width : x0;
+    int bottom = panelLines - top - width;
+    command(SCROLL_CMD_VSCRDEF);
+    data16(top);
+    data16(width);
+    data16(bottom);
+    ready = true;
+    offset = 0;
+    writeStart();
+    return true;
+  }
+
+  // Picture moves left by cols columns (negative = right)
+  void pan(int cols) {
+    if (!ready) return;
+    offset = ((offset + cols) % columns + columns) % columns;
+    pans++;
+    writeStart();
+  }
+
+  // Back to the unscrolled picture (frame column x in slot x)
+  void reset() {
+    if (!ready || offset == 0) return;
+    offset = 0;
+    writeStart();
+  }
+
+  bool isReady() const { return ready; }
+  int offsetColumns() const { return offset; }
+  uint32_t panCount() const { return pans; }
+  uint32_t bytes() const { return sent; }  // Command + parameter bytes sent
+
+private:
+  void writeStart() {
+    int px = offset * step;
+    uint16_t line = top + (reversed ? (width - px) % width : px);
+    command(SCROLL_CMD_VSCRSADD);
+    data16(line);
+  }
+
+  void command(uint8_t cmd) {
+    panel.writecommand(cmd);
+    sent++;
+  }
+
+  void data16(uint16_t v) {
+    panel.writedata(v >> 8);
+    panel.writedata(v & 0xFF);
+    sent += 2;
+  }
+
+  Panel& panel;
+  int top;        // First memory line of the scroll area (TFA)
+  int width;      // Scroll area, px (VSA)
+  int step;       // px per column
+  int columns;
+  bool reversed;
+  bool ready;
+  int offset;     // Columns panned, 0..columns-1
+  uint32_t pans;
+  uint32_t sent;
+};
+
+#endif // HW_SCROLL_H
@@ -0,0 +1,136 @@
+/*
+ * info_panel.h - Secondary Info Strip for the Unused TFT Area
+ *
+ * A handful of text fields (IP, sensor trends, sync status, ...) drawn with
+ * native TFT_eSPI fonts in the bands above and below the LED matrix.
+ *
+ * Each field owns a fixed rectangle and remembers the text it last drew.
+ * update() re-formats every field (cheap, no drawing) and redraws only the
+ * ones whose text changed, using text padding so the old text is
+ * overwritten in one pass without a separate fillRect. Drawing stops once
+ * the time budget is used up; the remaining fields stay dirty and are
+ * drawn next time, starting where the last pass stopped, so the strip can
+ * never hold up the matrix tick.
+ *
+ * Templated on the TFT type (TFT_eSPI on the device).
+ */
+
+#ifndef INFO_PANEL_H
+#define INFO_PANEL_H
+
+#include <Arduino.h>
+
+#define INFO_MAX_FIELDS  8
+#define INFO_TEXT_MAX    28
+
+typedef void (*InfoFormatter)(char* buf, size_t size);
+
+struct InfoField {
+  const char*   name;
+  InfoFormatter format;
+  int16_t       x, y, w;  // Text anchor (per datum) and padded width
+  uint8_t       font;
+  uint8_t       datum;    // TL_DATUM, TR_DATUM, ...
+  char          shown[INFO_TEXT_MAX];
+  bool          dirty;
+  uint32_t      draws;
+};
+
+template <class Tft>
+class InfoPanel {
+public:
+  InfoPanel(Tft& tft, uint16_t color, uint16_t bgColor)
+    : tft(tft), color(color), bg(bgColor), fieldCount(0), nextField(0),
+      passes(0), deferred(0), lastUs(0), maxUs(0) {}
+
+  int addField(const char* name, InfoFormatter format, int16_t x, int16_t y, int16_t w,
+               uint8_t font, uint8_t datum) {
+    if (fieldCount >= INFO_MAX_FIELDS) return -1;
+    InfoField& f = fields[fieldCount];
+    f.name = name;
+    f.format = format;
+    f.x = x;
+    f.y = y;
+    f.w = w;
+    f.font = font;
+    f.datum = datum;
+    f.shown[0] = 0;
+    f.dirty = true;
+    f.draws = 0;
+    return fieldCount++;
+  }
+
+  // Screen was cleared underneath us - redraw everything
+  void invalidate() {
+    for (int i = 0; i < fieldCount; i++) fields[i].dirty = true;
+  }
+
+  void setColor(uint16_t c) {
+    if (c == color) return;
+    color = c;
+    invalidate();
+  }
+
+  // Refresh changed fields within budgetUs. Returns fields drawn.
+  int update(uint32_t budgetUs) {
+    char text[INFO_TEXT_MAX];
+    for (int i = 0; i < fieldCount; i++) {
+      InfoField& f = fields[i];
+      f.format(text, sizeof(text));
+      if (strcmp(text, f.shown) != 0) {
+        strcpy(f.shown, text);
+        f.dirty = true;
+      }
+    }
+
+    uint32_t start = micros();
+    int drawn = 0;
+    for (int n = 0; n < fieldCount; n++) {
+      int i = (nextField + n) % fieldCount;
+      InfoField& f = fields[i];
+      if (!f.dirty) continue;
+      if (drawn > 0 && micros() - start >= budgetUs) {
+        nextField = i;  // Resume here next pass
+        deferred++;
+        break;
+      }
+      draw(f);
+      drawn++;
+    }
+    passes++;
+    lastUs = micros() - start;
+    if (lastUs > maxUs) maxUs = lastUs;
+    return drawn;
+  }
+
+  int count() const { return fieldCount; }
+  const InfoField& field(int i) const { return fields[i]; }
+  uint32_t passCount() const { return passes; }
+  uint32_t deferredCount() const { return deferred; }  // Passes that ran out of budget
+  uint32_t lastPassUs() const { return lastUs; }
+  uint32_t maxPassUs() const { return maxUs; }
+
+private:
+  void draw(InfoField& f) {
+    tft.setTextColor(color, bg);
+    tft.setTextDatum(f.datum);
+    tft.setTextPadding(f.w);
+    tft.drawString(f.shown, f.x, f.y, f.font);
+    tft.setTextPadding(0);
+    f.dirty = false;
+    f.draws++;
+  }
+
+  Tft& tft;
+  uint16_t color;
+  uint16_t bg;
+  InfoField fields[INFO_MAX_FIELDS];
+  int fieldCount;
+  int nextField;
+  uint32_t passes;
+  uint32_t deferred;
+  uint32_t lastUs;
+  uint32_t maxUs;
+};
+
+#endif // INFO_PANEL_H
@@ -0,0 +1,150 @@
+/*
+ * latency_stats.h - Loop Latency Histograms and Stall Detector
+ *
+ * Log-scale (power of two) histograms of loop iteration time and of each
+ * major call. Bucket i counts durations in [2^i, 2^(i+1)) microseconds;
+ * bucket 0 also holds 0-1us and the last bucket holds everything longer.
+ *
+ * Stall detector: when one loop iteration exceeds the threshold, the
+ * innermost instrumented call that was itself over the threshold (or the
+ * slowest call if none was) is recorded with its duration, plus the
+ * optional context tag (e.g. the HTTP path being served).
+ *
+ * Usage:
+ *   int site = latency.addSite("refreshAll");
+ *   { LatencyProbe probe(latency, site); refreshAll(); }
+ */
+
+#ifndef LATENCY_STATS_H
+#define LATENCY_STATS_H
+
+#include <Arduino.h>
+
+#define LAT_BUCKETS      21  // Up to 2^20us (~1s), last bucket is open-ended
+#define LAT_MAX_SITES    8
+#define LAT_STALL_SLOTS  16
+
+struct LatencyHistogram {
+  const char* name;
+  uint32_t buckets[LAT_BUCKETS];
+  uint32_t count;
+  uint32_t maxUs;
+  uint64_t totalUs;
+};
+
+struct StallRecord {
+  uint32_t    atMs;          // millis() when the iteration ended
+  uint32_t    iterationUs;   // Whole loop iteration
+  uint32_t    siteUs;        // Time spent in the blamed call
+  const char* site;          // Blamed call (innermost slow site)
+  const char* context;       // Context tag active at the time (may be nullptr)
+};
+
+class LatencyMonitor {
+public:
+  explicit LatencyMonitor(uint32_t stallThresholdUs)
+    : threshold(stallThresholdUs), siteCount(0), stallCount(0), stallHead(0),
+      iterationStart(0), blamedSite(-1), blamedUs(0), blamedOverThreshold(false), context(nullptr) {
+    memset(sites, 0, sizeof(sites));
+    memset(stalls, 0, sizeof(stalls));
+    loopSite = addSite("loop");
+  }
+
+  static int bucketFor(uint32_t us) {
+    if (us < 2) return 0;
+    int b = 31 - __builtin_clz(us);
+    return b < LAT_BUCKETS ? b : LAT_BUCKETS - 1;
+  }
+
+  int addSite(const char* name) {
+    if (siteCount >= LAT_MAX_SITES) return -1;
+    sites[siteCount].name = name;
+    return siteCount++;
+  }
+
+  void record(int site, uint32_t us) {
+    if (site < 0 || site >= siteCount) return;
+    LatencyHistogram& h = sites[site];
+    h.buckets[bucketFor(us)]++;
+    h.count++;
+    h.totalUs += us;
+    if (us > h.maxUs) h.maxUs = us;
+
+    if (site == loopSite) return;
+    // Probes finish innermost-first: keep the first call that was itself over
+    // the threshold, otherwise track the slowest call of this iteration
+    if (blamedOverThreshold) return;
+    if (us >= threshold) {
+      blamedOverThreshold = true;
+      blamedSite = site;
+      blamedUs = us;
+    } else if (us > blamedUs) {
+      blamedSite = site;
+      blamedUs = us;
+    }
+  }
+
+  void beginIteration() {
+    iterationStart = micros();
+    blamedSite = -1;
+    blamedUs = 0;
+    blamedOverThreshold = false;
+    context = nullptr;
+  }
+
+  void endIteration() {
+    uint32_t us = micros() - iterationStart;
+    record(loopSite, us);
+    if (us < threshold) return;
+
+    StallRecord& s = stalls[stallHead];
+    s.atMs = millis();
+    s.iterationUs = us;
+    s.siteUs = blamedUs;
+    s.site = blamedSite >= 0 ? sites[blamedSite].name : "unknown";
+    s.context = context;
+    stallHead = (stallHead + 1) % LAT_STALL_SLOTS;
+    stallCount++;
+  }
+
+  // Tag recorded with a stall in the current iteration (cleared each iteration)
+  void setContext(const char* tag) { context = tag; }
+
+  int count() const { return siteCount; }
+  const LatencyHistogram& site(int i) const { return sites[i]; }
+  uint32_t stallThreshold() const { return threshold; }
+  uint32_t totalStalls() const { return stallCount; }
+
+  // i = 0 is the most recent stall; valid for i < min(totalStalls(), LAT_STALL_SLOTS)
+  const StallRecord& stall(int i) const {
+    return stalls[(stallHead + LAT_STALL_SLOTS - 1 - i) % LAT_STALL_SLOTS];
+  }
+
+private:
+  uint32_t threshold;
+  LatencyHistogram sites[LAT_MAX_SITES];
+  int siteCount;
+  int loopSite;
+  StallRecord stalls[LAT_STALL_SLOTS];
+  uint32_t stallCount;
+  int stallHead;
+  uint32_t iterationStart;
+  int blamedSite;
+  uint32_t blamedUs;
+  bool blamedOverThreshold;
+  const char* context;
+};
+
+// Times a scope and records it against a site
+class LatencyProbe {
+public:
+  LatencyProbe(LatencyMonitor& monitor, int site) : monitor(monitor), site(site), start(micros()) {}
+  ~LatencyProbe() { monitor.record(site, micros() - start); }
+
+private:
+  LatencyMonitor& monitor;
+  int site;
+  uint32_t start;
+};
+
+#endif // LATENCY_STATS_H
@@ -0,0 +1,175 @@
+/*
+ * led_renderer.h - Simulated LED Cell Rasterizer
+ *
+ * Draws one simulated MAX7219 LED (LED_SIZE x LED_SIZE pixels) in either
+ * display style. Templated on the drawing target so the exact same pixels
+ * go to the TFT (TFT_eSPI) and to the headless framebuffer sink.
+ *
+ * A Canvas must provide:
+ *   void fillRect(int32_t x, int32_t y, int32_t w, int32_t h, uint32_t color);
+ *   void drawPixel(int32_t x, int32_t y, uint32_t color);
+ *
+ * Geometry: 32x16 LEDs, LED_SIZE pixels each, with a 4-pixel gap between
+ * the two rows of matrices (authentic MAX7219 module spacing).
+ */
+
+#ifndef LED_RENDERER_H
+#define LED_RENDERER_H
+
+#include <Arduino.h>
+
+#ifndef LED_SIZE
+  #error "Define LED_SIZE before including led_renderer.h"
+#endif
+
+#define LED_ROW_GAP  4  // Gap between matrix rows (after LED row 7)
+
+// Colors + style needed to draw a cell (snapshot of the current settings)
+struct LedStyle {
+  uint8_t  style;          // 0 = Default (solid blocks), 1 = Realistic (circular LEDs)
+  uint16_t onColor;
+  uint16_t surroundColor;
+  uint16_t bgColor;
+};
+
+// Dim an RGB565 color while preserving hue
+inline uint16_t dimRGB565(uint16_t color, int factor) {
+  // Extract RGB components from RGB565
+  int r = (color >> 11) & 0x1F;  // 5 bits
+  int g = (color >> 5) & 0x3F;   // 6 bits
+  int b = color & 0x1F;          // 5 bits
+
+  // Dim each component by factor (1=50%, 2=33%, 3=25%, etc)
+  r = r / (factor + 1);
+  g = g / (factor + 1);
+  b = b / (factor + 1);
+
+  // Recombine into RGB565
+  return (r << 11) | (g << 5) | b;
+}
+
+// Pixel position of LED (x, y) relative to the matrix origin
+inline int ledCellX(int x) { return x * LED_SIZE; }
+inline int ledCellY(int y) { return y * LED_SIZE + ((y >= 8) ? LED_ROW_GAP : 0); }
+
+template <class Canvas>
+void renderLEDCell(Canvas& canvas, int screenX, int screenY, bool lit, const LedStyle& st) {
+  if (st.style == 0) {
+    // ========== DEFAULT STYLE: Solid square blocks ==========
+    uint16_t color = lit ? st.onColor : st.bgColor;  // Off LEDs are BLACK
+    canvas.fillRect(screenX, screenY, LED_SIZE, LED_SIZE, color);
+  }
+  else {
+    // ========== REALISTIC STYLE: Circular LED with surround ==========
+    // Enhanced for authenticity matching real MAX7219 hardware
+
+    if (!lit) {
+      // OFF LED: Show dark circle (visible but dim, like real hardware)
+      // Real LEDs are visible even when off - dark red/gray circle
+
+      // Fill background black
+      canvas.fillRect(screenX, screenY, LED_SIZE, LED_SIZE, st.bgColor);
+
+      // Draw subtle dark circle for off LED (visible against black)
+      // Using darker version of surround color for off LED housing
+      uint16_t offHousing = dimRGB565(st.surroundColor, 7);  // Very dim (1/8 brightness)
+      uint16_t offLED = 0x1800;  // Very dark red (barely visible)
+
+      for (int py = 1; py < 9; py++) {
+        for (int px = 1; px < 9; px++) {
+          int cx = px - 1;
+          int cy = py - 1;
+          int dx = (cx * 2 - 7);
+          int dy = (cy * 2 - 7);
+          int distSq = dx * dx + dy * dy;
+
+          if (distSq <= 42) {  // Inner dark circle
+            canvas.drawPixel(screenX + px, screenY + py, offLED);
+          }
+          else if (distSq <= 58) {  // Dim surround
+            canvas.drawPixel(screenX + px, screenY + py, offHousing);
+          }
+        }
+      }
+    }
+    else {
+      // LIT LED: Draw bright circular LED with surround
+      // Fill background with surround color first
+      canvas.fillRect(screenX, screenY, LED_SIZE, LED_SIZE, st.surroundColor);
+
+      // Draw from outside in for better circular appearance
+      for (int py = 0; py < 10; py++) {
+        for (int px = 0; px < 10; px++) {
+          int cx = px;
+          int cy = py;
+          int dx = (cx * 2 - 9);
+          int dy = (cy * 2 - 9);
+          int distSq = dx * dx + dy * dy;
+
+          uint16_t pixelColor;
+
+          // Redesigned for better visibility of surround
+          if (distSq <= 18) {
+            // Bright center (core)
+            pixelColor = st.onColor;
+          }
+          else if (distSq <= 38) {
+            // Main LED body (still bright)
+            pixelColor = st.onColor;
+          }
+          else if (distSq <= 62) {
+            // Surround/bezel ring (use full surround color, not dimmed)
+            pixelColor = st.surroundColor;
+          }
+          else {
+            // Outside circle: black
+            pixelColor = st.bgColor;
+          }
+
+          canvas.drawPixel(screenX + px, screenY + py, pixelColor);
+        }
+      }
+    }
+  }
+}
+
+// Draw all 8 LEDs of one scr column byte (bit 0 = top LED of the row)
+template <class Canvas>
+void renderLEDColumn(Canvas& canvas, int originX, int originY, int x, int row,
+                     uint8_t pixelByte, const LedStyle& st) {
+  for (int bitPos = 0; bitPos < 8; bitPos++) {
+    int y = row * 8 + bitPos;
+    renderLEDCell(canvas, originX + ledCellX(x), originY + ledCellY(y),
+                  (pixelByte & (1 << bitPos)) != 0, st);
+  }
+}
+
+// Forwards to another canvas and counts the bytes an ILI9341-class panel is
+// sent for each call: the address window (CASET/RASET/RAMWR commands with
+// their parameters) plus 2 bytes per RGB565 pixel. TFT_eSPI skips unchanged
+// window commands for runs of pixels, so this is an upper bound.
+#define SPI_WINDOW_BYTES  11
+
+template <class Canvas>
+class SpiCountingCanvas {
+public:
+  explicit SpiCountingCanvas(Canvas& target) : canvas(target), count(0) {}
+
+  void fillRect(int32_t x, int32_t y, int32_t w, int32_t h, uint32_t color) {
+    canvas.fillRect(x, y, w, h, color);
+    count += SPI_WINDOW_BYTES + (uint32_t)(w * h) * 2;
+  }
+
+  void drawPixel(int32_t x, int32_t y, uint32_t color) {
+    canvas.drawPixel(x, y, color);
+    count += SPI_WINDOW_BYTES + 2;
+  }
+
+  uint64_t bytes() const { return count; }
+
+private:
+  Canvas& canvas;
+  uint64_t count;
+};
+
+#endif // LED_RENDERER_H
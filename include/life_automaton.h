@@ -0,0 +1,162 @@
+/*
+ * life_automaton.h - Bit-Parallel Cellular Automaton (Life-like rules)
+ *
+ * Runs Conway's Life, or any B/S rule, on the 32x16 matrix. State is kept
+ * in the scr column layout: one uint16_t per column, bit y = row y (the top
+ * matrix row's byte in the low half, the bottom row's byte in the high
+ * half), wrapping at all four edges.
+ *
+ * A generation is computed SWAR-style, 16 cells per operation: the eight
+ * neighbour bit-planes of a column (left/centre/right, each shifted up and
+ * down) are added with bit-sliced half adders into a 4-bit count per cell,
+ * and the rule is applied as mask operations on those count bits. No loop
+ * ever touches an individual cell.
+ *
+ * Rules are "B<digits>/S<digits>", e.g. "B3/S23" (Life), "B36/S23"
+ * (HighLife), "B2/S" (Seeds).
+ */
+
+#ifndef LIFE_AUTOMATON_H
+#define LIFE_AUTOMATON_H
+
+#include <Arduino.h>
+
+#define LIFE_WIDTH   32
+#define LIFE_HEIGHT  16
+
+class LifeAutomaton {
+public:
+  LifeAutomaton() : birth(1 << 3), survive((1 << 2) | (1 << 3)), generation(0) {
+    memset(cells, 0, sizeof(cells));
+    memset(previous, 0, sizeof(previous));
+    memset(older, 0, sizeof(older));
+  }
+
+  // Parse "B3/S23". Returns false (rule unchanged) if malformed.
+  bool setRule(const char* rule) {
+    uint16_t b = 0, s = 0;
+    uint16_t* target = nullptr;
+    for (const char* p = rule; *p; p++) {
+      if (*p == 'B' || *p == 'b') target = &b;
+      else if (*p == 'S' || *p == 's') target = &s;
+      else if (*p == '/') continue;
+      else if (*p >= '0' && *p <= '8' && target) *target |= 1 << (*p - '0');
+      else return false;
+    }
+    if (b & 1) return false;  // B0 would flash the whole (wrapped) field
+    birth = b;
+    survive = s;
+    return true;
+  }
+
+  // Current rule back as "B3/S23"
+  void ruleString(char* out, size_t size) const {
+    size_t n = 0;
+    if (n < size - 1) out[n++] = 'B';
+    for (int i = 0; i <= 8; i++) if ((birth & (1 << i)) && n < size - 1) out[n++] = '0' + i;
+    if (n < size - 1) out[n++] = '/';
+    if (n < size - 1) out[n++] = 'S';
+    for (int i = 0; i <= 8; i++) if ((survive & (1 << i)) && n < size - 1) out[n++] = '0' + i;
+    out[n] = 0;
+  }
+
+  // Seed from an scr frame (DISPLAY_ROWS = 2, LINE_WIDTH = 32)
+  void load(const uint8_t* frame) {
+    for (int x = 0; x < LIFE_WIDTH; x++) {
+      cells[x] = frame[x] | (frame[x + LIFE_WIDTH] << 8);
+    }
+    generation = 0;
+  }
+
+  void store(uint8_t* frame) const {
+    for (int x = 0; x < LIFE_WIDTH; x++) {
+      frame[x] = cells[x] & 0xFF;
+      frame[x + LIFE_WIDTH] = cells[x] >> 8;
+    }
+  }
+
+  // Roughly `percent` of cells alive, from the supplied random source
+  void randomize(uint32_t (*random32)(), uint8_t percent = 35) {
+    for (int x = 0; x < LIFE_WIDTH; x++) {
+      uint16_t col = 0;
+      for (int y = 0; y < LIFE_HEIGHT; y++) {
+        if (random32() % 100 < percent) col |= 1 << y;
+      }
+      cells[x] = col;
+    }
+    generation = 0;
+  }
+
+  void step() {
+    uint16_t next[LIFE_WIDTH];
+    for (int x = 0; x < LIFE_WIDTH; x++) {
+      uint16_t l = cells[(x + LIFE_WIDTH - 1) % LIFE_WIDTH];
+      uint16_t c = cells[x];
+      uint16_t r = cells[(x + 1) % LIFE_WIDTH];
+
+      // Bit-sliced neighbour count: s3..s0 per cell (0-8)
+      uint16_t s0 = 0, s1 = 0, s2 = 0, s3 = 0;
+      add(rotUp(l), s0, s1, s2, s3);
+      add(l,        s0, s1, s2, s3);
+      add(rotDn(l), s0, s1, s2, s3);
+      add(rotUp(c), s0, s1, s2, s3);
+      add(rotDn(c), s0, s1, s2, s3);
+      add(rotUp(r), s0, s1, s2, s3);
+      add(r,        s0, s1, s2, s3);
+      add(rotDn(r), s0, s1, s2, s3);
+
+      // next = OR over counts n of (count == n) & (alive ? S[n] : B[n])
+      uint16_t out = 0;
+      for (int n = 0; n <= 8; n++) {
+        bool b = birth & (1 << n), s = survive & (1 << n);
+        if (!b && !s) continue;
+        uint16_t eq = ((n & 1) ? s0 : ~s0) & ((n & 2) ? s1 : ~s1) &
+                      ((n & 4) ? s2 : ~s2) & ((n & 8) ? s3 : ~s3);
+        uint16_t mask = b && s ? 0xFFFF : s ? c : (uint16_t)~c;
+        out |= eq & mask;
+      }
+      next[x] = out;
+    }
+    memcpy(older, previous, sizeof(cells));
+    memcpy(previous, cells, sizeof(cells));
+    memcpy(cells, next, sizeof(cells));
+    generation++;
+  }
+
+  uint16_t population() const {
+    uint16_t n = 0;
+    for (int x = 0; x < LIFE_WIDTH; x++) n += __builtin_popcount(cells[x]);
+    return n;
+  }
+
+  // Dead, still life, or period-2 oscillator - worth reseeding
+  bool stagnant() const {
+    return population() == 0 ||
+           memcmp(cells, previous, sizeof(cells)) == 0 ||
+           memcmp(cells, older, sizeof(cells)) == 0;
+  }
+
+  const uint16_t* state() const { return cells; }
+  uint32_t generations() const { return generation; }
+
+private:
+  static uint16_t rotUp(uint16_t v) { return (v >> 1) | (v << 15); }  // Row y+1 seen at y
+  static uint16_t rotDn(uint16_t v) { return (v << 1) | (v >> 15); }
+
+  // Add a 1-bit plane into the bit-sliced counter
+  static void add(uint16_t v, uint16_t& s0, uint16_t& s1, uint16_t& s2, uint16_t& s3) {
+    uint16_t c0 = s0 & v;  s0 ^= v;
+    uint16_t c1 = s1 & c0; s1 ^= c0;
+    uint16_t c2 = s2 & c1; s2 ^= c1;
+    s3 |= c2;
+  }
+
+  uint16_t cells[LIFE_WIDTH];
+  uint16_t previous[LIFE_WIDTH];  // One generation back
+  uint16_t older[LIFE_WIDTH];     // Two generations back
+  uint16_t birth;    // Bit n set = birth with n neighbours
+  uint16_t survive;  // Bit n set = survival with n neighbours
+  uint32_t generation;
+};
+
+#endif // LIFE_AUTOMATON_H
@@ -0,0 +1,227 @@
+/*
+ * max7219_decoder.h - MAX7219 Register-Stream Emulator
+ *
+ * Accepts the same 16-bit register writes a real MAX7219 cascade receives
+ * and maps the emulated modules onto scr, so existing MAX7219 host software
+ * can drive the TFT instead of real modules.
+ *
+ * Stream format (same for UDP datagrams and Serial):
+ *   'M' '7'  modules  latches  then latches x modules x 2 bytes
+ * Each latch is what the chain holds when LOAD rises: one big-endian word
+ * (register << 8 | data) per module, farthest module first - exactly the
+ * bytes a host would clock out on DIN. Module 0 (nearest DIN) is the
+ * top-left 8x8 block; modules continue row-major, `wide` per row.
+ *
+ * Registers: digits 0-7, decode mode (stored, matrices use raw rows),
+ * intensity, scan limit (digits beyond it are blank), shutdown (module
+ * blank, registers kept) and display test (all LEDs on). Power-up state
+ * follows the datasheet: shutdown, scan limit 0, intensity 0.
+ *
+ * All latches in a packet are decoded before the frame is marked dirty,
+ * so a full-cascade update becomes one refresh.
+ */
+
+#ifndef MAX7219_DECODER_H
+#define MAX7219_DECODER_H
+
+#include <Arduino.h>
+#include "display_sink.h"
+#include "max7219_sink.h"  // Register addresses
+
+#define MAX7219_EMU_MAX_MODULES  (FRAME_BYTES / 8)
+
+#ifndef MAX7219_EMU_TIMEOUT
+  #define MAX7219_EMU_TIMEOUT 5000
+#endif
+
+struct Max7219Module {
+  uint8_t digits[8];
+  uint8_t decodeMode;
+  uint8_t intensity;
+  uint8_t scanLimit;
+  bool    shutdown;
+  bool    displayTest;
+};
+
+struct Max7219DecoderStats {
+  uint32_t packets;    // Complete packets decoded
+  uint32_t latches;    // LOAD edges emulated
+  uint32_t writes;     // Register writes (NO-OPs excluded)
+  uint32_t errors;     // Bad header / module count mismatch
+};
+
+class Max7219Decoder {
+public:
+  Max7219Decoder() : moduleCount(MAX7219_EMU_MAX_MODULES), wide(LINE_WIDTH / 8), reverse(false),
+                     active(false), dirty(false), lastPacketMs(0) {
+    memset(&stats, 0, sizeof(stats));
+    reset();
+  }
+
+  // Cascade layout; the emulated modules must fit in scr
+  bool configure(uint8_t modules, uint8_t modulesWide, bool reverseColumns) {
+    if (modules == 0 || modulesWide == 0 || modules > MAX7219_EMU_MAX_MODULES ||
+        modulesWide > LINE_WIDTH / 8 || (modules + modulesWide - 1) / modulesWide > DISPLAY_ROWS) {
+      return false;
+    }
+    moduleCount = modules;
+    wide = modulesWide;
+    reverse = reverseColumns;
+    reset();
+    return true;
+  }
+
+  // Power-up register state for every module
+  void reset() {
+    memset(modules, 0, sizeof(modules));
+    for (int m = 0; m < MAX7219_EMU_MAX_MODULES; m++) modules[m].shutdown = true;
+    parseState = PARSE_M;
+    dirty = true;
+  }
+
+  // Feed stream bytes (any split). Call resync() at datagram boundaries.
+  void feed(const uint8_t* data, size_t len, uint32_t nowMs) {
+    for (size_t i = 0; i < len; i++) {
+      uint8_t b = data[i];
+      switch (parseState) {
+        case PARSE_M:
+          if (b == 'M') parseState = PARSE_7;
+          else stats.errors++;
+          break;
+        case PARSE_7:
+          parseState = (b == '7') ? PARSE_MODULES : PARSE_M;
+          if (b != '7') stats.errors++;
+          break;
+        case PARSE_MODULES:
+          if (b != moduleCount) {
+            stats.errors++;
+            parseState = PARSE_M;
+          } else {
+            parseState = PARSE_LATCHES;
+          }
+          break;
+        case PARSE_LATCHES:
+          latchesLeft = b;
+          bytePos = 0;
+          parseState = latchesLeft ? PARSE_DATA : PARSE_M;
+          if (!latchesLeft) finishPacket(nowMs);
+          break;
+        case PARSE_DATA:
+          latch[bytePos++] = b;
+          if (bytePos == moduleCount * 2) {
+            applyLatch();
+            bytePos = 0;
+            if (--latchesLeft == 0) {
+              parseState = PARSE_M;
+              finishPacket(nowMs);
+            }
+          }
+          break;
+      }
+    }
+  }
+
+  // Drop a partial packet (e.g. a truncated datagram)
+  void resync() {
+    if (parseState != PARSE_M) stats.errors++;
+    parseState = PARSE_M;
+  }
+
+  // Give the display back after the host goes quiet. True on the transition.
+  bool expire(uint32_t nowMs) {
+    if (active && nowMs - lastPacketMs >= MAX7219_EMU_TIMEOUT) {
+      active = false;
+      return true;
+    }
+    return false;
+  }
+
+  bool isActive() const { return active; }
+
+  // Render the emulated modules into scr if anything changed since the last call
+  bool takeFrame(uint8_t* frame) {
+    if (!dirty) return false;
+    memset(frame, 0, FRAME_BYTES);
+    for (int m = 0; m < moduleCount; m++) {
+      const Max7219Module& mod = modules[m];
+      uint8_t* col = frame + (m % wide) * 8 + (m / wide) * LINE_WIDTH;
+      for (uint8_t d = 0; d < 8; d++) {
+        uint8_t row = mod.displayTest ? 0xFF
+                    : (mod.shutdown || d > mod.scanLimit) ? 0
+                    : mod.digits[d];
+        for (int i = 0; i < 8; i++) {
+          bool lit = reverse ? (row >> i) & 1 : (row >> (7 - i)) & 1;
+          if (lit) col[i] |= 1 << d;
+        }
+      }
+    }
+    dirty = false;
+    return true;
+  }
+
+  // Highest intensity of any lit module (0-15), for the backlight
+  uint8_t intensity() const {
+    uint8_t level = 0;
+    for (int m = 0; m < moduleCount; m++) {
+      if (!modules[m].shutdown && modules[m].intensity > level) level = modules[m].intensity;
+    }
+    return level;
+  }
+
+  uint8_t modulesConfigured() const { return moduleCount; }
+  uint8_t modulesWide() const { return wide; }
+  bool reversed() const { return reverse; }
+  const Max7219Module& module(int i) const { return modules[i]; }
+
+  Max7219DecoderStats stats;
+
+private:
+  enum ParseState : uint8_t { PARSE_M, PARSE_7, PARSE_MODULES, PARSE_LATCHES, PARSE_DATA };
+
+  // Word i of the latch sits in module (count - 1 - i)
+  void applyLatch() {
+    stats.latches++;
+    for (int i = 0; i < moduleCount; i++) {
+      Max7219Module& mod = modules[moduleCount - 1 - i];
+      uint8_t reg = latch[i * 2] & 0x0F;
+      uint8_t value = latch[i * 2 + 1];
+      if (reg == MAX7219_REG_NOOP) continue;
+      stats.writes++;
+      if (reg >= MAX7219_REG_DIGIT0 && reg < MAX7219_REG_DIGIT0 + 8) {
+        mod.digits[reg - MAX7219_REG_DIGIT0] = value;
+      } else if (reg == MAX7219_REG_DECODEMODE) {
+        mod.decodeMode = value;
+      } else if (reg == MAX7219_REG_INTENSITY) {
+        mod.intensity = value & 0x0F;
+      } else if (reg == MAX7219_REG_SCANLIMIT) {
+        mod.scanLimit = value & 0x07;
+      } else if (reg == MAX7219_REG_SHUTDOWN) {
+        mod.shutdown = (value & 0x01) == 0;
+      } else if (reg == MAX7219_REG_DISPLAYTEST) {
+        mod.displayTest = (value & 0x01) != 0;
+      }
+    }
+  }
+
+  void finishPacket(uint32_t nowMs) {
+    stats.packets++;
+    active = true;
+    dirty = true;
+    lastPacketMs = nowMs;
+  }
+
+  Max7219Module modules[MAX7219_EMU_MAX_MODULES];
+  uint8_t moduleCount;
+  uint8_t wide;
+  bool reverse;
+  bool active;
+  bool dirty;
+  uint32_t lastPacketMs;
+
+  ParseState parseState;
+  uint8_t latchesLeft;
+  uint8_t bytePos;
+  uint8_t latch[MAX7219_EMU_MAX_MODULES * 2];
+};
+
+#endif // MAX7219_DECODER_H
@@ -0,0 +1,125 @@
+/*
+ * max7219_sink.h - Real MAX7219 LED Matrix Chain Display Sink
+ *
+ * Drives a chain of MAX7219 8x8 modules from the same scr frame the TFT
+ * renders. Modules are numbered row-major (left to right, top to bottom)
+ * with module 0 nearest the ESP8266 DIN pin.
+ *
+ * Wiring: shares hardware SPI with the TFT (MOSI=D7, SCK=D5) and uses its
+ * own LOAD/CS pin. Stray TFT traffic is shifted through the chain but never
+ * latched, because every MAX7219 write clocks a full chain-length frame
+ * before LOAD rises. SUPPORT_TRANSACTIONS must be defined in User_Setup.h
+ * (main_tft.cpp stops the build otherwise) so TFT_eSPI restores its own SPI
+ * clock after a MAX7219 write.
+ *
+ * Only modules whose columns are in the dirty mask are written; clean
+ * modules in the same digit transaction receive a NO-OP.
+ */
+
+#ifndef MAX7219_SINK_H
+#define MAX7219_SINK_H
+
+#include <Arduino.h>
+#include <SPI.h>
+#include "display_sink.h"
+
+// MAX7219 register addresses
+#define MAX7219_REG_NOOP        0x00
+#define MAX7219_REG_DIGIT0      0x01  // Digits 0-7 = registers 0x01-0x08
+#define MAX7219_REG_DECODEMODE  0x09
+#define MAX7219_REG_INTENSITY   0x0A
+#define MAX7219_REG_SCANLIMIT   0x0B
+#define MAX7219_REG_SHUTDOWN    0x0C
+#define MAX7219_REG_DISPLAYTEST 0x0F
+
+#define MAX7219_SPI_FREQUENCY   10000000  // Datasheet maximum
+#define MAX7219_MODULES_WIDE    (LINE_WIDTH / 8)
+#define MAX7219_MODULES         (MAX7219_MODULES_WIDE * DISPLAY_ROWS)
+
+class Max7219Sink : public DisplaySink {
+public:
+  // reverseColumns: set for modules whose column 0 is the LSB (most FC-16 boards use MSB)
+  Max7219Sink(uint8_t csPin, uint8_t intensity = 8, bool reverseColumns = false)
+    : cs(csPin), intensity(intensity), reverse(reverseColumns) {}
+
+  const char* name() const override { return "max7219"; }
+
+  void begin() override {
+    pinMode(cs, OUTPUT);
+    digitalWrite(cs, HIGH);
+    SPI.begin();
+    writeAll(MAX7219_REG_SCANLIMIT, 7);    // Scan all 8 digits
+    writeAll(MAX7219_REG_DECODEMODE, 0);   // Raw segments (matrix mode)
+    writeAll(MAX7219_REG_DISPLAYTEST, 0);
+    writeAll(MAX7219_REG_INTENSITY, intensity);
+    for (uint8_t d = 0; d < 8; d++) writeAll(MAX7219_REG_DIGIT0 + d, 0);
+    writeAll(MAX7219_REG_SHUTDOWN, 1);     // Normal operation
+  }
+
+  void setIntensity(uint8_t level) {
+    intensity = level & 0x0F;
+    writeAll(MAX7219_REG_INTENSITY, intensity);
+  }
+
+  void present(const uint8_t* frame, uint64_t dirty, const LedStyle& style) override {
+    (void)style;  // Real LEDs have their own color
+
+    // A module is dirty if any of its 8 column bytes changed
+    bool moduleDirty[MAX7219_MODULES];
+    bool anyDirty = false;
+    for (int m = 0; m < MAX7219_MODULES; m++) {
+      int first = (m % MAX7219_MODULES_WIDE) * 8 + (m / MAX7219_MODULES_WIDE) * LINE_WIDTH;
+      moduleDirty[m] = ((dirty >> first) & 0xFF) != 0;
+      anyDirty |= moduleDirty[m];
+    }
+    if (!anyDirty) return;
+
+    // One chain transaction per digit (row), NO-OP for clean modules
+    uint16_t words[MAX7219_MODULES];
+    for (uint8_t digit = 0; digit < 8; digit++) {
+      for (int m = 0; m < MAX7219_MODULES; m++) {
+        words[m] = moduleDirty[m]
+          ? ((uint16_t)(MAX7219_REG_DIGIT0 + digit) << 8) | moduleRow(frame, m, digit)
+          : MAX7219_REG_NOOP << 8;
+      }
+      transfer(words);
+    }
+  }
+
+private:
+  // Transpose: scr bytes are vertical (bit = y), MAX7219 digits are horizontal (bit = x)
+  uint8_t moduleRow(const uint8_t* frame, int module, uint8_t digit) const {
+    const uint8_t* col = frame + (module % MAX7219_MODULES_WIDE) * 8 +
+                         (module / MAX7219_MODULES_WIDE) * LINE_WIDTH;
+    uint8_t value = 0;
+    for (int i = 0; i < 8; i++) {
+      if (col[i] & (1 << digit)) {
+        value |= reverse ? (1 << i) : (0x80 >> i);
+      }
+    }
+    return value;
+  }
+
+  void writeAll(uint8_t reg, uint8_t value) {
+    uint16_t words[MAX7219_MODULES];
+    for (int m = 0; m < MAX7219_MODULES; m++) words[m] = ((uint16_t)reg << 8) | value;
+    transfer(words);
+  }
+
+  // Farthest module first - data for module 0 is shifted in last
+  void transfer(const uint16_t* words) {
+    SPI.beginTransaction(SPISettings(MAX7219_SPI_FREQUENCY, MSBFIRST, SPI_MODE0));
+    digitalWrite(cs, LOW);
+    for (int m = MAX7219_MODULES - 1; m >= 0; m--) {
+      SPI.transfer16(words[m]);
+    }
+    digitalWrite(cs, HIGH);  // Rising edge latches all modules at once
+    SPI.endTransaction();
+  }
+
+  uint8_t cs;
+  uint8_t intensity;
+  bool reverse;
+};
+
+#endif // MAX7219_SINK_H
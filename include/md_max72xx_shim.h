@@ -0,0 +1,261 @@
+/*
+ * md_max72xx_shim.h - MD_MAX72xx-Compatible Drawing API over scr
+ *
+ * Lets sketches written for the MD_MAX72xx library draw into scr with the
+ * calls they already use, instead of the hand mapping in
+ * MAX7219_EMULATION_GUIDE.md. One object covers one matrix row (4 modules,
+ * 32 columns); create a second for the lower row.
+ *
+ * Coordinates follow MD_MAX72xx: column 0 is the rightmost column of the
+ * row, row 0 is the top LED row, and column bytes have bit 0 at the top
+ * (the same bit order as scr, so setColumn() is a single byte store).
+ *
+ * Updates are always deferred. Drawing calls only change scr and set a
+ * pending flag; nothing is sent to the display per call. update() - or
+ * service() while control(UPDATE, ON) is in effect - hands the whole batch
+ * to the refresh function (refreshAll(), which redraws only changed bytes).
+ * Call service() from a periodic task so auto-update sketches see changes
+ * at frame rate.
+ *
+ * setChar() uses fonts in the fonts.h format (height <= 8).
+ */
+
+#ifndef MD_MAX72XX_SHIM_H
+#define MD_MAX72XX_SHIM_H
+
+#include <Arduino.h>
+#include "display_sink.h"
+
+class MD_MAX72XX {
+public:
+  enum controlRequest_t { SHUTDOWN, SCANLIMIT, INTENSITY, TEST, DECODE, UPDATE, WRAPAROUND };
+  enum controlValue_t { OFF = 0, ON = 1 };
+  enum transformType_t { TSL, TSR, TSU, TSD, TFLR, TFUD, TRC, TINV };
+
+  typedef void (*RefreshFunction)();
+
+  MD_MAX72XX(uint8_t* frame, RefreshFunction refresh, uint8_t matrixRow = 0, const uint8_t* font = nullptr)
+    : buf(frame + matrixRow * LINE_WIDTH), refreshFn(refresh), font(font),
+      autoUpdate(true), wrap(false), pending(false), intensity(8), shutdown(false), updates(0) {}
+
+  void begin() { clear(); }
+
+  uint8_t getDeviceCount() const { return LINE_WIDTH / 8; }
+  uint16_t getColumnCount() const { return LINE_WIDTH; }
+
+  // ---- Drawing ----
+
+  void clear() { clear(0, getDeviceCount() - 1); }
+
+  void clear(uint8_t startDev, uint8_t endDev) {
+    for (uint8_t d = startDev; d <= endDev && d < getDeviceCount(); d++) {
+      for (int c = 0; c < 8; c++) buf[index(d * 8 + c)] = 0;
+    }
+    touched();
+  }
+
+  bool setColumn(uint16_t c, uint8_t value) {
+    if (c >= LINE_WIDTH) return false;
+    buf[index(c)] = value;
+    touched();
+    return true;
+  }
+
+  uint8_t getColumn(uint16_t c) const {
+    return c < LINE_WIDTH ? buf[index(c)] : 0;
+  }
+
+  bool setPoint(uint8_t r, uint16_t c, bool state) {
+    if (r >= 8 || c >= LINE_WIDTH) return false;
+    if (state) buf[index(c)] |= (1 << r);
+    else buf[index(c)] &= ~(1 << r);
+    touched();
+    return true;
+  }
+
+  bool getPoint(uint8_t r, uint16_t c) const {
+    return r < 8 && c < LINE_WIDTH && (buf[index(c)] & (1 << r));
+  }
+
+  // Set one row of one device; bit 7 is the leftmost column of the device
+  bool setRow(uint8_t dev, uint8_t r, uint8_t value) {
+    if (dev >= getDeviceCount() || r >= 8) return false;
+    for (int i = 0; i < 8; i++) {
+      uint16_t c = dev * 8 + i;  // i = 0 is the device's rightmost column
+      if (value & (1 << i)) buf[index(c)] |= (1 << r);
+      else buf[index(c)] &= ~(1 << r);
+    }
+    touched();
+    return true;
+  }
+
+  // Same row in every device
+  bool setRow(uint8_t r, uint8_t value) {
+    bool ok = true;
+    for (uint8_t d = 0; d < getDeviceCount(); d++) ok &= setRow(d, r, value);
+    return ok;
+  }
+
+  void setFont(const uint8_t* f) { font = f; }
+
+  // Column bytes of character c into out (up to size). Returns its width.
+  uint8_t getChar(uint16_t c, uint8_t size, uint8_t* out) const {
+    const uint8_t* glyph = findChar(c);
+    if (glyph == nullptr) return 0;
+    uint8_t w = pgm_read_byte(glyph);
+    if (w > size) w = size;
+    for (uint8_t i = 0; i < w; i++) out[i] = pgm_read_byte(glyph + 1 + i);
+    return w;
+  }
+
+  // Draw c with its left edge at column col (extending towards column 0).
+  // Returns the character width.
+  uint8_t setChar(uint16_t col, uint16_t c) {
+    const uint8_t* glyph = findChar(c);
+    if (glyph == nullptr) return 0;
+    uint8_t w = pgm_read_byte(glyph);
+    for (uint8_t i = 0; i < w; i++) {
+      int target = (int)col - i;
+      if (target < 0) break;
+      if (target < LINE_WIDTH) buf[index(target)] = pgm_read_byte(glyph + 1 + i);
+    }
+    touched();
+    return w;
+  }
+
+  // ---- Transformations ----
+
+  bool transform(transformType_t t) { return transform(0, getDeviceCount() - 1, t); }
+
+  bool transform(uint8_t startDev, uint8_t endDev, transformType_t t) {
+    if (startDev > endDev || endDev >= getDeviceCount()) return false;
+    uint16_t lo = startDev * 8, hi = endDev * 8 + 7;  // MD column range
+
+    switch (t) {
+      case TSL: {  // Content moves left = towards higher MD columns
+        uint8_t out = buf[index(hi)];
+        for (uint16_t c = hi; c > lo; c--) buf[index(c)] = buf[index(c - 1)];
+        buf[index(lo)] = wrap ? out : 0;
+        break;
+      }
+      case TSR: {
+        uint8_t out = buf[index(lo)];
+        for (uint16_t c = lo; c < hi; c++) buf[index(c)] = buf[index(c + 1)];
+        buf[index(hi)] = wrap ? out : 0;
+        break;
+      }
+      case TSU:  // Bit 0 is the top row
+        for (uint16_t c = lo; c <= hi; c++) {
+          uint8_t& b = buf[index(c)];
+          b = (b >> 1) | (wrap ? (b & 1) << 7 : 0);
+        }
+        break;
+      case TSD:
+        for (uint16_t c = lo; c <= hi; c++) {
+          uint8_t& b = buf[index(c)];
+          b = (b << 1) | (wrap ? b >> 7 : 0);
+        }
+        break;
+      case TFLR:  // Mirror each device left-right
+        for (uint8_t d = startDev; d <= endDev; d++) {
+          for (int i = 0; i < 4; i++) {
+            uint8_t tmp = buf[index(d * 8 + i)];
+            buf[index(d * 8 + i)] = buf[index(d * 8 + 7 - i)];
+            buf[index(d * 8 + 7 - i)] = tmp;
+          }
+        }
+        break;
+      case TFUD:
+        for (uint16_t c = lo; c <= hi; c++) buf[index(c)] = reverseBits(buf[index(c)]);
+        break;
+      case TRC:  // Rotate each device 90 degrees clockwise
+        for (uint8_t d = startDev; d <= endDev; d++) rotateDevice(d);
+        break;
+      case TINV:
+        for (uint16_t c = lo; c <= hi; c++) buf[index(c)] = ~buf[index(c)];
+        break;
+      default:
+        return false;
+    }
+    touched();
+    return true;
+  }
+
+  // ---- Control ----
+
+  bool control(controlRequest_t request, int value) {
+    switch (request) {
+      case UPDATE:
+        autoUpdate = value == ON;
+        if (autoUpdate) service();
+        return true;
+      case WRAPAROUND: wrap = value == ON; return true;
+      case INTENSITY:  intensity = value & 0x0F; return true;
+      case SHUTDOWN:   shutdown = value == ON; return true;
+      default:         return false;  // SCANLIMIT/TEST/DECODE have no meaning on a TFT
+    }
+  }
+
+  // Push pending changes to the display now (one diff-based refresh)
+  void update() {
+    if (!pending) return;
+    pending = false;
+    updates++;
+    if (refreshFn) refreshFn();
+  }
+
+  // Flush batched changes while auto-update is on; call once per frame
+  void service() {
+    if (autoUpdate) update();
+  }
+
+  bool hasPending() const { return pending; }
+  uint8_t getIntensity() const { return intensity; }
+  bool isShutdown() const { return shutdown; }
+  uint32_t updateCount() const { return updates; }
+
+private:
+  // MD column (0 = rightmost) to scr x
+  static int index(int c) { return LINE_WIDTH - 1 - c; }
+
+  void touched() { pending = true; }
+
+  static uint8_t reverseBits(uint8_t b) {
+    b = (b & 0xF0) >> 4 | (b & 0x0F) << 4;
+    b = (b & 0xCC) >> 2 | (b & 0x33) << 2;
+    b = (b & 0xAA) >> 1 | (b & 0x55) << 1;
+    return b;
+  }
+
+  void rotateDevice(uint8_t dev) {
+    uint8_t src[8], dst[8] = {0};
+    for (int i = 0; i < 8; i++) src[i] = buf[index(dev * 8 + 7 - i)];  // Left to right
+    for (int x = 0; x < 8; x++) {
+      for (int y = 0; y < 8; y++) {
+        if (src[x] & (1 << y)) dst[7 - y] |= (1 << x);
+      }
+    }
+    for (int i = 0; i < 8; i++) buf[index(dev * 8 + 7 - i)] = dst[i];
+  }
+
+  const uint8_t* findChar(uint16_t c) const {
+    if (font == nullptr || pgm_read_byte(font + 1) > 8) return nullptr;
+    uint8_t first = pgm_read_byte(font + 2);
+    uint8_t last = pgm_read_byte(font + 3);
+    if (c < first || c > last) return nullptr;
+    uint8_t fwd = pgm_read_byte(font);
+    return font + 4 + (c - first) * (fwd + 1);
+  }
+
+  uint8_t* buf;
+  RefreshFunction refreshFn;
+  const uint8_t* font;
+  bool autoUpdate;
+  bool wrap;
+  bool pending;
+  uint8_t intensity;
+  bool shutdown;
+  uint32_t updates;
+};
+
+#endif // MD_MAX72XX_SHIM_H
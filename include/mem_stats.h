@@ -0,0 +1,112 @@
+/*
+ * mem_stats.h - Heap and Fragmentation Instrumentation
+ *
+ * Samples free heap, largest free block and fragmentation before and after
+ * instrumented call sites (HTTP handlers, NTP sync, redraws) and keeps:
+ * - global low/high-water marks across every sample
+ * - per-site call count, last/worst/net free-heap delta
+ *
+ * A slowly leaking endpoint shows up as a steadily negative netDelta;
+ * fragmentation damage shows up as a falling minMaxBlock.
+ *
+ * Usage:
+ *   int site = memStats.addSite("/api/time");
+ *   { MemProbe probe(memStats, site); handler(); }
+ */
+
+#ifndef MEM_STATS_H
+#define MEM_STATS_H
+
+#include <Arduino.h>
+
+#define MEM_MAX_SITES  24
+
+struct HeapSample {
+  uint32_t freeHeap;
+  uint32_t maxBlock;
+  uint8_t  fragmentation;  // Percent (0 = one contiguous block)
+};
+
+struct MemSite {
+  const char* name;
+  uint32_t calls;
+  int32_t  lastDelta;      // Free heap after - before (negative = heap consumed)
+  int32_t  worstDelta;     // Most negative single-call delta
+  int32_t  netDelta;       // Sum of all deltas - drifts negative on a leak
+  uint32_t minFreeAfter;   // Lowest free heap seen right after this site
+};
+
+class MemStats {
+public:
+  MemStats() : siteCount(0) {
+    memset(sites, 0, sizeof(sites));
+    lowFree = lowMaxBlock = UINT32_MAX;
+    highFree = 0;
+    highFragmentation = 0;
+  }
+
+  static HeapSample read() {
+    HeapSample s;
+    s.freeHeap = ESP.getFreeHeap();
+    s.maxBlock = ESP.getMaxFreeBlockSize();
+    s.fragmentation = ESP.getHeapFragmentation();
+    return s;
+  }
+
+  // Take a sample and update global watermarks
+  HeapSample sample() {
+    HeapSample s = read();
+    if (s.freeHeap < lowFree) lowFree = s.freeHeap;
+    if (s.freeHeap > highFree) highFree = s.freeHeap;
+    if (s.maxBlock < lowMaxBlock) lowMaxBlock = s.maxBlock;
+    if (s.fragmentation > highFragmentation) highFragmentation = s.fragmentation;
+    return s;
+  }
+
+  int addSite(const char* name) {
+    for (int i = 0; i < siteCount; i++) {
+      if (strcmp(sites[i].name, name) == 0) return i;
+    }
+    if (siteCount >= MEM_MAX_SITES) return -1;
+    sites[siteCount].name = name;
+    sites[siteCount].minFreeAfter = UINT32_MAX;
+    return siteCount++;
+  }
+
+  void record(int site, const HeapSample& before, const HeapSample& after) {
+    if (site < 0 || site >= siteCount) return;
+    MemSite& m = sites[site];
+    int32_t delta = (int32_t)after.freeHeap - (int32_t)before.freeHeap;
+    m.calls++;
+    m.lastDelta = delta;
+    m.netDelta += delta;
+    if (delta < m.worstDelta) m.worstDelta = delta;
+    if (after.freeHeap < m.minFreeAfter) m.minFreeAfter = after.freeHeap;
+  }
+
+  int count() const { return siteCount; }
+  const MemSite& site(int i) const { return sites[i]; }
+
+  uint32_t lowFree;
+  uint32_t highFree;
+  uint32_t lowMaxBlock;
+  uint8_t  highFragmentation;
+
+private:
+  MemSite sites[MEM_MAX_SITES];
+  int siteCount;
+};
+
+// Samples on construction and records the delta on scope exit
+class MemProbe {
+public:
+  MemProbe(MemStats& stats, int site) : stats(stats), site(site), before(stats.sample()) {}
+  ~MemProbe() { stats.record(site, before, stats.sample()); }
+
+private:
+  MemStats& stats;
+  int site;
+  HeapSample before;
+};
+
+#endif // MEM_STATS_H
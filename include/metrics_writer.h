@@ -0,0 +1,113 @@
+/*
+ * metrics_writer.h - Prometheus Text Exposition from a Fixed Buffer
+ *
+ * Formats "# HELP" / "# TYPE" headers and samples line by line into a
+ * caller-owned buffer and hands the buffer to a flush callback whenever the
+ * next line would not fit (and once more at finish()). Nothing is allocated
+ * per scrape, however many series are written - on the device the callback
+ * sends each buffer as one HTTP chunk.
+ *
+ *   MetricsWriter m(buf, sizeof(buf), sendChunk, ctx);
+ *   m.family("clock_frames_total", "counter", "Frames pushed to the sinks");
+ *   m.sample("clock_frames_total", frames);
+ *   m.sample("clock_http_requests_total", "path", "/api/status", calls);
+ *   m.finish();
+ *
+ * Label values are escaped (\\, \", \n) as the format requires. A single
+ * line longer than the buffer is dropped and counted in overflows().
+ */
+
+#ifndef METRICS_WRITER_H
+#define METRICS_WRITER_H
+
+#include <Arduino.h>
+
+#define METRICS_LINE_MAX  160  // Longest single line formatted
+
+typedef void (*MetricsFlush)(const char* data, size_t len, void* ctx);
+
+class MetricsWriter {
+public:
+  MetricsWriter(char* buffer, size_t size, MetricsFlush flush, void* ctx)
+    : buf(buffer), cap(size), len(0), flushFn(flush), flushCtx(ctx),
+      total(0), flushes(0), dropped(0) {}
+
+  void family(const char* name, const char* type, const char* help) {
+    line("# HELP %s %s\n", name, help);
+    line("# TYPE %s %s\n", name, type);
+  }
+
+  void sample(const char* name, uint64_t value) {
+    line("%s %llu\n", name, (unsigned long long)value);
+  }
+
+  void sampleSigned(const char* name, int64_t value) {
+    line("%s %lld\n", name, (long long)value);
+  }
+
+  void sample(const char* name, const char* label, const char* labelValue, uint64_t value) {
+    char escaped[64];
+    escape(labelValue, escaped, sizeof(escaped));
+    line("%s{%s=\"%s\"} %llu\n", name, label, escaped, (unsigned long long)value);
+  }
+
+  // Histogram bucket: name_bucket{le="bound"} count (bound 0 = +Inf)
+  void bucket(const char* name, uint64_t bound, uint64_t count) {
+    if (bound) line("%s_bucket{le=\"%llu\"} %llu\n", name, (unsigned long long)bound, (unsigned long long)count);
+    else line("%s_bucket{le=\"+Inf\"} %llu\n", name, (unsigned long long)count);
+  }
+
+  // Send whatever is buffered
+  void finish() {
+    if (len == 0) return;
+    flushFn(buf, len, flushCtx);
+    total += len;
+    flushes++;
+    len = 0;
+  }
+
+  uint32_t bytes() const { return total + len; }
+  uint32_t flushCount() const { return flushes; }
+  uint32_t overflows() const { return dropped; }
+
+private:
+  void line(const char* fmt, ...) __attribute__((format(printf, 2, 3))) {
+    char text[METRICS_LINE_MAX];
+    va_list args;
+    va_start(args, fmt);
+    int n = vsnprintf(text, sizeof(text), fmt, args);
+    va_end(args);
+    if (n < 0 || n >= (int)sizeof(text) || (size_t)n > cap) {
+      dropped++;
+      return;
+    }
+    if (len + n > cap) finish();
+    memcpy(buf + len, text, n);
+    len += n;
+  }
+
+  static void escape(const char* in, char* out, size_t size) {
+    size_t o = 0;
+    for (; *in && o + 2 < size; in++) {
+      if (*in == '\\' || *in == '"') out[o++] = '\\';
+      if (*in == '\n') {
+        out[o++] = '\\';
+        out[o++] = 'n';
+        continue;
+      }
+      out[o++] = *in;
+    }
+    out[o] = 0;
+  }
+
+  char* buf;
+  size_t cap;
+  size_t len;
+  MetricsFlush flushFn;
+  void* flushCtx;
+  uint32_t total;
+  uint32_t flushes;
+  uint32_t dropped;
+};
+
+#endif // METRICS_WRITER_H
@@ -0,0 +1,191 @@
+/*
+ * ota_stream.h - Streaming Firmware Update in Fixed-Size Chunks
+ *
+ * Sits between an HTTP upload (arbitrary-sized pieces) and the flash
+ * writer. Incoming bytes are staged in one OTA_CHUNK_SIZE buffer and
+ * written out a full chunk at a time, so the image is never held in RAM
+ * and flash sees uniform writes. After each chunk the caller gets control
+ * back (tick the display, draw progress) before the next piece arrives.
+ *
+ * Integrity: the expected MD5 (32 hex digits) is required up front and
+ * handed to the writer, which hashes everything written and refuses to
+ * commit the image on mismatch. A short write, an image larger than the
+ * declared size, or an aborted upload also fail the update; nothing is
+ * committed unless finish() succeeds.
+ *
+ * Templated on the writer - the ESP8266 core's Updater on the device, a
+ * mock off-target. A Writer must provide:
+ *   bool   begin(size_t maxSize);
+ *   bool   setMD5(const char* expectedHex);
+ *   size_t write(uint8_t* data, size_t len);
+ *   bool   end(bool evenIfRemaining);    // true: verify MD5, commit on success
+ *                                        // false: discard an unfinished image
+ *   uint8_t getError();
+ */
+
+#ifndef OTA_STREAM_H
+#define OTA_STREAM_H
+
+#include <Arduino.h>
+
+#ifndef OTA_CHUNK_SIZE
+  #define OTA_CHUNK_SIZE 1024  // Quarter flash sector: the writer's sector buffer fills in 4 chunks
+#endif
+
+enum OtaState : uint8_t {
+  OTA_IDLE,
+  OTA_RECEIVING,
+  OTA_DONE,     // Verified and committed - reboot to run it
+  OTA_FAILED
+};
+
+template <class Writer>
+class OtaStream {
+public:
+  explicit OtaStream(Writer& writer) : writer(writer) { reset(); }
+
+  // expectedSize = exact image size if known, else 0 (up to maxSize)
+  bool begin(size_t expectedSize, size_t maxSize, const char* md5Hex, uint32_t nowMs) {
+    reset();
+    startMs = lastMs = nowMs;
+    state = OTA_RECEIVING;
+    if (!validMd5(md5Hex)) return fail("md5 must be 32 hex digits");
+    if (expectedSize > maxSize) return fail("image larger than the update partition");
+    limit = expectedSize ? expectedSize : maxSize;
+    declared = expectedSize;
+    if (!writer.begin(limit)) return fail("update partition unavailable");
+    begun = true;
+    if (!writer.setMD5(md5Hex)) return fail("md5 rejected");
+    return true;
+  }
+
+  // Stage an upload piece; full chunks go to flash. False once failed.
+  bool feed(const uint8_t* data, size_t len, uint32_t nowMs) {
+    if (state != OTA_RECEIVING) return false;
+    lastMs = nowMs;
+    if (received + len > limit) return fail("image larger than declared size");
+    received += len;
+    while (len > 0) {
+      size_t n = OTA_CHUNK_SIZE - staged;
+      if (n > len) n = len;
+      memcpy(chunk + staged, data, n);
+      staged += n;
+      data += n;
+      len -= n;
+      if (staged == OTA_CHUNK_SIZE && !flush()) return false;
+    }
+    return true;
+  }
+
+  // Last partial chunk, then verify + commit
+  bool finish(uint32_t nowMs) {
+    if (state != OTA_RECEIVING) return false;
+    lastMs = nowMs;
+    if (staged > 0 && !flush()) return false;
+    if (declared && written != declared) return fail("upload shorter than declared size");
+    begun = false;
+    if (!writer.end(true)) return fail("verify failed (md5 mismatch or flash error)");
+    state = OTA_DONE;
+    return true;
+  }
+
+  void abort(uint32_t nowMs) {
+    if (state != OTA_RECEIVING) return;
+    lastMs = nowMs;
+    fail("upload aborted");
+  }
+
+  // Refuse an upload before anything reaches the writer (e.g. not authorised)
+  void reject(const char* why, uint32_t nowMs) {
+    reset();
+    startMs = lastMs = nowMs;
+    state = OTA_RECEIVING;
+    fail(why);
+  }
+
+  OtaState status() const { return state; }
+  bool active() const { return state == OTA_RECEIVING; }
+  const char* error() const { return errorText; }
+  uint8_t writerError() const { return writerCode; }
+  uint32_t receivedBytes() const { return received; }
+  uint32_t writtenBytes() const { return written; }
+  uint32_t chunkCount() const { return chunks; }
+  uint32_t elapsedMs() const { return lastMs - startMs; }
+  uint32_t maxChunkUs() const { return maxWriteUs; }
+
+  // Percent of the declared size, -1 if the size wasn't declared
+  int percent() const {
+    if (declared == 0) return -1;
+    return (int)((uint64_t)received * 100 / declared);
+  }
+
+  uint32_t bytesPerSecond() const {
+    uint32_t ms = elapsedMs();
+    return ms ? (uint32_t)((uint64_t)received * 1000 / ms) : 0;
+  }
+
+private:
+  void reset() {
+    state = OTA_IDLE;
+    begun = false;
+    errorText = "";
+    writerCode = 0;
+    limit = declared = 0;
+    received = written = 0;
+    staged = 0;
+    chunks = 0;
+    startMs = lastMs = 0;
+    maxWriteUs = 0;
+  }
+
+  bool flush() {
+    uint32_t start = micros();
+    size_t n = writer.write(chunk, staged);
+    uint32_t us = micros() - start;
+    if (us > maxWriteUs) maxWriteUs = us;
+    if (n != staged) return fail("flash write failed");
+    written += n;
+    staged = 0;
+    chunks++;
+    return true;
+  }
+
+  bool fail(const char* why) {
+    if (state == OTA_RECEIVING && writerCode == 0) writerCode = writer.getError();
+    if (begun) {
+      begun = false;
+      writer.end(false);  // Release the partition, nothing committed
+    }
+    state = OTA_FAILED;
+    errorText = why;
+    staged = 0;
+    return false;
+  }
+
+  static bool validMd5(const char* hex) {
+    if (!hex) return false;
+    int n = 0;
+    for (; hex[n]; n++) {
+      if (!isxdigit((unsigned char)hex[n])) return false;
+    }
+    return n == 32;
+  }
+
+  Writer& writer;
+  uint8_t chunk[OTA_CHUNK_SIZE];
+  OtaState state;
+  bool begun;
+  const char* errorText;
+  uint8_t writerCode;
+  size_t limit;
+  size_t declared;
+  uint32_t received;
+  uint32_t written;
+  size_t staged;
+  uint32_t chunks;
+  uint32_t startMs;
+  uint32_t lastMs;
+  uint32_t maxWriteUs;
+};
+
+#endif // OTA_STREAM_H
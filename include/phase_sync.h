@@ -0,0 +1,174 @@
+/*
+ * phase_sync.h - Fleet Second-Edge Phase Sync over UDP Multicast
+ *
+ * One clock (the leader) multicasts a beacon on every second tick carrying
+ * its wall-clock time at the moment of sending. Followers stamp each beacon
+ * with their own wall clock on receipt; leader time minus receipt time is
+ * the clock offset less the network + polling delay. That delay is only
+ * ever positive, so the follower takes the largest sample of the last
+ * PHASE_WINDOW beacons (the least-delayed one) as its estimate and slews
+ * its offset a quarter of the way towards it per beacon. Larger errors
+ * (first lock, leader change, local clock step) are applied at once.
+ *
+ * The display then ticks on local clock + offset, so colon blinks and
+ * second edges across the fleet line up to within the best-case delay.
+ *
+ * Packet layout (little-endian):
+ *   0  'P' 'S'        magic
+ *   2  version        PHASE_VERSION
+ *   3  flags          reserved, send 0
+ *   4  seq (uint16)   incremented per beacon, wraps
+ *   6  sec (uint32)   leader UTC seconds at send
+ *  10  usec (uint32)  leader microseconds at send
+ *
+ * Times are passed in, so the filter runs unchanged off-target.
+ */
+
+#ifndef PHASE_SYNC_H
+#define PHASE_SYNC_H
+
+#include <Arduino.h>
+
+#define PHASE_PKT_SIZE   14
+#define PHASE_VERSION    1
+#define PHASE_WINDOW     8        // Beacons in the max filter
+#define PHASE_STEP_US    50000L   // Errors above this are stepped, not slewed
+#define PHASE_TIMEOUT_MS 5000     // Lock lost after this long without a beacon
+
+class PhaseSync {
+public:
+  PhaseSync() : txSeq(0) { reset(); }
+
+  void reset() {
+    offset = 0;
+    locked = false;
+    resync = false;
+    source = 0;
+    lastSeq = 0;
+    lastBeaconMs = 0;
+    windowCount = windowPos = 0;
+    beacons = lost = stale = malformed = steps = 0;
+    lastError = maxError = 0;
+  }
+
+  // Local clock was stepped (NTP): old samples no longer apply. The current
+  // offset stays in use until the next beacon replaces it.
+  void clockStepped() {
+    windowCount = windowPos = 0;
+    resync = true;
+  }
+
+  // Leader: fill buf (PHASE_PKT_SIZE bytes) with a beacon for wall time sec.usec
+  size_t buildBeacon(uint8_t* buf, uint32_t sec, uint32_t usec) {
+    buf[0] = 'P';
+    buf[1] = 'S';
+    buf[2] = PHASE_VERSION;
+    buf[3] = 0;
+    put16(buf + 4, txSeq++);
+    put32(buf + 6, sec);
+    put32(buf + 10, usec);
+    return PHASE_PKT_SIZE;
+  }
+
+  // Follower: one datagram from sourceId, received at local wall time
+  // localUs. Returns true if the offset was updated.
+  bool handleBeacon(const uint8_t* data, size_t len, uint32_t sourceId, int64_t localUs, uint32_t nowMs) {
+    if (len != PHASE_PKT_SIZE || data[0] != 'P' || data[1] != 'S' || data[2] != PHASE_VERSION) {
+      malformed++;
+      return false;
+    }
+    expire(nowMs);
+    uint16_t seq = get16(data + 4);
+    if (locked && sourceId != source) return false;  // Second leader - ignore until ours goes quiet
+    if (locked) {
+      int16_t delta = (int16_t)(seq - lastSeq);
+      if (delta <= 0) {
+        stale++;
+        return false;
+      }
+      lost += delta - 1;
+    }
+    lastSeq = seq;
+    lastBeaconMs = nowMs;
+    beacons++;
+
+    int64_t leaderUs = (int64_t)get32(data + 6) * 1000000LL + get32(data + 10);
+    if (!locked) windowCount = windowPos = 0;
+    source = sourceId;
+    window[windowPos] = leaderUs - localUs;
+    windowPos = (windowPos + 1) % PHASE_WINDOW;
+    if (windowCount < PHASE_WINDOW) windowCount++;
+
+    int64_t estimate = window[0];
+    for (int i = 1; i < windowCount; i++) {
+      if (window[i] > estimate) estimate = window[i];
+    }
+    int64_t error = estimate - offset;
+    if (!locked || resync || error > PHASE_STEP_US || error < -PHASE_STEP_US) {
+      offset = estimate;
+      steps++;
+      locked = true;
+      resync = false;
+      lastError = 0;
+      return true;
+    }
+    offset += error / 4;
+    lastError = (int32_t)error;
+    int32_t absError = lastError < 0 ? -lastError : lastError;
+    if (absError > maxError) maxError = absError;
+    return true;
+  }
+
+  // Drop the lock once the leader has been silent for PHASE_TIMEOUT_MS
+  void expire(uint32_t nowMs) {
+    if (locked && nowMs - lastBeaconMs >= PHASE_TIMEOUT_MS) {
+      locked = false;
+      windowCount = windowPos = 0;
+    }
+  }
+
+  bool isLocked() const { return locked; }
+  int64_t offsetUs() const { return locked ? offset : 0; }  // Add to local time for leader time
+  uint32_t leader() const { return source; }
+
+  // Sync quality: error of the last beacon vs the filtered offset, worst
+  // since lock, and the delay spread currently in the window
+  int32_t errorUs() const { return lastError; }
+  int32_t maxErrorUs() const { return maxError; }
+  int32_t spreadUs() const {
+    if (windowCount == 0) return 0;
+    int64_t lo = window[0], hi = window[0];
+    for (int i = 1; i < windowCount; i++) {
+      if (window[i] < lo) lo = window[i];
+      if (window[i] > hi) hi = window[i];
+    }
+    return (int32_t)(hi - lo);
+  }
+
+  uint32_t beaconCount() const { return beacons; }
+  uint32_t lostCount() const { return lost; }
+  uint32_t staleCount() const { return stale; }
+  uint32_t malformedCount() const { return malformed; }
+  uint32_t stepCount() const { return steps; }
+  uint16_t sentCount() const { return txSeq; }
+
+private:
+  static void put16(uint8_t* p, uint16_t v) { p[0] = v; p[1] = v >> 8; }
+  static void put32(uint8_t* p, uint32_t v) { put16(p, v); put16(p + 2, v >> 16); }
+  static uint16_t get16(const uint8_t* p) { return p[0] | (p[1] << 8); }
+  static uint32_t get32(const uint8_t* p) { return get16(p) | ((uint32_t)get16(p + 2) << 16); }
+
+  int64_t  offset;
+  bool     locked;
+  bool     resync;
+  uint32_t source;
+  uint16_t lastSeq;
+  uint16_t txSeq;
+  uint32_t lastBeaconMs;
+  int64_t  window[PHASE_WINDOW];
+  int      windowCount, windowPos;
+  uint32_t beacons, lost, stale, malformed, steps;
+  int32_t  lastError, maxError;
+};
+
+#endif // PHASE_SYNC_H
@@ -0,0 +1,216 @@
+/*
+ * scheduler.h - Deadline-based Cooperative Task Scheduler
+ *
+ * Replaces hand-rolled millis() comparisons in loop() with a small task
+ * table. Each task has a deadline, an optional period and a priority.
+ * runDue() executes every task whose deadline has passed (highest priority
+ * first, then earliest deadline) and returns how long the caller may sleep
+ * until the next deadline.
+ *
+ * Per-task statistics:
+ * - runs       - number of executions
+ * - overruns   - periodic task started a full period (or more) late
+ * - maxLatency - worst start delay past the deadline (ms)
+ * - maxRunTime - longest single execution (ms)
+ *
+ * The clock is injected (defaults to millis()) so the scheduler can be
+ * driven by a fake clock off-target. Without an Arduino core there is no
+ * default and a clock must be passed (see test/test_scheduler).
+ *
+ * The table is sized by SCHED_MAX_TASKS, which the sketch derives from
+ * its enabled features before including this header. addPeriodic() and
+ * addOneShot() return SCHED_INVALID once it is full. A few dozen tasks at
+ * most, so a linear scan is cheaper than maintaining a heap or timer wheel.
+ */
+
+#ifndef SCHEDULER_H
+#define SCHEDULER_H
+
+#if __has_include(<Arduino.h>)
+  #include <Arduino.h>
+  #define SCHED_HAS_MILLIS 1
+#else
+  #include <stdint.h>
+  #include <string.h>
+  #define SCHED_HAS_MILLIS 0
+#endif
+
+#ifndef SCHED_MAX_TASKS
+  #define SCHED_MAX_TASKS 16  // Default when the includer doesn't size the table
+#endif
+#define SCHED_INVALID     -1
+
+typedef void (*TaskFunction)();
+typedef uint32_t (*SchedulerClock)();
+
+struct SchedulerTask {
+  const char*  name;
+  TaskFunction fn;
+  uint32_t     period;      // 0 = one-shot
+  uint32_t     deadline;    // Next run time (clock units)
+  uint8_t      priority;    // Higher runs first when several tasks are due
+  bool         active;
+  bool         rescheduled; // Set when the task moved its own deadline while running
+
+  // Statistics
+  uint32_t     runs;
+  uint32_t     overruns;
+  uint32_t     maxLatency;
+  uint32_t     maxRunTime;
+  uint32_t     totalRunTime;
+};
+
+class Scheduler {
+public:
+#if SCHED_HAS_MILLIS
+  explicit Scheduler(SchedulerClock clockFn = defaultClock)
+#else
+  explicit Scheduler(SchedulerClock clockFn)
+#endif
+    : clock(clockFn), taskCount(0), busyTime(0), startTime(0), started(false) {
+    memset(tasks, 0, sizeof(tasks));
+  }
+
+  // Register a periodic task. First run after firstDelay (defaults to one period).
+  int addPeriodic(const char* name, TaskFunction fn, uint32_t period, uint8_t priority, int32_t firstDelay = -1) {
+    return addTask(name, fn, period, priority, firstDelay < 0 ? period : (uint32_t)firstDelay);
+  }
+
+  // Register a task that runs once after delay, then goes inactive.
+  int addOneShot(const char* name, TaskFunction fn, uint32_t delay, uint8_t priority) {
+    return addTask(name, fn, 0, priority, delay);
+  }
+
+  // Move a task's next run to delay from now (re-arms one-shot tasks).
+  // Safe to call from inside the task itself.
+  void runIn(int id, uint32_t delay) {
+    if (id < 0 || id >= taskCount) return;
+    tasks[id].deadline = clock() + delay;
+    tasks[id].active = true;
+    tasks[id].rescheduled = true;
+  }
+
+  void setPeriod(int id, uint32_t period) {
+    if (id < 0 || id >= taskCount) return;
+    tasks[id].period = period;
+  }
+
+  void setActive(int id, bool active) {
+    if (id < 0 || id >= taskCount) return;
+    tasks[id].active = active;
+  }
+
+  // Run all due tasks. Returns clock units until the next deadline
+  // (capped at maxSleep, 0 if something became due while running).
+  uint32_t runDue(uint32_t maxSleep = 1000) {
+    if (!started) {
+      startTime = clock();
+      started = true;
+    }
+
+    int id;
+    while ((id = nextDue()) != SCHED_INVALID) {
+      SchedulerTask& t = tasks[id];
+      uint32_t start = clock();
+      uint32_t latency = start - t.deadline;
+      if (latency > t.maxLatency) t.maxLatency = latency;
+      if (t.period > 0 && latency >= t.period) t.overruns++;
+
+      t.rescheduled = false;
+      t.fn();
+
+      uint32_t end = clock();
+      uint32_t runTime = end - start;
+      t.runs++;
+      t.totalRunTime += runTime;
+      busyTime += runTime;
+      if (runTime > t.maxRunTime) t.maxRunTime = runTime;
+
+      if (!t.rescheduled) {
+        if (t.period == 0) {
+          t.active = false;
+        } else {
+          // Keep phase; skip missed slots rather than bursting to catch up
+          t.deadline += t.period;
+          if ((int32_t)(t.deadline - end) <= 0) t.deadline = end + t.period;
+        }
+      }
+    }
+
+    return timeUntilNext(maxSleep);
+  }
+
+  uint32_t timeUntilNext(uint32_t maxSleep) const {
+    uint32_t now = clock();
+    uint32_t best = maxSleep;
+    for (int i = 0; i < taskCount; i++) {
+      if (!tasks[i].active) continue;
+      int32_t remaining = (int32_t)(tasks[i].deadline - now);
+      if (remaining <= 0) return 0;
+      if ((uint32_t)remaining < best) best = remaining;
+    }
+    return best;
+  }
+
+  // Percentage of wall time spent inside tasks since the first runDue()
+  uint8_t loadPercent() const {
+    uint32_t elapsed = clock() - startTime;
+    if (elapsed == 0) return 0;
+    return (uint8_t)((uint64_t)busyTime * 100 / elapsed);
+  }
+
+  void resetStats() {
+    for (int i = 0; i < taskCount; i++) {
+      tasks[i].runs = tasks[i].overruns = 0;
+      tasks[i].maxLatency = tasks[i].maxRunTime = tasks[i].totalRunTime = 0;
+    }
+    busyTime = 0;
+    startTime = clock();
+  }
+
+  int count() const { return taskCount; }
+  const SchedulerTask& task(int id) const { return tasks[id]; }
+
+private:
+#if SCHED_HAS_MILLIS
+  static uint32_t defaultClock() { return millis(); }
+#endif
+
+  int addTask(const char* name, TaskFunction fn, uint32_t period, uint8_t priority, uint32_t delay) {
+    if (taskCount >= SCHED_MAX_TASKS || fn == nullptr) return SCHED_INVALID;
+    SchedulerTask& t = tasks[taskCount];
+    memset(&t, 0, sizeof(t));
+    t.name = name;
+    t.fn = fn;
+    t.period = period;
+    t.priority = priority;
+    t.deadline = clock() + delay;
+    t.active = true;
+    return taskCount++;
+  }
+
+  // Highest-priority due task, earliest deadline breaks ties
+  int nextDue() const {
+    uint32_t now = clock();
+    int best = SCHED_INVALID;
+    for (int i = 0; i < taskCount; i++) {
+      const SchedulerTask& t = tasks[i];
+      if (!t.active || (int32_t)(t.deadline - now) > 0) continue;
+      if (best == SCHED_INVALID ||
+          t.priority > tasks[best].priority ||
+          (t.priority == tasks[best].priority && (int32_t)(t.deadline - tasks[best].deadline) < 0)) {
+        best = i;
+      }
+    }
+    return best;
+  }
+
+  SchedulerClock clock;
+  SchedulerTask tasks[SCHED_MAX_TASKS];
+  int taskCount;
+  uint32_t busyTime;
+  uint32_t startTime;
+  bool started;
+};
+
+#endif // SCHEDULER_H
@@ -0,0 +1,205 @@
+/*
+ * spectrum.h - Fixed-Point Spectrum Analyser
+ *
+ * Turns ADC samples into 32 bar heights for the 32x16 matrix:
+ * - samples fill one window of SPECTRUM_FFT_SIZE in plain RAM (no DMA on
+ *   the ESP8266 ADC); once it is full further samples are dropped until
+ *   compute() has used it, so the FFT only ever sees one consecutive run
+ * - the window is DC-removed, Hann-windowed and run through an in-place
+ *   radix-2 FFT in Q15 fixed point, scaling by 1/2 per stage so nothing
+ *   can overflow
+ * - the N/2 magnitude bins are grouped into 32 log-spaced columns (at least
+ *   one bin each), converted to a log (~3dB per step) height of 0-16 and
+ *   given a peak-hold dot that falls one row every decay interval
+ *
+ * No hardware access here - the caller samples A0 and feeds pushSample(),
+ * so the maths runs unchanged off-target with synthetic signals.
+ */
+
+#ifndef SPECTRUM_H
+#define SPECTRUM_H
+
+#include <Arduino.h>
+#include <math.h>
+
+#ifndef SPECTRUM_FFT_SIZE
+  #define SPECTRUM_FFT_SIZE  128   // Power of two
+#endif
+#define SPECTRUM_COLUMNS     32
+#define SPECTRUM_HEIGHT      16
+
+// In-place radix-2 decimation-in-time FFT, Q15, output scaled by 1/N.
+// sinTable holds sin(2*pi*k/n) in Q15 for k = 0..3n/4-1 (cos = sin + n/4).
+inline void fftQ15(int16_t* re, int16_t* im, int n, const int16_t* sinTable) {
+  // Bit-reversal permutation
+  for (int i = 1, j = 0; i < n; i++) {
+    int bit = n >> 1;
+    for (; j & bit; bit >>= 1) j ^= bit;
+    j ^= bit;
+    if (i < j) {
+      int16_t t = re[i]; re[i] = re[j]; re[j] = t;
+      t = im[i]; im[i] = im[j]; im[j] = t;
+    }
+  }
+
+  for (int len = 2; len <= n; len <<= 1) {
+    int half = len >> 1;
+    int step = n / len;
+    for (int i = 0; i < n; i += len) {
+      for (int k = 0; k < half; k++) {
+        int32_t wr = sinTable[k * step + n / 4];  // cos
+        int32_t wi = -sinTable[k * step];          // -sin (forward transform)
+        int a = i + k, b = a + half;
+        int32_t tr = (wr * re[b] - wi * im[b]) >> 15;
+        int32_t ti = (wr * im[b] + wi * re[b]) >> 15;
+        re[b] = (re[a] - tr) >> 1;
+        im[b] = (im[a] - ti) >> 1;
+        re[a] = (re[a] + tr) >> 1;
+        im[a] = (im[a] + ti) >> 1;
+      }
+    }
+  }
+}
+
+class SpectrumAnalyzer {
+public:
+  SpectrumAnalyzer() : filled(0), windows(0), noiseFloor(2) {
+    memset(samples, 0, sizeof(samples));
+    memset(peaks, 0, sizeof(peaks));
+  }
+
+  // Tables: twiddles, Hann window, column bin ranges
+  void begin() {
+    const int n = SPECTRUM_FFT_SIZE;
+    for (int k = 0; k < n * 3 / 4; k++) {
+      sinTable[k] = (int16_t)lround(sin(2 * M_PI * k / n) * 32767);
+    }
+    for (int i = 0; i < n; i++) {
+      window[i] = (int16_t)lround((0.5 - 0.5 * cos(2 * M_PI * i / (n - 1))) * 32767);
+    }
+    // Log-spaced edges over bins 1 .. n/2-1, at least one bin per column
+    const int bins = n / 2 - 1;
+    int edge = 1;
+    for (int c = 0; c < SPECTRUM_COLUMNS; c++) {
+      int hi = (int)lround(pow((double)bins, (double)(c + 1) / SPECTRUM_COLUMNS)) + 1;
+      int remaining = SPECTRUM_COLUMNS - 1 - c;
+      if (hi <= edge) hi = edge + 1;
+      if (hi > n / 2 - remaining) hi = n / 2 - remaining;
+      binLo[c] = edge;
+      binHi[c] = hi;
+      edge = hi;
+    }
+  }
+
+  // True when this sample completed the window (stop sampling until
+  // compute()); samples arriving while it is full are dropped
+  bool pushSample(int16_t sample) {
+    int n = filled;
+    if (n >= SPECTRUM_FFT_SIZE) return true;
+    samples[n] = sample;
+    filled = n + 1;
+    return n + 1 == SPECTRUM_FFT_SIZE;
+  }
+
+  bool ready() const { return filled >= SPECTRUM_FFT_SIZE; }
+  uint32_t windowCount() const { return windows; }  // Windows computed
+
+  // Minimum level (bits of magnitude) that lights a bar
+  void setNoiseFloor(uint8_t bits) { noiseFloor = bits; }
+
+  // FFT of the completed window -> bar heights (0-16), then the window is
+  // emptied for the next capture. Also fills magnitudes. Only when ready().
+  void compute(uint8_t* heights) {
+    const int n = SPECTRUM_FFT_SIZE;
+    int16_t re[SPECTRUM_FFT_SIZE], im[SPECTRUM_FFT_SIZE];
+
+    int32_t sum = 0;
+    for (int i = 0; i < n; i++) sum += samples[i];
+    int16_t mean = sum / n;
+
+    // DC removal, scale 10-bit ADC range up into Q15 headroom, window
+    for (int i = 0; i < n; i++) {
+      int32_t v = (int32_t)(samples[i] - mean) << 5;
+      re[i] = (int16_t)((v * window[i]) >> 15);
+      im[i] = 0;
+    }
+    filled = 0;  // Copied out: capture can start again
+    windows++;
+
+    fftQ15(re, im, n, sinTable);
+
+    for (int k = 0; k < n / 2; k++) {
+      uint32_t p = (int32_t)re[k] * re[k] + (int32_t)im[k] * im[k];
+      magnitudes[k] = isqrt(p);
+    }
+
+    for (int c = 0; c < SPECTRUM_COLUMNS; c++) {
+      uint16_t m = 0;
+      for (int k = binLo[c]; k < binHi[c]; k++) {
+        if (magnitudes[k] > m) m = magnitudes[k];
+      }
+      heights[c] = level(m);
+      if (heights[c] > peaks[c]) peaks[c] = heights[c];
+    }
+  }
+
+  // Drop every peak-hold dot by one row (call every decay interval)
+  void decayPeaks() {
+    for (int c = 0; c < SPECTRUM_COLUMNS; c++) {
+      if (peaks[c] > 0) peaks[c]--;
+    }
+  }
+
+  // Bars from the bottom plus peak dots, straight into scr column bytes
+  void draw(const uint8_t* heights, uint8_t* frame, int lineWidth) const {
+    for (int c = 0; c < SPECTRUM_COLUMNS; c++) {
+      uint16_t col = heights[c] ? (uint16_t)(0xFFFF << (SPECTRUM_HEIGHT - heights[c])) : 0;
+      if (peaks[c] > heights[c]) col |= 1 << (SPECTRUM_HEIGHT - peaks[c]);
+      frame[c] = col & 0xFF;
+      frame[c + lineWidth] = col >> 8;
+    }
+  }
+
+  uint16_t magnitude(int bin) const { return magnitudes[bin]; }
+  uint8_t peak(int column) const { return peaks[column]; }
+  uint8_t columnFirstBin(int column) const { return binLo[column]; }
+  uint8_t columnEndBin(int column) const { return binHi[column]; }
+
+private:
+  static uint16_t isqrt(uint32_t v) {
+    uint32_t root = 0, bit = 1UL << 30;
+    while (bit > v) bit >>= 2;
+    while (bit) {
+      if (v >= root + bit) {
+        v -= root + bit;
+        root = (root >> 1) + bit;
+      } else {
+        root >>= 1;
+      }
+      bit >>= 2;
+    }
+    return (uint16_t)root;
+  }
+
+  // Two steps per bit of magnitude (~3dB each), above the noise floor
+  uint8_t level(uint16_t m) const {
+    if (m == 0) return 0;
+    int bits = 32 - __builtin_clz(m);                            // 1..16
+    int half = bits >= 2 ? (m >> (bits - 2)) & 1 : 0;            // Upper or lower half of the octave
+    int h = (bits - noiseFloor) * 2 + half;
+    return h < 0 ? 0 : h > SPECTRUM_HEIGHT ? SPECTRUM_HEIGHT : h;
+  }
+
+  int16_t  samples[SPECTRUM_FFT_SIZE];
+  int      filled;                     // Samples in the current window
+  uint32_t windows;
+  int16_t  sinTable[SPECTRUM_FFT_SIZE * 3 / 4];
+  int16_t  window[SPECTRUM_FFT_SIZE];
+  uint16_t magnitudes[SPECTRUM_FFT_SIZE / 2];
+  uint8_t  binLo[SPECTRUM_COLUMNS];
+  uint8_t  binHi[SPECTRUM_COLUMNS];
+  uint8_t  peaks[SPECTRUM_COLUMNS];
+  uint8_t  noiseFloor;
+};
+
+#endif // SPECTRUM_H
@@ -0,0 +1,159 @@
+/*
+ * spi_calibration.h - Fastest Reliable TFT SPI Clock, Verified by Read-Back
+ *
+ * The right write clock depends on the unit: short wiring runs take more
+ * than the 40MHz default, long leads can corrupt pixels below it. The
+ * calibrator writes test patterns into a small block of the panel at each
+ * candidate clock and reads them back over MISO; reads always run at the
+ * panel's own (slow, safe) read clock, so a mismatch means the write was
+ * corrupted. Every pattern is repeated SPI_CAL_ROUNDS times per clock.
+ *
+ * Candidates are tried in ascending order. The first one is the baseline:
+ * if it doesn't read back clean there is no working read path (MISO not
+ * wired, module without SDO) and nothing is chosen. Otherwise the chosen
+ * clock is the last one before the first failure - a faster clock that
+ * happens to pass above a failing one is not trusted. A clock picked by
+ * hand goes through verify(): the baseline, then that clock.
+ *
+ * Patterns (SPI_CAL_PIXELS each):
+ *   0: 0x0000 / 0xFFFF alternating  - all lines switch together
+ *   1: 0xAAAA / 0x5555 alternating  - MOSI toggles on every clock
+ *   2: walking one bit              - single isolated edges
+ *   3: xorshift pseudo-random       - everything else
+ *
+ * Templated on the panel - TFT_eSPI on the device, a mock that injects
+ * errors off-target. A Panel must provide:
+ *   void     setClock(uint32_t hz);                  // Write clock from now on
+ *   void     writePixels(const uint16_t* px, int n); // Fill the test block
+ *   bool     readPixels(uint16_t* px, int n);        // Read it back (false = can't)
+ *   uint32_t redrawUs();                             // Full matrix redraw at the current clock
+ */
+
+#ifndef SPI_CALIBRATION_H
+#define SPI_CALIBRATION_H
+
+#include <Arduino.h>
+
+#ifndef SPI_CAL_PIXELS
+  #define SPI_CAL_PIXELS 256   // Test block size (512 bytes per buffer)
+#endif
+#ifndef SPI_CAL_ROUNDS
+  #define SPI_CAL_ROUNDS 3     // Passes of every pattern per clock
+#endif
+
+#define SPI_CAL_MAX_CLOCKS 8
+#define SPI_CAL_PATTERNS   4
+#define SPI_CAL_UNVERIFIED 0xFFFFFFFFUL  // verify(): baseline failed, clock not tested
+
+struct SpiClockTrial {
+  uint32_t hz;
+  uint32_t errors;     // Pixels read back wrong
+  uint32_t pixels;     // Pixels compared
+  uint32_t redrawUs;   // Full redraw time, 0 if the clock failed
+};
+
+template <class Panel>
+class SpiCalibrator {
+public:
+  explicit SpiCalibrator(Panel& panel) : panel(panel), trials(0), chosen(0), runs(0), totalMs(0) {}
+
+  // clocks in ascending order, clocks[0] = baseline. Returns the chosen
+  // clock and leaves the panel running at it; 0 if the baseline failed, in
+  // which case the panel is set back to fallbackHz.
+  uint32_t run(const uint32_t* clocks, int n, uint32_t fallbackHz) {
+    uint32_t start = millis();
+    trials = 0;
+    chosen = 0;
+    runs++;
+    if (n > SPI_CAL_MAX_CLOCKS) n = SPI_CAL_MAX_CLOCKS;
+    for (int i = 0; i < n; i++) {
+      SpiClockTrial& t = trial[trials++];
+      t.hz = clocks[i];
+      t.redrawUs = 0;
+      t.errors = test(clocks[i], t.pixels);
+      if (t.errors) break;  // Nothing above the first failure counts
+      t.redrawUs = panel.redrawUs();
+      chosen = clocks[i];
+    }
+    panel.setClock(chosen ? chosen : fallbackHz);
+    totalMs = millis() - start;
+    return chosen;
+  }
+
+  // One clock picked by hand. Returns its pixel errors and leaves the
+  // panel at hz if there were none, at fallbackHz otherwise;
+  // SPI_CAL_UNVERIFIED if baselineHz didn't read back clean either.
+  // Doesn't touch the last run's results.
+  uint32_t verify(uint32_t hz, uint32_t baselineHz, uint32_t fallbackHz) {
+    uint32_t pixels;
+    uint32_t errors = test(baselineHz, pixels) ? SPI_CAL_UNVERIFIED : test(hz, pixels);
+    panel.setClock(errors ? fallbackHz : hz);
+    return errors;
+  }
+
+  uint32_t chosenHz() const { return chosen; }
+  bool baselinePassed() const { return chosen != 0; }
+  int trialCount() const { return trials; }
+  const SpiClockTrial& result(int i) const { return trial[i]; }
+  bool anyFailed() const { return trials && trial[trials - 1].errors; }  // Last run wrote garbage at some clock
+  uint32_t runCount() const { return runs; }
+  uint32_t durationMs() const { return totalMs; }  // Last run
+
+  // Redraw time at the chosen clock, 0 if none
+  uint32_t chosenRedrawUs() const {
+    for (int i = 0; i < trials; i++) {
+      if (trial[i].hz == chosen && trial[i].errors == 0) return trial[i].redrawUs;
+    }
+    return 0;
+  }
+
+private:
+  uint32_t test(uint32_t hz, uint32_t& pixels) {
+    panel.setClock(hz);
+    uint32_t errors = 0;
+    pixels = 0;
+    for (int round = 0; round < SPI_CAL_ROUNDS; round++) {
+      for (int p = 0; p < SPI_CAL_PATTERNS; p++) {
+        fill(p, round);
+        panel.writePixels(out, SPI_CAL_PIXELS);
+        if (!panel.readPixels(in, SPI_CAL_PIXELS)) {
+          errors += SPI_CAL_PIXELS;
+        } else {
+          for (int i = 0; i < SPI_CAL_PIXELS; i++) {
+            if (in[i] != out[i]) errors++;
+          }
+        }
+        pixels += SPI_CAL_PIXELS;
+      }
+    }
+    return errors;
+  }
+
+  void fill(int pattern, int round) {
+    uint32_t rng = 0x2545F491UL + round * 0x9E3779B9UL;
+    for (int i = 0; i < SPI_CAL_PIXELS; i++) {
+      switch (pattern) {
+        case 0: out[i] = ((i + round) & 1) ? 0xFFFF : 0x0000; break;
+        case 1: out[i] = ((i + round) & 1) ? 0x5555 : 0xAAAA; break;
+        case 2: out[i] = 1 << ((i + round) & 15); break;
+        default:  // xorshift32
+          rng ^= rng << 13;
+          rng ^= rng >> 17;
+          rng ^= rng << 5;
+          out[i] = rng >> 8;
+          break;
+      }
+    }
+  }
+
+  Panel& panel;
+  uint16_t out[SPI_CAL_PIXELS];
+  uint16_t in[SPI_CAL_PIXELS];
+  SpiClockTrial trial[SPI_CAL_MAX_CLOCKS];
+  int trials;
+  uint32_t chosen;
+  uint32_t runs;
+  uint32_t totalMs;
+};
+
+#endif // SPI_CALIBRATION_H
@@ -0,0 +1,178 @@
+/*
+ * stopwatch.h - Stopwatch / Countdown Timer and Frame-Rate Meter
+ *
+ * Stopwatch keeps time as an accumulated total plus the start of the
+ * current run, so start/stop/resume never drift and the value is exact
+ * at whatever rate the display samples it. The same class counts down
+ * when given a duration; expiry is reported once through poll().
+ *
+ * FrameRateMeter records when each frame of a fixed-rate render loop
+ * actually started and how long it took, and reports per one-second
+ * window: achieved rate, min/max frame interval and RMS jitter (deviation
+ * of the interval from the target period).
+ *
+ * Both take the time as an argument, so they run unchanged off-target.
+ */
+
+#ifndef STOPWATCH_H
+#define STOPWATCH_H
+
+#include <Arduino.h>
+
+class Stopwatch {
+public:
+  Stopwatch() : duration(0), accumulated(0), startMs(0), running(false), expired(false) {}
+
+  // 0 = count up; otherwise count down from durationMs. Stops and resets.
+  void setDuration(uint32_t durationMs) {
+    duration = durationMs;
+    reset();
+  }
+
+  void start(uint32_t nowMs) {
+    if (running || expired) return;
+    startMs = nowMs;
+    running = true;
+  }
+
+  void stop(uint32_t nowMs) {
+    if (!running) return;
+    accumulated += nowMs - startMs;
+    running = false;
+  }
+
+  void toggle(uint32_t nowMs) {
+    if (running) stop(nowMs);
+    else start(nowMs);
+  }
+
+  void reset() {
+    accumulated = 0;
+    running = false;
+    expired = false;
+  }
+
+  uint32_t elapsed(uint32_t nowMs) const {
+    return accumulated + (running ? nowMs - startMs : 0);
+  }
+
+  // Time to show: elapsed, or remaining (floored at 0) for a countdown
+  uint32_t value(uint32_t nowMs) const {
+    if (duration == 0) return elapsed(nowMs);
+    uint32_t e = elapsed(nowMs);
+    return e >= duration ? 0 : duration - e;
+  }
+
+  // True once, when a countdown reaches zero; it then stops until reset()
+  bool poll(uint32_t nowMs) {
+    if (duration == 0 || !running || elapsed(nowMs) < duration) return false;
+    accumulated = duration;
+    running = false;
+    expired = true;
+    return true;
+  }
+
+  bool isCountdown() const { return duration != 0; }
+  bool isRunning() const { return running; }
+  bool isExpired() const { return expired; }
+  uint32_t durationMs() const { return duration; }
+
+private:
+  uint32_t duration;
+  uint32_t accumulated;
+  uint32_t startMs;
+  bool running;
+  bool expired;
+};
+
+class FrameRateMeter {
+public:
+  FrameRateMeter() { reset(0); }
+
+  void reset(uint32_t targetPeriodUs) {
+    targetUs = targetPeriodUs;
+    frames = 0;
+    windowIntervals = 0;
+    windowSumSq = 0;
+    windowMin = UINT32_MAX;
+    windowMax = 0;
+    rateX10 = 0;
+    jitter = 0;
+    minInterval = maxInterval = 0;
+    renderMax = 0;
+    renderTotal = 0;
+  }
+
+  void frame(uint32_t startUs, uint32_t renderUs) {
+    if (frames == 0) {
+      windowStart = startUs;
+    } else {
+      uint32_t dt = startUs - lastStart;
+      int32_t dev = (int32_t)(dt - targetUs);
+      windowSumSq += (uint64_t)((int64_t)dev * dev);
+      windowIntervals++;
+      if (dt < windowMin) windowMin = dt;
+      if (dt > windowMax) windowMax = dt;
+    }
+    lastStart = startUs;
+    frames++;
+    renderTotal += renderUs;
+    if (renderUs > renderMax) renderMax = renderUs;
+
+    uint32_t span = startUs - windowStart;
+    if (span >= 1000000UL && windowIntervals > 0) {
+      rateX10 = (uint32_t)((uint64_t)windowIntervals * 10000000ULL / span);
+      jitter = isqrt64(windowSumSq / windowIntervals);
+      minInterval = windowMin;
+      maxInterval = windowMax;
+      windowStart = startUs;
+      windowIntervals = 0;
+      windowSumSq = 0;
+      windowMin = UINT32_MAX;
+      windowMax = 0;
+    }
+  }
+
+  // Last complete one-second window
+  uint32_t rateHzX10() const { return rateX10; }
+  uint32_t jitterUs() const { return jitter; }
+  uint32_t minIntervalUs() const { return minInterval; }
+  uint32_t maxIntervalUs() const { return maxInterval; }
+
+  // Since reset()
+  uint32_t frameCount() const { return frames; }
+  uint32_t maxRenderUs() const { return renderMax; }
+  uint32_t avgRenderUs() const { return frames ? (uint32_t)(renderTotal / frames) : 0; }
+  uint32_t targetPeriodUs() const { return targetUs; }
+
+private:
+  static uint32_t isqrt64(uint64_t v) {
+    uint64_t root = 0, bit = 1ULL << 62;
+    while (bit > v) bit >>= 2;
+    while (bit) {
+      if (v >= root + bit) {
+        v -= root + bit;
+        root = (root >> 1) + bit;
+      } else {
+        root >>= 1;
+      }
+      bit >>= 2;
+    }
+    return (uint32_t)root;
+  }
+
+  uint32_t targetUs;
+  uint32_t frames;
+  uint32_t lastStart;
+  uint32_t windowStart;
+  uint32_t windowIntervals;
+  uint64_t windowSumSq;
+  uint32_t windowMin, windowMax;
+  uint32_t rateX10;
+  uint32_t jitter;
+  uint32_t minInterval, maxInterval;
+  uint32_t renderMax;
+  uint64_t renderTotal;
+};
+
+#endif // STOPWATCH_H
@@ -0,0 +1,213 @@
+/*
+ * telemetry_queue.h - Batched Telemetry with a Bounded Offline Ring
+ *
+ * Samples (sensor readings plus a few health values, 20 bytes each) are
+ * pushed into a fixed ring. The publisher takes the oldest samples as one
+ * compact JSON batch, hands it to the transport and keeps it "in flight"
+ * until the broker acknowledges it; only then are those samples removed.
+ * A lost connection or a missing ack puts the batch back, so nothing is
+ * dropped while the broker is away - until the ring is full, when the
+ * oldest sample is overwritten and counted.
+ *
+ * Each sample carries a sequence number, so an overwrite that hits a
+ * batch still in flight is accounted for correctly on ack.
+ *
+ * Batch layout (one row per sample, dt = seconds after t0, null = no value):
+ *   {"id":"retroclock-1a2b3c","t0":1760700000,"dropped":0,
+ *    "cols":["dt","temp","hum","pres","ntp_age","heap","rssi","load"],
+ *    "rows":[[0,21,41,1013,35,41200,-61,3],[10,21,41,1013,45,41184,-60,2]]}
+ *
+ * RetryBackoff spaces out connection attempts: doubling from min to max,
+ * plus up to 25% jitter so a fleet doesn't reconnect in lockstep.
+ *
+ * No transport or clock calls - runs unchanged off-target.
+ */
+
+#ifndef TELEMETRY_QUEUE_H
+#define TELEMETRY_QUEUE_H
+
+#include <Arduino.h>
+
+#ifndef TELEMETRY_QUEUE_SIZE
+  #define TELEMETRY_QUEUE_SIZE 128   // Samples kept while offline
+#endif
+#ifndef TELEMETRY_BATCH_MAX
+  #define TELEMETRY_BATCH_MAX  20    // Samples per published batch at most
+#endif
+
+#define TELEMETRY_NO_VALUE   INT16_MIN  // Sensor value missing
+#define TELEMETRY_NEVER      0xFFFFFFFFUL
+
+struct TelemetrySample {
+  uint32_t time;      // UTC seconds
+  uint32_t ntpAge;    // Seconds since the last NTP sync, TELEMETRY_NEVER if none
+  uint32_t heap;      // Free heap, bytes
+  int16_t  temp;      // °C
+  int16_t  hum;       // %
+  int16_t  pres;      // hPa
+  int8_t   rssi;      // dBm
+  uint8_t  load;      // Scheduler load, %
+};
+
+class TelemetryQueue {
+public:
+  TelemetryQueue() : first(0), count(0), dropped(0), inFlightEnd(0), inFlightId(0), inFlight(false),
+                     sentMs(0), batches(0), samplesOut(0), requeued(0),
+                     lastLatency(0), maxLatency(0), totalLatency(0) {}
+
+  // Newest sample; overwrites the oldest when full
+  void push(const TelemetrySample& s) {
+    if (count == TELEMETRY_QUEUE_SIZE) {
+      first++;
+      count--;
+      dropped++;
+    }
+    ring[(first + count) % TELEMETRY_QUEUE_SIZE] = s;
+    count++;
+  }
+
+  // Encode the oldest samples into buf and mark them in flight. Returns the
+  // payload length, 0 if a batch is already in flight or nothing is queued.
+  size_t takeBatch(char* buf, size_t size, const char* deviceId, uint32_t nowMs) {
+    if (inFlight || count == 0) return 0;
+    const TelemetrySample& head = at(0);
+    int n = snprintf(buf, size,
+                     "{\"id\":\"%s\",\"t0\":%u,\"dropped\":%u,"
+                     "\"cols\":[\"dt\",\"temp\",\"hum\",\"pres\",\"ntp_age\",\"heap\",\"rssi\",\"load\"],\"rows\":[",
+                     deviceId, (unsigned)head.time, (unsigned)dropped);
+    if (n < 0 || (size_t)n >= size) return 0;
+    size_t len = n;
+    uint32_t taken = 0;
+    while (taken < count && taken < TELEMETRY_BATCH_MAX) {
+      const TelemetrySample& s = at(taken);
+      char t[8], h[8], p[8], age[12];
+      value(t, sizeof(t), s.temp);
+      value(h, sizeof(h), s.hum);
+      value(p, sizeof(p), s.pres);
+      if (s.ntpAge == TELEMETRY_NEVER) strcpy(age, "null");
+      else snprintf(age, sizeof(age), "%u", (unsigned)s.ntpAge);
+      n = snprintf(buf + len, size - len, "%s[%u,%s,%s,%s,%s,%u,%d,%u]",
+                   taken ? "," : "", (unsigned)(s.time - head.time), t, h, p, age,
+                   (unsigned)s.heap, s.rssi, s.load);
+      if (n < 0 || len + n + 3 > size) break;  // Keep room for "]}"
+      len += n;
+      taken++;
+    }
+    if (taken == 0) return 0;
+    len += snprintf(buf + len, size - len, "]}");
+    inFlight = true;
+    inFlightId = 0;
+    inFlightEnd = first + taken;
+    sentMs = nowMs;
+    return len;
+  }
+
+  // Transport accepted the batch under packetId (0 = not accepted, retry later)
+  void sent(uint16_t packetId) {
+    if (!inFlight) return;
+    if (packetId == 0) {
+      inFlight = false;
+      return;
+    }
+    inFlightId = packetId;
+  }
+
+  // Broker acknowledged packetId: drop the batch's samples, time the round trip
+  bool acked(uint16_t packetId, uint32_t nowMs) {
+    if (!inFlight || packetId != inFlightId) return false;
+    uint32_t n = 0;
+    while (count > 0 && (int32_t)(inFlightEnd - first) > 0) {
+      first++;
+      count--;
+      n++;
+    }
+    inFlight = false;
+    batches++;
+    samplesOut += n;
+    lastLatency = nowMs - sentMs;
+    if (lastLatency > maxLatency) maxLatency = lastLatency;
+    totalLatency += lastLatency;
+    return true;
+  }
+
+  // Connection lost or no ack in time: the samples stay queued for the next batch
+  void requeue() {
+    if (!inFlight) return;
+    inFlight = false;
+    requeued++;
+  }
+
+  bool busy() const { return inFlight; }
+  bool ackOverdue(uint32_t nowMs, uint32_t timeoutMs) const {
+    return inFlight && nowMs - sentMs >= timeoutMs;
+  }
+
+  uint32_t queued() const { return count; }
+  uint32_t capacity() const { return TELEMETRY_QUEUE_SIZE; }
+  uint32_t droppedCount() const { return dropped; }
+  uint32_t batchCount() const { return batches; }
+  uint32_t samplesPublished() const { return samplesOut; }
+  uint32_t requeueCount() const { return requeued; }
+
+  // Publish-to-ack latency, ms
+  uint32_t lastLatencyMs() const { return lastLatency; }
+  uint32_t maxLatencyMs() const { return maxLatency; }
+  uint32_t avgLatencyMs() const { return batches ? totalLatency / batches : 0; }
+
+private:
+  const TelemetrySample& at(uint32_t i) const { return ring[(first + i) % TELEMETRY_QUEUE_SIZE]; }
+
+  static void value(char* out, size_t size, int16_t v) {
+    if (v == TELEMETRY_NO_VALUE) strcpy(out, "null");
+    else snprintf(out, size, "%d", v);
+  }
+
+  TelemetrySample ring[TELEMETRY_QUEUE_SIZE];
+  uint32_t first;        // Sequence number of the oldest sample
+  uint32_t count;
+  uint32_t dropped;
+  uint32_t inFlightEnd;  // Sequence number just past the batch in flight
+  uint16_t inFlightId;
+  bool     inFlight;
+  uint32_t sentMs;
+  uint32_t batches, samplesOut, requeued;
+  uint32_t lastLatency, maxLatency, totalLatency;
+};
+
+class RetryBackoff {
+public:
+  RetryBackoff(uint32_t minMs, uint32_t maxMs)
+    : minDelay(minMs), maxDelay(maxMs), delay(0), nextMs(0), rng(0x9E3779B9UL), attempts(0) {}
+
+  void seed(uint32_t s) { if (s) rng = s; }
+
+  // Time for another attempt? (always true until the first failure)
+  bool due(uint32_t nowMs) const { return delay == 0 || (int32_t)(nowMs - nextMs) >= 0; }
+
+  void failed(uint32_t nowMs) {
+    attempts++;
+    delay = delay == 0 ? minDelay : (delay >= maxDelay / 2 ? maxDelay : delay * 2);
+    nextMs = nowMs + delay + next() % (delay / 4 + 1);
+  }
+
+  void succeeded() {
+    delay = 0;
+    attempts = 0;
+  }
+
+  uint32_t currentMs() const { return delay; }        // 0 = not backing off
+  uint32_t failures() const { return attempts; }      // Since the last success
+  uint32_t waitMs(uint32_t nowMs) const { return due(nowMs) ? 0 : nextMs - nowMs; }
+
+private:
+  uint32_t next() {  // xorshift32
+    rng ^= rng << 13;
+    rng ^= rng >> 17;
+    rng ^= rng << 5;
+    return rng;
+  }
+
+  uint32_t minDelay, maxDelay, delay, nextMs, rng, attempts;
+};
+
+#endif // TELEMETRY_QUEUE_H
@@ -0,0 +1,134 @@
+/*
+ * trace_recorder.h - Chrome Trace Event Recorder
+ *
+ * Records timed scopes (rendering, HTTP handlers, sensor reads, NTP) into a
+ * fixed ring and exports them as Chrome Trace Event JSON, viewable in
+ * chrome://tracing or https://ui.perfetto.dev. Each scope is stored as one
+ * complete ("ph":"X") event - begin timestamp plus duration in microseconds -
+ * so a wrapped ring never leaves an unmatched begin or end behind.
+ *
+ * Compile-time optional: with TRACE_ENABLED 0 (default) TRACE_SCOPE()
+ * expands to nothing. Names must outlive the ring (literals, URI strings
+ * registered with the web server).
+ *
+ * Host builds use the same macros and add writeJson(path), with process
+ * name "host" instead of "esp8266", so a simulated timeline and one from a
+ * real unit can be loaded side by side.
+ *
+ * Usage:
+ *   void refreshAll() { TRACE_SCOPE("refreshAll"); ... }
+ */
+
+#ifndef TRACE_RECORDER_H
+#define TRACE_RECORDER_H
+
+#include <Arduino.h>
+
+#ifndef TRACE_ENABLED
+  #define TRACE_ENABLED 0
+#endif
+
+#ifndef TRACE_RING_SIZE
+  #define TRACE_RING_SIZE 256  // 12 bytes each
+#endif
+
+struct TraceEvent {
+  const char* name;
+  uint32_t    startUs;
+  uint32_t    durUs;
+};
+
+class TraceRecorder {
+public:
+  TraceRecorder() : head(0), total(0) {}
+
+  void record(const char* name, uint32_t startUs, uint32_t durUs) {
+    TraceEvent& e = ring[head];
+    e.name = name;
+    e.startUs = startUs;
+    e.durUs = durUs;
+    head = (head + 1) % TRACE_RING_SIZE;
+    total++;
+  }
+
+  void clear() { head = 0; total = 0; }
+
+  int count() const { return total < TRACE_RING_SIZE ? total : TRACE_RING_SIZE; }
+  uint32_t totalEvents() const { return total; }
+
+  // i = 0 is the oldest event still in the ring
+  const TraceEvent& event(int i) const {
+    return ring[(total - count() + i) % TRACE_RING_SIZE];
+  }
+
+  // Chrome Trace Event JSON. Out needs write(const uint8_t*, size_t) - any Print works.
+  template <class Out>
+  void writeJson(Out& out) const {
+    char buf[128];
+    int len = snprintf(buf, sizeof(buf),
+                       "{\"traceEvents\":[{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":1,\"tid\":1,"
+                       "\"args\":{\"name\":\"%s\"}}", processName());
+    out.write((const uint8_t*)buf, len);
+    for (int i = 0; i < count(); i++) {
+      const TraceEvent& e = event(i);
+      len = snprintf(buf, sizeof(buf),
+                     ",\n{\"name\":\"%s\",\"ph\":\"X\",\"ts\":%lu,\"dur\":%lu,\"pid\":1,\"tid\":1}",
+                     e.name, (unsigned long)e.startUs, (unsigned long)e.durUs);
+      out.write((const uint8_t*)buf, len);
+    }
+    len = snprintf(buf, sizeof(buf), "],\"displayTimeUnit\":\"ms\",\"otherData\":{\"total_events\":%lu}}\n",
+                   (unsigned long)total);
+    out.write((const uint8_t*)buf, len);
+  }
+
+#ifndef ARDUINO
+  // Host builds: write straight to a file
+  bool writeJson(const char* path) const {
+    FILE* f = fopen(path, "wb");
+    if (f == nullptr) return false;
+    struct FileOut {
+      FILE* f;
+      size_t write(const uint8_t* data, size_t len) { return fwrite(data, 1, len, f); }
+    } out = {f};
+    writeJson(out);
+    fclose(f);
+    return true;
+  }
+#endif
+
+private:
+  static const char* processName() {
+  #ifdef ARDUINO
+    return "esp8266";
+  #else
+    return "host";
+  #endif
+  }
+
+  TraceEvent ring[TRACE_RING_SIZE];
+  uint32_t head;
+  uint32_t total;
+};
+
+// Records the enclosing scope as one complete event
+class TraceScope {
+public:
+  TraceScope(TraceRecorder& recorder, const char* name) : recorder(recorder), name(name), start(micros()) {}
+  ~TraceScope() { recorder.record(name, start, micros() - start); }
+
+private:
+  TraceRecorder& recorder;
+  const char* name;
+  uint32_t start;
+};
+
+#if TRACE_ENABLED
+  // Expects a global TraceRecorder named traceRecorder
+  #define TRACE_CONCAT_(a, b) a##b
+  #define TRACE_CONCAT(a, b) TRACE_CONCAT_(a, b)
+  #define TRACE_SCOPE(name) TraceScope TRACE_CONCAT(traceScope_, __LINE__)(traceRecorder, name)
+#else
+  #define TRACE_SCOPE(name) do {} while (0)
+#endif
+
+#endif // TRACE_RECORDER_H
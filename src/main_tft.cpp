@@ -44,7 +44,6 @@
  *
  * =========================== TODO ==========================
  * - Get weather from online API and display on matrix and webpage
- * - Add OTA firmware update capability
  * - add mew display modes, like morphing (from @cbmamiga) 
  * - refactor code for ESP32 compatibility and use of the CYD display - https://github.com/witnessmenow/ESP32-Cheap-Yellow-Display
  * - Update Readme.md with sample screenshots of new web interface and TFT display
@@ -66,12 +65,18 @@
 // ======================== LIBRARIES ========================
 #include <ESP8266WiFi.h>
 #include <ESP8266WebServer.h>
+#include <WiFiUdp.h>
 #include <WiFiManager.h>
+#include <EEPROM.h>
 #include <Wire.h>
 #include <Adafruit_BME280.h>
 #include <time.h>
 #include <TZ.h>
+#include <sys/time.h>
+#include <coredecls.h>  // settimeofday_cb() for NTP sync notification
 #include <TFT_eSPI.h>  // Hardware-specific library with optimized performance
+#include <SPI.h>       // SPI.setFrequency() for the calibrated TFT clock
+#include <Updater.h>   // Flash writer for OTA (ESP8266 core)
 
 // ======================== VERSION ========================
 const char* VERSION = "1.2.0";
@@ -125,15 +130,149 @@ const char* VERSION = "1.2.0";
 // ======================== TIMING CONFIGURATION ========================
 #define SENSOR_UPDATE_INTERVAL       60000  // Update sensor every 60s
 #define NTP_SYNC_INTERVAL            3600000 // Sync NTP every hour
+#define NTP_SYNC_TIMEOUT             10000  // A sync with no reply this long after syncNTP() counts as failed
 #define STATUS_PRINT_INTERVAL        10000  // Print status every 10s
+#define HTTP_POLL_INTERVAL           10     // Service web clients every 10ms
+#define SCHED_MAX_SLEEP              50     // Upper bound on loop() sleep between deadlines
+#define STALL_THRESHOLD_US           100000 // Loop iterations longer than 100ms are logged as stalls
+#define ANIMATION_INTERVAL           40     // Frame tick for animated modes (Life, spectrum): 25fps
 
 // ======================== DEBUG CONFIGURATION ========================
 #define DEBUG_ENABLED 1
+#ifndef TRACE_ENABLED
+  #define TRACE_ENABLED 0  // 1 = record timed scopes for /api/trace (Chrome Trace JSON, ~3KB RAM)
+#endif
+
+// ======================== METRICS CONFIGURATION ========================
+#define METRICS_ENABLED      1     // Prometheus text format at /metrics (include/metrics_writer.h)
+#define METRICS_BUFFER_SIZE  1460  // Static buffer, sent as one HTTP chunk (one TCP segment) when full
+
+// ======================== OTA UPDATE CONFIGURATION ========================
+#define OTA_ENABLED            1     // POST /update streams firmware to flash (include/ota_stream.h)
+#define OTA_CHUNK_SIZE         1024  // Bytes staged per flash write
+#define OTA_PROGRESS_INTERVAL  250   // ms between progress redraws during an upload
+#define OTA_BAR_HEIGHT         3     // Progress bar along the bottom edge, px
+#define OTA_USERNAME           "admin"
+#define OTA_PASSWORD           ""    // HTTP basic auth for /update - uploads are refused while empty
+
+// ======================== MQTT TELEMETRY CONFIGURATION ========================
+// Batched sensor + health samples to an MQTT broker (include/telemetry_queue.h)
+#define MQTT_ENABLED           0                 // 1 = publish telemetry (needs a broker)
+#define MQTT_HOST              "192.168.1.10"    // Broker address or hostname
+#define MQTT_PORT              1883
+#define MQTT_USER              ""                // Empty = no credentials
+#define MQTT_PASSWORD          ""
+#define MQTT_TOPIC_PREFIX      "retroclock"      // <prefix>/<chip id>/telemetry and /status
+#define MQTT_SAMPLE_INTERVAL   10000             // ms between samples
+#define MQTT_BATCH_INTERVAL    60000             // ms between batches while caught up
+#define MQTT_SERVICE_INTERVAL  100               // ms between connect/publish steps
+#define MQTT_CONNECT_TIMEOUT   10000             // Give up on a connect attempt after this
+#define MQTT_ACK_TIMEOUT       10000             // Republish a batch not acked within this
+#define MQTT_BACKOFF_MIN       2000              // Reconnect delay, doubling up to MQTT_BACKOFF_MAX
+#define MQTT_BACKOFF_MAX       120000
+#define MQTT_PAYLOAD_SIZE      1024              // One batch, JSON
+#define TELEMETRY_QUEUE_SIZE   128               // Samples held while the broker is away (~21 min, 2.5KB)
+#define TELEMETRY_BATCH_MAX    20                // Samples per batch at most
 
 // ======================== DISPLAY OPTIMIZATION ========================
 #define BRIGHTNESS_BOOST 1  // Set to 1 for maximum brightness (ignores brightness level)
 #define FAST_REFRESH 1      // Set to 1 to only redraw changed pixels (much faster)
 
+// ======================== DISPLAY SINK CONFIGURATION ========================
+// The TFT is always driven. Optional extra outputs for the same frame:
+#define MAX7219_SINK_ENABLED 0   // 1 = also drive a real MAX7219 chain on hardware SPI
+#define MAX7219_CS_PIN       D0  // LOAD/CS for the MAX7219 chain
+#define MAX7219_INTENSITY    8   // 0-15
+// Build with -DHEADLESS_FRAMEBUFFER to mirror frames into a RAM framebuffer
+// (include/framebuffer_sink.h) for off-target rendering tests
+
+// ======================== EXTERNAL FRAME INPUT CONFIGURATION ========================
+#define FRAME_INPUT_ENABLED  1     // Accept scr[] frames over UDP (include/frame_input.h)
+#define FRAME_UDP_PORT       4211
+#define FRAME_POLL_INTERVAL  5     // ms between socket polls (200Hz, comfortably above 30fps senders)
+#define FRAME_INPUT_TIMEOUT  2000  // Fall back to the clock after 2s without packets
+#define MAX7219_EMU_ENABLED  1     // Accept MAX7219 register streams (include/max7219_decoder.h)
+#define MAX7219_EMU_UDP_PORT 4212
+#define MAX7219_EMU_SERIAL   1     // Also decode the stream from Serial RX
+#define MAX7219_EMU_TIMEOUT  5000  // Fall back to the clock after 5s without packets
+#define MDMAX_SHIM_ENABLED   0     // 1 = MD_MAX72xx-style 'mx'/'mxBottom' objects for ported sketches
+
+// ======================== ANALOG CLOCK CONFIGURATION ========================
+#define ANALOG_MODE_ENABLED 1         // 15x15 dial mode in the rotation (include/analog_clock.h, ~3.6KB hand cache)
+
+// ======================== STOPWATCH / COUNTDOWN CONFIGURATION ========================
+#define TIMER_MODES_ENABLED      1    // Stopwatch + countdown modes (include/stopwatch.h), selected from web UI/API only
+#define TIMER_REFRESH_HZ         50   // Frame rate while a timer is on screen (10-100, changeable at runtime)
+#define TIMER_PRECISION          2    // Fraction digits: 1 = tenths, 2 = hundredths
+#define TIMER_DEFAULT_COUNTDOWN  300  // Seconds, until set from the web UI/API
+#define TIMER_UDP_PORT           4213 // Text commands: "start", "stop", "countdown 90", ...
+#define TIMER_CONTROL_INTERVAL   20   // ms between UDP command polls / countdown expiry checks
+
+// ======================== MARQUEE CONFIGURATION ========================
+#define MARQUEE_ENABLED       1     // Two-line scrolling ticker mode, selected from the API only
+#define MARQUEE_STEP_MS       50    // ms per LED column (20 columns/s)
+#define MARQUEE_HW_SCROLL     1     // Pan with the panel's scroll registers where supported (include/hw_scroll.h)
+#define HW_SCROLL_REVERSED    1     // 1 for setRotation(3), 0 for setRotation(1)
+#define MARQUEE_MAX_TEXT      64    // Characters per line
+
+// ======================== SPI CLOCK CALIBRATION CONFIGURATION ========================
+// Per-unit TFT write clock, verified by reading test patterns back over MISO
+// (include/spi_calibration.h). Needs the module's SDO pin wired to D6.
+#define SPI_CAL_ENABLED       1
+#define SPI_CAL_AT_BOOT       1     // Calibrate on a cold boot while no clock is stored
+#define SPI_CAL_CLOCKS        16000000, 20000000, 26666667, 40000000, 80000000  // Ascending, first = baseline (ESP8266: 80MHz / n)
+#define SPI_CAL_BLOCK_WIDTH   32    // Test block in the top-left corner, px
+#define SPI_CAL_PIXELS        256   // 32x8 block
+#define SPI_CAL_ROUNDS        3     // Passes of every pattern per clock
+
+// ======================== ALARM CONFIGURATION ========================
+#define ALARMS_ENABLED        1     // Alarms + recurring schedules (include/alarm_schedule.h), kept in EEPROM
+#define ALARM_FLASH_SECONDS   30    // Default flash length for a "flash" alarm
+#define ALARM_FLASH_INTERVAL  250   // ms per flash phase (normal / inverted)
+
+// ======================== FLEET PHASE SYNC CONFIGURATION ========================
+// Line up second edges / colon blinks of many clocks on one LAN (include/phase_sync.h)
+#define FLEET_SYNC_ENABLED    1
+#define FLEET_SYNC_ROLE       0                  // 0 = off, 1 = leader, 2 = follower (changeable via /api/fleet)
+#define FLEET_SYNC_GROUP      239, 255, 42, 99   // Multicast group for the beacons
+#define FLEET_SYNC_PORT       4214
+#define FLEET_POLL_INTERVAL   2                  // ms between follower beacon polls (bounds receive jitter)
+
+// ======================== LIFE SCREENSAVER CONFIGURATION ========================
+#define LIFE_MODE_ENABLED   1         // Conway's Life mode in the rotation (include/life_automaton.h)
+#define LIFE_RULE           "B3/S23"  // Any B/S rule, e.g. "B36/S23" HighLife, "B2/S" Seeds
+#define LIFE_DWELL          15000     // ms on screen before the rotation moves on
+
+// ======================== SPECTRUM ANALYSER CONFIGURATION ========================
+#define SPECTRUM_MODE_ENABLED   0     // 1 = spectrum mode in the rotation (needs an audio front end on A0)
+#define SPECTRUM_SAMPLE_RATE    8000  // Hz; 128-sample window = 16ms burst per frame, 62.5Hz per bin
+#define SPECTRUM_NOISE_FLOOR    2     // Magnitude bits ignored (raise if bars flicker on silence)
+#define SPECTRUM_PEAK_DECAY_MS  80    // Peak-hold dot falls one row per interval
+#define SPECTRUM_DWELL          15000
+
+// ======================== INFO PANEL CONFIGURATION ========================
+// Text strip in the bands above/below the matrix (include/info_panel.h)
+#define INFO_PANEL_ENABLED      1
+#define INFO_PANEL_COLOR        COLOR_DARK_GRAY
+#define INFO_PANEL_FONT         2       // TFT_eSPI built-in font (16px)
+#define INFO_PANEL_INTERVAL     500     // ms between checks for changed values
+#define INFO_PANEL_BUDGET_US    4000    // Max drawing time per check; the rest waits for the next one
+#define SENSOR_TREND_SAMPLES    10      // Trend = change over the last 10 readings (10 min)
+
+// ======================== DISPLAY SELF-TEST CONFIGURATION ========================
+#define DISPLAY_SELFTEST              1       // /api/selftest golden-frame + render-cost check
+#define SELFTEST_BUDGET_DEFAULT_US    40000   // Max full redraw, Default style (~20ms typical)
+#define SELFTEST_BUDGET_REALISTIC_US  500000  // Max full redraw, Realistic style (~300-400ms typical)
+
+// ======================== SCHEDULER TASK TABLE ========================
+// One slot per task setup() registers with the enabled features, so turning
+// a feature on can't overflow the table (include/scheduler.h)
+#define SCHED_MAX_TASKS (6 /* display, http, sensor, ntp, ntp timeout, status */ \
+                         + FRAME_INPUT_ENABLED + MAX7219_EMU_ENABLED + MDMAX_SHIM_ENABLED \
+                         + ((LIFE_MODE_ENABLED || SPECTRUM_MODE_ENABLED) ? 1 : 0) \
+                         + 2 * TIMER_MODES_ENABLED + MARQUEE_ENABLED + ALARMS_ENABLED \
+                         + FLEET_SYNC_ENABLED + 2 * MQTT_ENABLED + INFO_PANEL_ENABLED)
+
 #if DEBUG_ENABLED
   #define DEBUG(x) x
 #else
@@ -157,12 +296,40 @@ Adafruit_BME280 bme280;
 // ======================== FONT INCLUDES ========================
 #include "fonts.h"
 #include "timezones.h"
+#include "scheduler.h"
+#include "display_sink.h"
+#include "max7219_sink.h"
+#include "framebuffer_sink.h"
+#include "golden_frames.h"
+#include "mem_stats.h"
+#include "latency_stats.h"
+#include "event_log.h"
+#include "trace_recorder.h"
+#include "frame_input.h"
+#include "max7219_decoder.h"
+#include "md_max72xx_shim.h"
+#include "analog_clock.h"
+#include "stopwatch.h"
+#include "life_automaton.h"
+#include "spectrum.h"
+#include "info_panel.h"
+#include "alarm_schedule.h"
+#include "phase_sync.h"
+#include "metrics_writer.h"
+#include "ota_stream.h"
+#include "telemetry_queue.h"
+#include "hw_scroll.h"
+#include "spi_calibration.h"
+#if MQTT_ENABLED
+  #include <AsyncMqttClient.h>  // Non-blocking MQTT client (telemetry)
+#endif
 
 // ======================== TIME VARIABLES ========================
 int hours = 0, minutes = 0, seconds = 0;
 int hours24 = 0;  // 24-hour format
 int day = 1, month = 1, year = 2025;
 int lastSecond = -1;
+int lastMinute = -1;
 bool use24HourFormat = false;  // Default to 12-hour format
 
 // ======================== SENSOR VARIABLES ========================
@@ -171,11 +338,122 @@ int temperature = 0;
 int humidity = 0;
 int pressure = 0;
 bool useFahrenheit = false;
+uint32_t sensorReads = 0;
+uint32_t sensorErrors = 0;        // Readings with a missing/out-of-range value
+
+// ======================== TASK SCHEDULER ========================
+// loop() timing is handled by the scheduler in include/scheduler.h
+Scheduler scheduler;
+int taskDisplay = SCHED_INVALID;
+int taskHttp = SCHED_INVALID;
+int taskSensor = SCHED_INVALID;
+int taskNTP = SCHED_INVALID;
+int taskNTPTimeout = SCHED_INVALID;
+int taskStatus = SCHED_INVALID;
+int taskFrameInput = SCHED_INVALID;
+int taskMax7219Emu = SCHED_INVALID;
+int taskMdMax = SCHED_INVALID;
+int taskAnimation = SCHED_INVALID;
+int taskInfoPanel = SCHED_INVALID;
+int taskTimer = SCHED_INVALID;
+int taskTimerControl = SCHED_INVALID;
+int taskAlarmFlash = SCHED_INVALID;
+int taskFleetSync = SCHED_INVALID;
+int taskTelemetry = SCHED_INVALID;
+int taskMarquee = SCHED_INVALID;
+int taskMqtt = SCHED_INVALID;
+
+// ======================== MEMORY INSTRUMENTATION ========================
+// Heap sampled around HTTP handlers, NTP sync and redraws (include/mem_stats.h)
+MemStats memStats;
+int memSiteNTP = memStats.addSite("ntp");
+int memSiteRedraw = memStats.addSite("redraw");
+
+// ======================== LATENCY INSTRUMENTATION ========================
+// Log-scale histograms of loop iterations and major calls (include/latency_stats.h)
+LatencyMonitor latency(STALL_THRESHOLD_US);
+int latHandleClient = latency.addSite("handleClient");
+int latUpdateTime = latency.addSite("updateTime");
+int latRefreshAll = latency.addSite("refreshAll");
+int latSensor = latency.addSite("updateSensorData");
+int latNTP = latency.addSite("syncNTP");
+
+// ======================== EVENT LOG ========================
+// Runtime messages go to a RAM ring (include/event_log.h) and are written to
+// Serial from loop() idle time, so logging never blocks the tick path
+EventLog eventLog;
+
+// ======================== TRACE RECORDER ========================
+// Timeline of rendering, HTTP, sensor and NTP scopes (include/trace_recorder.h)
+#if TRACE_ENABLED
+TraceRecorder traceRecorder;
+#endif
+
+// ======================== EXTERNAL FRAME INPUT ========================
+#if FRAME_INPUT_ENABLED
+WiFiUDP frameUdp;
+FrameInput frameInput;
+#endif
+#if MAX7219_EMU_ENABLED
+WiFiUDP max7219Udp;
+Max7219Decoder max7219Emu;
+#endif
+#if MDMAX_SHIM_ENABLED
+// MD_MAX72xx API over scr (include/md_max72xx_shim.h); one object per matrix row
+void refreshAll();
+MD_MAX72XX mx(scr, refreshAll, 0, font3x7);
+MD_MAX72XX mxBottom(scr, refreshAll, 1, font3x7);
+#endif
+
+// ======================== FLEET PHASE SYNC ========================
+#if FLEET_SYNC_ENABLED
+#define FLEET_OFF       0
+#define FLEET_LEADER    1
+#define FLEET_FOLLOWER  2
+WiFiUDP fleetUdp;
+PhaseSync fleetSync;
+int fleetRole = FLEET_SYNC_ROLE;
+#endif
+
+// ======================== OTA UPDATE ========================
+// Firmware upload over HTTP, streamed to the update partition in
+// OTA_CHUNK_SIZE pieces (include/ota_stream.h)
+#if OTA_ENABLED
+OtaStream<UpdaterClass> ota(Update);
+#endif
 
-// ======================== TIMING VARIABLES ========================
-unsigned long lastSensorUpdate = 0;
-unsigned long lastNTPSync = 0;
-unsigned long lastStatusPrint = 0;
+// ======================== MQTT TELEMETRY ========================
+#if MQTT_ENABLED
+AsyncMqttClient mqtt;
+TelemetryQueue telemetry;
+RetryBackoff mqttBackoff(MQTT_BACKOFF_MIN, MQTT_BACKOFF_MAX);
+char mqttClientId[24];
+char mqttTopic[64];
+char mqttStatusTopic[64];
+char mqttPayload[MQTT_PAYLOAD_SIZE];
+bool mqttConnecting = false;
+unsigned long mqttConnectStart = 0;
+unsigned long mqttLastBatch = 0;
+uint32_t mqttAttempts = 0;
+uint32_t mqttConnects = 0;
+uint32_t mqttDisconnects = 0;      // Drops of an established connection
+int mqttLastReason = -1;           // AsyncMqttClientDisconnectReason
+uint32_t mqttMaxServiceUs = 0;     // Longest connect/publish step
+// Queue events from the client callbacks, applied by serviceMqtt()
+volatile uint16_t mqttAckedId = 0; // onPublish packet id, 0 = none pending
+volatile uint32_t mqttAckedMs = 0;
+volatile bool mqttDropped = false; // onDisconnect since the last service
+#endif
+
+// ======================== INFO PANEL ========================
+#if INFO_PANEL_ENABLED
+InfoPanel<TFT_eSPI> infoPanel(tft, INFO_PANEL_COLOR, BG_COLOR);
+#endif
+void invalidateInfoPanel();  // Call after anything that clears the whole screen
+// Recent sensor readings for the panel's trend arrows (oldest overwritten)
+int temperatureHistory[SENSOR_TREND_SAMPLES];
+int humidityHistory[SENSOR_TREND_SAMPLES];
+int sensorHistoryCount = 0;
 
 // ======================== DISPLAY STYLE VARIABLES ========================
 int displayStyle = DEFAULT_DISPLAY_STYLE;  // 0=Default, 1=Realistic
@@ -186,14 +464,165 @@ bool surroundMatchesLED = false;           // Track if surround should match LED
 bool forceFullRedraw = false;              // Flag to force immediate complete redraw
 
 // ======================== DISPLAY MODES ========================
-int currentMode = 0; // 0=Time+Temp, 1=Time Large, 2=Time+Date
+int currentMode = 0; // Index into displayModes[] (see DISPLAY MODE REGISTRY)
 unsigned long lastModeSwitch = 0;
 #define MODE_SWITCH_INTERVAL 5000
 
+// Inputs a mode's content depends on - the mode is only recomposed when one changes
+#define DEP_SECOND    0x01  // Seconds digits / colon blink
+#define DEP_MINUTE    0x02  // Hours, minutes, date
+#define DEP_SENSOR    0x04  // Temperature, humidity, pressure, temperature unit
+#define DEP_SETTINGS  0x08  // 12/24h format, style, colors
+#define DEP_ANIMATION 0x10  // Animation frame tick (animationTask)
+#define DEP_TIMER     0x20  // Stopwatch/countdown frame tick (timerTask)
+#define DEP_MARQUEE   0x40  // Marquee step (marqueeTask)
+#define DEP_ALL       0xFF
+
+uint8_t pendingDisplayChanges = DEP_ALL;  // Inputs changed since last compose
+
 // ======================== TIMEZONE ========================
 // Timezone definitions are now in include/timezones.h
 int currentTimezone = 0;
 
+// ======================== RTC MEMORY PERSISTENCE ========================
+// Snapshot of time + settings kept in ESP8266 RTC user memory (survives
+// watchdog resets and ESP.restart(), lost on power loss). Lets a warm boot
+// show the correct time immediately instead of waiting for NTP.
+#define RTC_STATE_MAGIC      0x54465443  // "TFTC"
+#define RTC_STATE_OFFSET     0           // Offset in 4-byte blocks (user area starts at block 0)
+
+struct RtcState {
+  uint32_t magic;
+  uint32_t crc;             // CRC32 over everything after this field
+  uint32_t utc;             // Last known UTC time (seconds)
+  uint32_t utcMillis;       // Sub-second part of utc (0-999 ms)
+  int32_t  driftPpm;        // Clock drift estimate from last two NTP syncs
+  uint32_t lastNTPUtc;      // UTC of last successful NTP sync (0 = never)
+  uint8_t  mode;
+  uint8_t  timezone;
+  uint8_t  style;
+  uint8_t  flags;           // bit0=24h, bit1=Fahrenheit, bit2=surround matches LED
+  uint16_t ledColor;
+  uint16_t surroundColor;
+};
+
+#define RTC_FLAG_24H            0x01
+#define RTC_FLAG_FAHRENHEIT     0x02
+#define RTC_FLAG_SURROUND_MATCH 0x04
+
+bool warmBoot = false;            // True if time was restored from RTC memory
+int32_t clockDriftPpm = 0;        // Local oscillator drift vs NTP (parts per million)
+uint32_t lastNTPUtc = 0;          // UTC of last successful NTP sync
+uint32_t ntpSyncCount = 0;        // Times NTP has set the clock
+uint32_t ntpFailCount = 0;        // syncNTP() calls with no reply within NTP_SYNC_TIMEOUT
+uint32_t ntpSyncsBefore = 0;      // ntpSyncCount when the last syncNTP() went out
+int32_t ntpSyncDriftMs = 0;       // NTP minus local elapsed time between the last two syncs
+
+// ======================== WIFI FAST RECONNECT ========================
+// Last successful BSSID/channel (and optionally IP lease) cached in EEPROM so
+// boot can join the AP directly, skipping the scan done by autoConnect().
+// SSID/password stay in the SDK's own flash config - only radio hints are cached.
+#define EEPROM_SIZE              512
+#define EEPROM_WIFI_CACHE_ADDR   0
+#define WIFI_CACHE_MAGIC         0x57464331  // "WFC1"
+#define WIFI_FAST_TIMEOUT        4000        // Give up on the fast path after 4s
+#define WIFI_CACHE_STATIC_IP     0           // Set to 1 to reuse the last DHCP lease as a static IP
+
+struct WifiCache {
+  uint32_t magic;
+  uint32_t crc;             // CRC32 over everything after this field
+  uint8_t  bssid[6];
+  uint8_t  channel;
+  uint8_t  reserved;
+  uint32_t ip;
+  uint32_t gateway;
+  uint32_t subnet;
+  uint32_t dns;
+};
+
+bool wifiFastPathUsed = false;          // True if this boot connected via the cache
+unsigned long wifiConnectMs = 0;        // Time spent associating this boot
+unsigned long bootToOnlineMs = 0;       // millis() when the network came up
+uint32_t wifiConnects = 0;              // Got an IP - every one after the first is a reconnect
+WiFiEventHandler wifiGotIpHandler;
+
+// ======================== ALARMS ========================
+// Alarm table kept in EEPROM after the WiFi cache. The schedule holds the
+// table plus the precomputed next trigger, so the per-second check is one
+// comparison (include/alarm_schedule.h).
+#if ALARMS_ENABLED
+#define EEPROM_ALARM_ADDR        64
+#define ALARM_STORE_MAGIC        0x414C4D31  // "ALM1"
+
+struct AlarmStore {
+  uint32_t magic;
+  uint32_t crc;             // CRC32 over everything after this field
+  uint8_t  count;
+  uint8_t  reserved[3];
+  Alarm    alarms[ALARM_MAX];
+};
+
+static_assert(EEPROM_WIFI_CACHE_ADDR + sizeof(WifiCache) <= EEPROM_ALARM_ADDR, "Alarm store overlaps the WiFi cache");
+static_assert(EEPROM_ALARM_ADDR + sizeof(AlarmStore) <= EEPROM_SIZE, "Alarm store does not fit in EEPROM_SIZE");
+
+AlarmSchedule alarms;
+bool alarmsClockChanged = true;      // Clock set or timezone changed - reindex on the next tick
+time_t alarmLastFired = 0;           // Trigger time of the last alarm fired (never fire it twice)
+unsigned long alarmFlashUntil = 0;   // millis() when the current flash ends
+bool alarmFlashing = false;
+bool alarmFlashInverted = false;     // Current flash phase, applied in renderCurrentMode()
+#endif
+
+// ======================== SPI CLOCK CALIBRATION ========================
+// Write clock chosen per unit, kept in EEPROM after the alarm table. With
+// SUPPORT_TRANSACTIONS TFT_eSPI sets SPI_FREQUENCY again on every write,
+// so a calibrated clock could never take effect.
+#if SPI_CAL_ENABLED && defined(SUPPORT_TRANSACTIONS)
+  #warning "SUPPORT_TRANSACTIONS is defined: SPI clock calibration disabled, the TFT runs at SPI_FREQUENCY"
+  #undef SPI_CAL_ENABLED
+  #define SPI_CAL_ENABLED 0
+#endif
+
+#if SPI_CAL_ENABLED
+#define EEPROM_SPI_CAL_ADDR      272
+#define SPI_CAL_STORE_MAGIC      0x53504331  // "SPC1"
+
+#define SPI_CLOCK_DEFAULT        0  // SPI_FREQUENCY from User_Setup.h
+#define SPI_CLOCK_CALIBRATED     1
+#define SPI_CLOCK_MANUAL         2  // Set via /api/spi?hz= and verified
+#define SPI_CLOCK_UNVERIFIED     3  // Set via /api/spi?hz= without a read path - never stored
+
+struct SpiCalStore {
+  uint32_t magic;
+  uint32_t crc;             // CRC32 over everything after this field
+  uint32_t hz;
+  uint32_t redrawUs;        // Full redraw time measured at hz
+  uint8_t  source;
+  uint8_t  reserved[3];
+};
+
+#if ALARMS_ENABLED
+static_assert(EEPROM_ALARM_ADDR + sizeof(AlarmStore) <= EEPROM_SPI_CAL_ADDR, "SPI clock store overlaps the alarm table");
+#endif
+static_assert(EEPROM_SPI_CAL_ADDR + sizeof(SpiCalStore) <= EEPROM_SIZE, "SPI clock store does not fit in EEPROM_SIZE");
+
+// Test block access for the calibrator; methods in SPI CLOCK CALIBRATION FUNCTIONS
+struct TftCalPanel {
+  uint32_t hz = SPI_FREQUENCY;
+  void setClock(uint32_t clock);
+  void writePixels(const uint16_t* px, int n);
+  bool readPixels(uint16_t* px, int n);
+  uint32_t redrawUs();
+};
+
+TftCalPanel spiCalPanel;
+SpiCalibrator<TftCalPanel> spiCal(spiCalPanel);
+const uint32_t spiCalClocks[] = {SPI_CAL_CLOCKS};
+uint32_t spiClockHz = SPI_FREQUENCY;       // Write clock in use
+uint8_t spiClockSource = SPI_CLOCK_DEFAULT;
+uint32_t spiRedrawUs = 0;                  // Last full redraw measured at spiClockHz, 0 = not yet
+#endif
+
 // ======================== TFT DISPLAY FUNCTIONS ========================
 
 void initTFT() {
@@ -243,128 +672,138 @@ void clearScreen() {
   }
 }
 
-// Dim an RGB565 color while preserving hue
-uint16_t dimRGB565(uint16_t color, int factor) {
-  // Extract RGB components from RGB565
-  int r = (color >> 11) & 0x1F;  // 5 bits
-  int g = (color >> 5) & 0x3F;   // 6 bits
-  int b = color & 0x1F;          // 5 bits
-  
-  // Dim each component by factor (1=50%, 2=33%, 3=25%, etc)
-  r = r / (factor + 1);
-  g = g / (factor + 1);
-  b = b / (factor + 1);
-  
-  // Recombine into RGB565
-  return (r << 11) | (g << 5) | b;
-}
-
 // Force a complete refresh by resetting FAST_REFRESH tracking
 void forceCompleteRefresh() {
   // This will be called by refreshAll to reset its static state
   tft.fillScreen(BG_COLOR);
+  invalidateInfoPanel();
   clearScreen();
 }
 
-void drawLEDPixel(int x, int y, bool lit) {
-  // Bounds checking
-  if (x < 0 || x >= TOTAL_WIDTH || y < 0 || y >= TOTAL_HEIGHT) {
-    return;
-  }
-  
-  // Calculate screen position with centering offset
-  int offsetX = ((tft.width() - DISPLAY_WIDTH) / 2) > 0 ? ((tft.width() - DISPLAY_WIDTH) / 2) : 0;
-  int offsetY = ((tft.height() - DISPLAY_HEIGHT) / 2) > 0 ? ((tft.height() - DISPLAY_HEIGHT) / 2) : 0;
-  
-  // Add extra gap between matrix rows (after row 7, before row 8)
-  // 4-pixel gap for authentic MAX7219 hardware spacing
-  int matrixGap = (y >= 8) ? 4 : 0;  // 4-pixel gap between matrix rows
-  
-  int screenX = offsetX + x * LED_SIZE;
-  int screenY = offsetY + y * LED_SIZE + matrixGap;
-  
-  if (displayStyle == 0) {
-    // ========== DEFAULT STYLE: Solid square blocks ==========
-    uint16_t color = lit ? ledOnColor : BG_COLOR;  // Off LEDs are BLACK
-    tft.fillRect(screenX, screenY, LED_SIZE, LED_SIZE, color);
-  } 
-  else {
-    // ========== REALISTIC STYLE: Circular LED with surround ==========
-    // Enhanced for authenticity matching real MAX7219 hardware
-    
-    if (!lit) {
-      // OFF LED: Show dark circle (visible but dim, like real hardware)
-      // Real LEDs are visible even when off - dark red/gray circle
-      
-      // Fill background black
-      tft.fillRect(screenX, screenY, LED_SIZE, LED_SIZE, BG_COLOR);
-      
-      // Draw subtle dark circle for off LED (visible against black)
-      // Using darker version of surround color for off LED housing
-      uint16_t offHousing = dimRGB565(ledSurroundColor, 7);  // Very dim (1/8 brightness)
-      uint16_t offLED = 0x1800;  // Very dark red (barely visible)
-      
-      for (int py = 1; py < 9; py++) {
-        for (int px = 1; px < 9; px++) {
-          int cx = px - 1;
-          int cy = py - 1;
-          int dx = (cx * 2 - 7);
-          int dy = (cy * 2 - 7);
-          int distSq = dx * dx + dy * dy;
-          
-          if (distSq <= 42) {  // Inner dark circle
-            tft.drawPixel(screenX + px, screenY + py, offLED);
-          }
-          else if (distSq <= 58) {  // Dim surround
-            tft.drawPixel(screenX + px, screenY + py, offHousing);
-          }
-        }
+// Snapshot of the current style settings for the LED rasterizer
+LedStyle currentLedStyle() {
+  LedStyle style;
+  style.style = (uint8_t)displayStyle;
+  style.onColor = ledOnColor;
+  style.surroundColor = ledSurroundColor;
+  style.bgColor = BG_COLOR;
+  return style;
+}
+
+// ======================== DISPLAY SINKS ========================
+// refreshAll() works out which scr bytes changed and hands the frame to
+// every registered sink (see include/display_sink.h)
+
+// The MAX7219 sink switches the shared bus to MAX7219_SPI_FREQUENCY; only
+// with transactions does TFT_eSPI switch it back before its next write
+#if MAX7219_SINK_ENABLED && !defined(SUPPORT_TRANSACTIONS)
+  #error "MAX7219_SINK_ENABLED needs #define SUPPORT_TRANSACTIONS in include/User_Setup.h"
+#endif
+
+// Controllers with VSCRDEF/VSCRSADD over a 320-line axis (include/hw_scroll.h)
+#if defined(ILI9341_DRIVER) || defined(ILI9341_2_DRIVER) || defined(ST7789_DRIVER) || defined(ST7789_2_DRIVER)
+  #define PANEL_HW_SCROLL 1
+#else
+  #define PANEL_HW_SCROLL 0
+#endif
+
+// TFT panel - simulated LEDs drawn by include/led_renderer.h
+class TftSink : public DisplaySink {
+public:
+  TftSink() : canvas(tft), scroll(tft), scrolling(false) {}
+  const char* name() const override { return "tft"; }
+  uint64_t spiBytes() const { return canvas.bytes() + scroll.bytes(); }
+
+  void present(const uint8_t* frame, uint64_t dirty, const LedStyle& style) override {
+    // Center the matrix on the panel
+    int originX = ((tft.width() - DISPLAY_WIDTH) / 2) > 0 ? ((tft.width() - DISPLAY_WIDTH) / 2) : 0;
+    int originY = ((tft.height() - DISPLAY_HEIGHT) / 2) > 0 ? ((tft.height() - DISPLAY_HEIGHT) / 2) : 0;
+
+    tft.startWrite();  // Hold CS low across the whole update
+    for (int i = 0; i < FRAME_BYTES; i++) {
+      if (dirty & (1ULL << i)) {
+        int slot = (i % LINE_WIDTH + scroll.offsetColumns()) % LINE_WIDTH;  // Where the pan put this column
+        renderLEDColumn(canvas, originX, originY, slot, i / LINE_WIDTH, frame[i], style);
       }
     }
-    else {
-      // LIT LED: Draw bright circular LED with surround
-      // Fill background with surround color first
-      tft.fillRect(screenX, screenY, LED_SIZE, LED_SIZE, ledSurroundColor);
-
-      // Draw from outside in for better circular appearance
-      for (int py = 0; py < 10; py++) {
-        for (int px = 0; px < 10; px++) {
-          int cx = px;
-          int cy = py;
-          int dx = (cx * 2 - 9);
-          int dy = (cy * 2 - 9);
-          int distSq = dx * dx + dy * dy;
-
-          uint16_t pixelColor;
-
-          // Redesigned for better visibility of surround
-          if (distSq <= 18) {
-            // Bright center (core)
-            pixelColor = ledOnColor;
-          }
-          else if (distSq <= 38) {
-            // Main LED body (still bright)
-            pixelColor = ledOnColor;
-          }
-          else if (distSq <= 62) {
-            // Surround/bezel ring (use full surround color, not dimmed)
-            pixelColor = ledSurroundColor;
-          }
-          else {
-            // Outside circle: black
-            pixelColor = BG_COLOR;
-          }
-
-          tft.drawPixel(screenX + px, screenY + py, pixelColor);
-        }
-      }
+    tft.endWrite();
+  }
+
+  bool pan(int columns) override {
+    if (!scrolling) return false;
+    scroll.pan(columns);
+    return true;
+  }
+
+  // Hardware panning on/off. False if the controller or orientation can't
+  // pan horizontally. Switching off unpans the picture - redraw everything.
+  bool enableScroll(bool on) {
+    if (!on) {
+      scroll.reset();
+      scrolling = false;
+      return false;
     }
+    if (!PANEL_HW_SCROLL || !(tft.getRotation() & 1)) return false;
+    int originX = ((tft.width() - DISPLAY_WIDTH) / 2) > 0 ? ((tft.width() - DISPLAY_WIDTH) / 2) : 0;
+    if (!scroll.isReady() && !scroll.begin(tft.width(), originX, LINE_WIDTH, LED_SIZE, HW_SCROLL_REVERSED)) return false;
+    scrolling = true;
+    return true;
+  }
+
+  // tft.init() put the controller's scroll registers back to reset values:
+  // define the scroll area again (unpanned) if it was in use. Redraw after.
+  void panelReset() {
+    if (!scrolling) return;
+    int originX = ((tft.width() - DISPLAY_WIDTH) / 2) > 0 ? ((tft.width() - DISPLAY_WIDTH) / 2) : 0;
+    scrolling = scroll.begin(tft.width(), originX, LINE_WIDTH, LED_SIZE, HW_SCROLL_REVERSED);
   }
+
+  bool isScrolling() const { return scrolling; }
+  bool canScroll() const { return PANEL_HW_SCROLL && (tft.getRotation() & 1); }
+  const HwScroll<TFT_eSPI>& hwScroll() const { return scroll; }
+
+private:
+  SpiCountingCanvas<TFT_eSPI> canvas;  // Counts SPI bytes for /metrics
+  HwScroll<TFT_eSPI> scroll;
+  bool scrolling;                      // Pans in hardware (marquee)
+};
+
+TftSink tftSink;
+uint32_t framesRendered = 0;  // refreshAll() calls that changed something
+uint64_t ledsPushed = 0;      // LEDs redrawn on the TFT (8 per scr byte it was given)
+int displayPan = 0;           // Columns the content moved left since the last refreshAll() (marquee)
+#if MAX7219_SINK_ENABLED
+Max7219Sink max7219Sink(MAX7219_CS_PIN, MAX7219_INTENSITY);
+#endif
+#ifdef HEADLESS_FRAMEBUFFER
+FramebufferSink framebufferSink;
+#endif
+
+DisplaySink* displaySinks[MAX_DISPLAY_SINKS];
+int numDisplaySinks = 0;
+
+void addDisplaySink(DisplaySink* sink) {
+  if (numDisplaySinks >= MAX_DISPLAY_SINKS) return;
+  sink->begin();
+  displaySinks[numDisplaySinks++] = sink;
+  DEBUG(Serial.printf("Display sink registered: %s\n", sink->name()));
+}
+
+void initDisplaySinks() {
+  addDisplaySink(&tftSink);
+  #if MAX7219_SINK_ENABLED
+    addDisplaySink(&max7219Sink);
+  #endif
+  #ifdef HEADLESS_FRAMEBUFFER
+    addDisplaySink(&framebufferSink);
+  #endif
 }
 
 void refreshAll() {
   // The buffer is organized as scr[x + y * LINE_WIDTH] where each byte = 8 vertical pixels
   // We have 2 rows of matrices, so we need to handle 16 pixels vertically
+  uint64_t dirty = FRAME_ALL_DIRTY;
+  uint64_t panDirty = FRAME_ALL_DIRTY;
   
   #if FAST_REFRESH
     // Static buffer to track previous state for change detection
@@ -373,48 +812,32 @@ void refreshAll() {
     
     // Check if external force refresh was requested
     if (forceFullRedraw) {
-      // Clear the tracking buffer to force everything to redraw
-      for (int i = 0; i < LINE_WIDTH * DISPLAY_ROWS; i++) {
-        lastScr[i] = 0xFF;  // Set to invalid state
-      }
       forceFullRedraw = false;  // Clear the flag
       firstRun = true;  // Treat as first run
-      DEBUG(Serial.println("FAST_REFRESH cache cleared - forcing full redraw"));
+      LOG(LOG_DISPLAY, LOG_DEBUG, "FAST_REFRESH cache cleared - forcing full redraw");
     }
+    
+    // Only redraw bytes that changed (everything on first run). Sinks that
+    // pan in hardware only need what differs from the panned picture.
+    if (displayPan && !firstRun) panDirty = frameDiffPanned(scr, lastScr, displayPan);
+    uint64_t changed = frameDiff(scr, lastScr);
+    if (!firstRun) dirty = changed;
+    firstRun = false;
   #endif
   
-  // Process both rows of matrices (0-7 pixels and 8-15 pixels)
-  for (int row = 0; row < DISPLAY_ROWS; row++) {
-    for (int displayX = 0; displayX < LINE_WIDTH; displayX++) {
-      int bufferIndex = displayX + row * LINE_WIDTH;
-      
-      if (bufferIndex >= 0 && bufferIndex < LINE_WIDTH * DISPLAY_ROWS) {
-        byte pixelByte = scr[bufferIndex];
-        
-        #if FAST_REFRESH
-          // Only redraw if changed or first run
-          if (firstRun || pixelByte != lastScr[bufferIndex]) {
-            lastScr[bufferIndex] = pixelByte;
-        #endif
-            
-            // Each bit in pixelByte represents a vertical pixel (0-7)
-            for (int bitPos = 0; bitPos < 8; bitPos++) {
-              int displayY = row * 8 + bitPos;  // Calculate actual Y position (0-15)
-              bool lit = (pixelByte & (1 << bitPos)) != 0;
-              
-              drawLEDPixel(displayX, displayY, lit);
-            }
-            
-        #if FAST_REFRESH
-          }
-        #endif
-      }
-    }
-  }
+  if (dirty == 0) return;
   
-  #if FAST_REFRESH
-    firstRun = false;
-  #endif
+  MemProbe probe(memStats, memSiteRedraw);
+  LatencyProbe timing(latency, latRefreshAll);
+  TRACE_SCOPE("refreshAll");
+  LedStyle style = currentLedStyle();
+  for (int i = 0; i < numDisplaySinks; i++) {
+    bool panned = displayPan && displaySinks[i]->pan(displayPan);
+    uint64_t mask = panned ? panDirty : dirty;
+    displaySinks[i]->present(scr, mask, style);
+    if (displaySinks[i] == &tftSink) ledsPushed += __builtin_popcountll(mask) * 8;
+  }
+  framesRendered++;
 }
 
 void invert() {
@@ -603,21 +1026,17 @@ void displayTimeAndTemp() {
   // }
 }
 
-void displayTimeLarge() {
-  clearScreen();
-  
+// Large 16px "H:MM" plus a small two-character suffix (Time Large layout;
+// the stopwatch/countdown modes reuse it for M:SS + hundredths)
+void drawLargeTime(int major, int minor, const char* suffix, bool showDots) {
   char buf[32];
-  bool showDots = (seconds % 2) == 0;
-  
-  // Determine display hours based on format
-  int displayHours = use24HourFormat ? hours24 : hours;
   
   // Large time display on top row using 16-pixel tall font
   // Start position depends on whether hours is 1 or 2 digits
-  int x = (displayHours > 9) ? 0 : 3;
+  int x = (major > 9) ? 0 : 3;
   
   // Draw hours
-  sprintf(buf, "%d", displayHours);
+  sprintf(buf, "%d", major);
   for (const char* p = buf; *p; p++) {
     x += drawCharWithY(x, 0, *p, digits5x16rn);
     if (*(p+1)) x++;  // Spacing between hour digits only
@@ -632,18 +1051,17 @@ void displayTimeLarge() {
   }
   
   // Draw minutes - NO extra spacing before, tight to colon
-  sprintf(buf, "%02d", minutes);
+  sprintf(buf, "%02d", minor);
   for (const char* p = buf; *p; p++) {
     x += drawCharWithY(x, 0, *p, digits5x16rn);
     if (*(p+1)) x++;  // Spacing between minute digits only
   }
   
-  // Add small gap before seconds
+  // Add small gap before suffix
   x++;
   
-  // Draw seconds in small font
-  sprintf(buf, "%02d", seconds);
-  for (const char* p = buf; *p; p++) {
+  // Draw suffix (seconds) in small font
+  for (const char* p = suffix; *p; p++) {
     if (x < LINE_WIDTH - 3) {  // Check if room remains
       x += drawCharWithY(x, 0, *p, font3x7);
       if (*(p+1) && x < LINE_WIDTH - 3) x++;  // Spacing between second digits if room
@@ -651,6 +1069,14 @@ void displayTimeLarge() {
   }
 }
 
+void displayTimeLarge() {
+  clearScreen();
+  
+  char buf[4];
+  sprintf(buf, "%02d", seconds);
+  drawLargeTime(use24HourFormat ? hours24 : hours, minutes, buf, (seconds % 2) == 0);
+}
+
 void displayTimeAndDate() {
   clearScreen();
   
@@ -704,142 +1130,1846 @@ void displayTimeAndDate() {
   // }
 }
 
-// ======================== SENSOR FUNCTIONS ========================
+// ======================== ANALOG CLOCK ========================
+#if ANALOG_MODE_ENABLED
+AnalogClock analogClock;
 
-bool testSensor() {
-  Wire.begin(SDA_PIN, SCL_PIN);
-  
-  if (!bme280.begin(0x76, &Wire)) {
-    DEBUG(Serial.println("BME280 sensor not found at 0x76"));
-    if (!bme280.begin(0x77, &Wire)) {
-      DEBUG(Serial.println("BME280 sensor not found at 0x77 either"));
-      return false;
-    }
+// Dial centred on the matrix; hands come from the per-angle cache
+void displayAnalog() {
+  clearScreen();
+  analogClock.compose(scr, LINE_WIDTH, (LINE_WIDTH - ANALOG_FACE_SIZE) / 2, hours24 % 12, minutes, seconds);
+}
+#endif
+
+// ======================== STOPWATCH / COUNTDOWN ========================
+#if TIMER_MODES_ENABLED
+WiFiUDP timerUdp;
+Stopwatch stopwatch;
+Stopwatch countdown;
+Stopwatch* activeTimer = &stopwatch;  // Target of start/stop/reset
+FrameRateMeter timerMeter;
+int timerRefreshHz = TIMER_REFRESH_HZ;
+int timerPrecision = TIMER_PRECISION;
+uint32_t timerChangedBytes = 0;       // scr bytes changed across timerMeter's frames
+
+// M:SS + fraction below an hour, H:MM + SS above; colon blinks while paused
+void composeTimer(const Stopwatch& sw) {
+  clearScreen();
+  uint32_t now = millis();
+  if (sw.isExpired() && (now / 250) % 2) return;  // Flash 0:00 until reset
+
+  uint32_t ms = sw.value(now);
+  int s = ms / 1000;
+  bool showDots = sw.isRunning() || (now / 500) % 2 == 0;
+  char suffix[4];
+  if (s < 3600) {
+    if (timerPrecision == 1) sprintf(suffix, "%d", (int)(ms % 1000) / 100);
+    else sprintf(suffix, "%02d", (int)(ms % 1000) / 10);
+    drawLargeTime(s / 60, s % 60, suffix, showDots);
+  } else {
+    sprintf(suffix, "%02d", s % 60);
+    drawLargeTime((s / 3600) % 100, (s / 60) % 60, suffix, showDots);
   }
-  
-  bme280.setSampling(Adafruit_BME280::MODE_FORCED,
-                     Adafruit_BME280::SAMPLING_X1,
-                     Adafruit_BME280::SAMPLING_X1,
-                     Adafruit_BME280::SAMPLING_X1,
-                     Adafruit_BME280::FILTER_OFF);
-  
-  float temp = bme280.readTemperature();
-  float hum = bme280.readHumidity();
-  
-  if (isnan(temp) || isnan(hum) || temp < -50 || temp > 100 || hum < 0 || hum > 100) {
-    DEBUG(Serial.println("BME280 readings invalid"));
-    return false;
+}
+
+void displayStopwatch() {
+  composeTimer(stopwatch);
+}
+
+void displayCountdown() {
+  composeTimer(countdown);
+}
+#endif
+
+// ======================== MARQUEE ========================
+// Two-line ticker moving one LED column per step. Where the panel supports
+// it (include/hw_scroll.h) each step pans the picture in hardware and only
+// the newly exposed column is drawn; otherwise every column that changed
+// is redrawn through the normal diff.
+#if MARQUEE_ENABLED
+char marqueeText[2][MARQUEE_MAX_TEXT];  // Top/bottom line
+bool marqueeCustom = false;             // false = time/date and sensor lines, rebuilt each pass
+bool marqueeHw = MARQUEE_HW_SCROLL;     // Use the hardware pan when the panel allows
+int marqueeTextCols = 0;                // Stream columns holding text
+int marqueePos = 0;                     // Stream column at the left edge
+uint32_t marqueeLastBytes = 0;          // SPI bytes of the last step
+uint32_t marqueeLastUs = 0;
+uint32_t marqueeHwSteps = 0, marqueeSwSteps = 0;
+uint64_t marqueeHwBytes = 0, marqueeSwBytes = 0;
+
+// Column `col` of `text` in font3x7 (1 blank column between characters)
+uint8_t marqueeColumn(const char* text, int col) {
+  int fwd = pgm_read_byte(font3x7);
+  int offs = pgm_read_byte(font3x7 + 2);
+  int last = pgm_read_byte(font3x7 + 3);
+  for (const char* p = text; *p; p++) {
+    if (*p < offs || *p > last) continue;
+    const uint8_t* glyph = font3x7 + 4 + (*p - offs) * (fwd + 1);
+    int w = pgm_read_byte(glyph);
+    if (col < w) return pgm_read_byte(glyph + 1 + col);
+    col -= w + 1;
+    if (col < 0) return 0;
   }
-  
-  DEBUG(Serial.printf("BME280 OK: %.1f°C, %.1f%%\n", temp, hum));
-  return true;
+  return 0;
 }
 
-void updateSensorData() {
-  if (!sensorAvailable) return;
-  
-  bme280.takeForcedMeasurement();
-  float temp = bme280.readTemperature();
-  float hum = bme280.readHumidity();
-  float pres = bme280.readPressure() / 100.0F;
-  
-  if (!isnan(temp) && temp >= -50 && temp <= 100) {
-    temperature = (int)round(temp);
+int marqueeWidth(const char* text) {
+  int fwd = pgm_read_byte(font3x7);
+  int offs = pgm_read_byte(font3x7 + 2);
+  int last = pgm_read_byte(font3x7 + 3);
+  int width = 0;
+  for (const char* p = text; *p; p++) {
+    if (*p >= offs && *p <= last) width += pgm_read_byte(font3x7 + 4 + (*p - offs) * (fwd + 1)) + 1;
   }
-  
-  if (!isnan(hum) && hum >= 0 && hum <= 100) {
-    humidity = (int)round(hum);
+  return width;
+}
+
+// font3x7 has no lower case
+void setMarqueeLine(int line, const char* text) {
+  int i = 0;
+  for (; text[i] && i < MARQUEE_MAX_TEXT - 1; i++) marqueeText[line][i] = toupper((unsigned char)text[i]);
+  marqueeText[line][i] = 0;
+}
+
+// Text for the next pass; the stream is the text followed by one screen of blank.
+// at: clock text for this local time instead of now (display self-test).
+void buildMarqueeText(const struct tm* at = nullptr) {
+  if (!marqueeCustom) {
+    char buf[MARQUEE_MAX_TEXT];
+    struct tm t;
+    if (at) {
+      t = *at;
+    } else {
+      time_t now = time(nullptr);
+      localtime_r(&now, &t);
+    }
+    strftime(buf, sizeof(buf), use24HourFormat ? "%H:%M  %a %d %b %Y" : "%I:%M%p  %a %d %b %Y", &t);
+    setMarqueeLine(0, buf);
+    if (sensorAvailable) {
+      snprintf(buf, sizeof(buf), "%d%c  %d%%  %dHPA", useFahrenheit ? temperature * 9 / 5 + 32 : temperature,
+               useFahrenheit ? 'F' : 'C', humidity, pressure);
+    } else {
+      IPAddress ip = WiFi.localIP();
+      snprintf(buf, sizeof(buf), "IP %u.%u.%u.%u", ip[0], ip[1], ip[2], ip[3]);
+    }
+    setMarqueeLine(1, buf);
   }
-  
-  if (!isnan(pres) && pres >= 800 && pres <= 1200) {
-    pressure = (int)round(pres);
+  marqueeTextCols = max(marqueeWidth(marqueeText[0]), marqueeWidth(marqueeText[1]));
+}
+
+// Pure function of marqueePos, so a settings recompose never moves the text
+void displayMarquee() {
+  int length = marqueeTextCols + LINE_WIDTH;
+  for (int x = 0; x < LINE_WIDTH; x++) {
+    int col = (marqueePos + x) % length;
+    scr[x] = marqueeColumn(marqueeText[0], col);
+    scr[x + LINE_WIDTH] = marqueeColumn(marqueeText[1], col);
   }
 }
 
-// ======================== NTP SYNC FUNCTION ========================
+// The hardware pan moves every pixel row, so the info panel bands are
+// blanked (and the panel paused) while it is in use
+void marqueeUseHw(bool on) {
+  if (on == tftSink.isScrolling()) return;
+  if (on) {
+    if (!tftSink.enableScroll(true)) return;
+    int originY = max((tft.height() - DISPLAY_HEIGHT) / 2, 0);
+    tft.fillRect(0, 0, tft.width(), originY, BG_COLOR);
+    tft.fillRect(0, originY + DISPLAY_HEIGHT, tft.width(), tft.height() - originY - DISPLAY_HEIGHT, BG_COLOR);
+  } else {
+    tftSink.enableScroll(false);
+    forceFullRedraw = true;  // Every column is back in its unpanned slot
+    invalidateInfoPanel();
+  }
+  LOG(LOG_DISPLAY, LOG_INFO, "Marquee: %s scrolling", on ? "hardware" : "software");
+}
+#endif
 
-void syncNTP() {
-  DEBUG(Serial.println("Syncing time with NTP..."));
-  
-  configTime(timezones[currentTimezone].tzString, "pool.ntp.org", "time.nist.gov");
-  
-  time_t now = time(nullptr);
-  int attempts = 0;
-  while (now < 24 * 3600 && attempts < 20) {
-    delay(500);
-    now = time(nullptr);
-    attempts++;
+// ======================== ANIMATED MODES ========================
+uint32_t animationFrameUs = 0;    // Last animation tick: compose + refresh
+
+// ======================== LIFE SCREENSAVER ========================
+#if LIFE_MODE_ENABLED
+LifeAutomaton life;
+unsigned long lifeLastStepMs = 0;
+uint32_t lifeStepUs = 0;          // Last generation (compute only)
+uint16_t lifeGensPerSec = 0;      // Measured over the last second
+uint32_t lifeWindowStart = 0;
+uint32_t lifeWindowGens = 0;
+
+uint32_t lifeRandom() {
+  return (uint32_t)random(0x7FFFFFFF);
+}
+
+void displayLife() {
+  // Just switched in: seed from whatever the previous mode left on screen
+  if (millis() - lifeLastStepMs > 1000) {
+    life.load(scr);
+    if (life.population() < 20) life.randomize(lifeRandom);
+  } else if (life.stagnant()) {
+    life.randomize(lifeRandom);
   }
-  
-  if (now > 24 * 3600) {
-    struct tm timeinfo;
-    localtime_r(&now, &timeinfo);
-    
-    hours = timeinfo.tm_hour % 12;
-    if (hours == 0) hours = 12;
-    hours24 = timeinfo.tm_hour;
-    minutes = timeinfo.tm_min;
-    seconds = timeinfo.tm_sec;
-    day = timeinfo.tm_mday;
-    month = timeinfo.tm_mon + 1;
-    year = timeinfo.tm_year + 1900;
-    
-    DEBUG(Serial.printf("Time synced: %02d:%02d:%02d %02d/%02d/%d (TZ: %s)\n",
-                        hours24, minutes, seconds, day, month, year,
-                        timezones[currentTimezone].name));
-  } else {
-    DEBUG(Serial.println("NTP sync failed"));
+
+  unsigned long start = micros();
+  life.step();
+  lifeStepUs = micros() - start;
+  lifeLastStepMs = millis();
+  life.store(scr);
+
+  lifeWindowGens++;
+  if (lifeLastStepMs - lifeWindowStart >= 1000) {
+    lifeGensPerSec = lifeWindowGens * 1000 / (lifeLastStepMs - lifeWindowStart);
+    lifeWindowStart = lifeLastStepMs;
+    lifeWindowGens = 0;
   }
 }
+#endif
 
-// ======================== TIME UPDATE FUNCTION ========================
+// ======================== SPECTRUM ANALYSER ========================
+#if SPECTRUM_MODE_ENABLED
+SpectrumAnalyzer spectrum;
+uint8_t spectrumHeights[SPECTRUM_COLUMNS];
+uint32_t spectrumSampleUs = 0;    // Last sample burst
+uint32_t spectrumFftUs = 0;       // Last window + FFT + binning
+unsigned long spectrumLastDecay = 0;
 
-void updateTime() {
-  time_t now = time(nullptr);
-  if (now < 24 * 3600) return;
-  
-  struct tm timeinfo;
-  localtime_r(&now, &timeinfo);
-  
-  hours = timeinfo.tm_hour % 12;
-  if (hours == 0) hours = 12;
-  hours24 = timeinfo.tm_hour;
-  minutes = timeinfo.tm_min;
-  seconds = timeinfo.tm_sec;
-  day = timeinfo.tm_mday;
-  month = timeinfo.tm_mon + 1;
-  year = timeinfo.tm_year + 1900;
-  
-  if (seconds != lastSecond) {
-    lastSecond = seconds;
-    DEBUG(Serial.printf("Display update - Mode: %d, Time: %02d:%02d:%02d\n", currentMode, hours24, minutes, seconds));
-    switch (currentMode) {
-      case 0: displayTimeAndTemp(); break;
-      case 1: displayTimeLarge(); break;
-      case 2: displayTimeAndDate(); break;
-    }
-    refreshAll();
+// One window of samples per frame, paced off micros() here in task
+// context: analogRead() is not safe from an interrupt, and timer1 belongs
+// to the analogWrite() backlight PWM
+void displaySpectrum() {
+  const uint32_t periodUs = 1000000UL / SPECTRUM_SAMPLE_RATE;
+  unsigned long start = micros();
+  unsigned long next = start;
+  for (int i = 0; i < SPECTRUM_FFT_SIZE; i++) {
+    while ((int32_t)(micros() - next) < 0) {}
+    spectrum.pushSample(analogRead(A0));
+    next += periodUs;
   }
-  
-  // Auto-switch modes
-  if (millis() - lastModeSwitch > MODE_SWITCH_INTERVAL) {
-    currentMode = (currentMode + 1) % 3;
-    lastModeSwitch = millis();
+  spectrumSampleUs = micros() - start;
+
+  start = micros();
+  spectrum.compute(spectrumHeights);
+  spectrumFftUs = micros() - start;
+
+  if (millis() - spectrumLastDecay >= SPECTRUM_PEAK_DECAY_MS) {
+    spectrumLastDecay = millis();
+    spectrum.decayPeaks();
   }
+  spectrum.draw(spectrumHeights, scr, LINE_WIDTH);
 }
+#endif
 
-// ======================== WEB SERVER FUNCTIONS ========================
+// ======================== DISPLAY MODE REGISTRY ========================
+// Each mode: compose function, inputs it depends on, and how long it stays
+// on screen before auto-switching (0 = manual only: never entered by the
+// rotation and never left automatically). Add new modes here only.
 
-void setupWebServer() {
-  // Root page handler
-  server.on("/", []() {
-    String html = "<!DOCTYPE html><html><head>";
-    html += "<meta charset='UTF-8'>";
-    html += "<meta name='viewport' content='width=device-width, initial-scale=1.0'>";
-    html += "<title>TFT LED Clock</title>";
-    html += "<style>";
-    html += "*{box-sizing:border-box;}";
-    html += "body{font-family:'Segoe UI',Arial,sans-serif;margin:0;padding:15px;background:#1a1a1a;color:#fff;max-width:1200px;margin:0 auto;}";
+struct DisplayMode {
+  const char* name;
+  void (*compose)();
+  uint8_t deps;
+  uint16_t dwellMs;
+};
+
+const DisplayMode displayModes[] = {
+  {"Time+Temp",  displayTimeAndTemp, DEP_SECOND | DEP_SENSOR | DEP_SETTINGS, MODE_SWITCH_INTERVAL},
+  {"Time Large", displayTimeLarge,   DEP_SECOND | DEP_SETTINGS,              MODE_SWITCH_INTERVAL},
+  {"Time+Date",  displayTimeAndDate, DEP_SECOND | DEP_SETTINGS,              MODE_SWITCH_INTERVAL},
+#if ANALOG_MODE_ENABLED
+  {"Analog",     displayAnalog,      DEP_SECOND | DEP_SETTINGS,              MODE_SWITCH_INTERVAL},
+#endif
+#if LIFE_MODE_ENABLED
+  {"Life",       displayLife,        DEP_ANIMATION,                          LIFE_DWELL},
+#endif
+#if SPECTRUM_MODE_ENABLED
+  {"Spectrum",   displaySpectrum,    DEP_ANIMATION,                          SPECTRUM_DWELL},
+#endif
+#if TIMER_MODES_ENABLED
+  {"Stopwatch",  displayStopwatch,   DEP_TIMER | DEP_SETTINGS,               0},
+  {"Countdown",  displayCountdown,   DEP_TIMER | DEP_SETTINGS,               0},
+#endif
+#if MARQUEE_ENABLED
+  {"Marquee",    displayMarquee,     DEP_MARQUEE | DEP_SETTINGS,             0},
+#endif
+};
+
+const int numDisplayModes = sizeof(displayModes) / sizeof(displayModes[0]);
+
+// Index of the named mode in displayModes[], -1 if it isn't in this build
+int findDisplayMode(const char* name) {
+  for (int i = 0; i < numDisplayModes; i++) {
+    if (strcmp(displayModes[i].name, name) == 0) return i;
+  }
+  return -1;
+}
+
+// Record that some inputs changed; rendering happens in renderCurrentMode()
+void markDisplayDirty(uint8_t deps) {
+  pendingDisplayChanges |= deps;
+}
+
+// True while an external source (UDP frames, MAX7219 stream) owns the display
+bool externalDisplayActive() {
+  #if FRAME_INPUT_ENABLED
+    if (frameInput.isActive()) return true;
+  #endif
+  #if MAX7219_EMU_ENABLED
+    if (max7219Emu.isActive()) return true;
+  #endif
+  return false;
+}
+
+// Recompose + refresh only if an input the current mode depends on changed
+void renderCurrentMode() {
+  if (externalDisplayActive()) return;  // Changes stay pending until the clock takes over again
+  const DisplayMode& mode = displayModes[currentMode];
+  if (pendingDisplayChanges & mode.deps) {
+    LOG(LOG_DISPLAY, LOG_DEBUG, "Display update - Mode: %s, Time: %02d:%02d:%02d", mode.name, hours24, minutes, seconds);
+    mode.compose();
+    #if ALARMS_ENABLED
+      if (alarmFlashInverted) invert();
+    #endif
+    refreshAll();
+  }
+  pendingDisplayChanges = 0;
+}
+
+void setDisplayMode(int mode) {
+  currentMode = mode % numDisplayModes;
+  lastModeSwitch = millis();
+  markDisplayDirty(DEP_ALL);
+
+  #if TIMER_MODES_ENABLED
+    // The high-rate frame task only runs while a timer is on screen
+    bool timerShown = (displayModes[currentMode].deps & DEP_TIMER) != 0;
+    if (timerShown) timerMeter.reset(1000000UL / timerRefreshHz);
+    timerChangedBytes = 0;
+    scheduler.setActive(taskTimer, timerShown);
+  #endif
+  #if MARQUEE_ENABLED
+    bool marqueeShown = displayModes[currentMode].compose == displayMarquee;
+    if (marqueeShown) {
+      marqueePos = 0;
+      buildMarqueeText();
+    }
+    marqueeUseHw(marqueeShown && marqueeHw);
+    scheduler.setActive(taskMarquee, marqueeShown);
+  #endif
+}
+
+// Next mode in the automatic rotation, skipping manual-only modes
+int nextRotationMode() {
+  for (int i = 1; i <= numDisplayModes; i++) {
+    int mode = (currentMode + i) % numDisplayModes;
+    if (displayModes[mode].dwellMs) return mode;
+  }
+  return currentMode;
+}
+
+// Per-tick cost of every clock (non-animated) mode over `ticks` simulated
+// seconds: compose time, scr bytes changed (= LED columns the TFT redraws)
+// and the diff-based refresh time. Returns a JSON array.
+String benchClockModes(int ticks) {
+  int savedSeconds = seconds, savedMinutes = minutes;
+  uint8_t saved[sizeof(scr)], previous[sizeof(scr)];
+  memcpy(saved, scr, sizeof(scr));
+
+  String json = "[";
+  bool first = true;
+  for (int i = 0; i < numDisplayModes; i++) {
+    const DisplayMode& mode = displayModes[i];
+    if (mode.deps & DEP_ANIMATION) continue;
+    uint32_t composeUs = 0, renderUs = 0, dirtyBytes = 0;
+    for (int t = 0; t <= ticks; t++) {
+      seconds = t % 60;
+      minutes = (savedMinutes + t / 60) % 60;
+      unsigned long start = micros();
+      mode.compose();
+      unsigned long composed = micros();
+      uint64_t changed = frameDiff(scr, previous);
+      refreshAll();
+      if (t > 0) {  // Tick 0 only primes previous
+        composeUs += composed - start;
+        renderUs += micros() - composed;
+        dirtyBytes += __builtin_popcountll(changed);
+      }
+      yield();
+    }
+    if (!first) json += ",";
+    first = false;
+    json += "{\"mode\":\"" + String(mode.name) + "\"" +
+            ",\"compose_us_per_tick\":" + String((float)composeUs / ticks, 1) +
+            ",\"dirty_bytes_per_tick\":" + String((float)dirtyBytes / ticks, 1) +
+            ",\"render_us_per_tick\":" + String((float)renderUs / ticks, 1) + "}";
+  }
+  json += "]";
+
+  seconds = savedSeconds;
+  minutes = savedMinutes;
+  memcpy(scr, saved, sizeof(scr));
+  refreshAll();
+  return json;
+}
+
+#if MARQUEE_ENABLED
+// One column left; returns the SPI bytes it cost
+uint32_t marqueeStep() {
+  uint64_t before = tftSink.spiBytes();
+  marqueePos++;
+  if (marqueePos == marqueeTextCols) {  // Only blank on screen - safe to change the text
+    buildMarqueeText();
+    marqueePos = marqueeTextCols;
+  }
+  marqueePos %= marqueeTextCols + LINE_WIDTH;
+  displayPan = tftSink.isScrolling() ? 1 : 0;
+  markDisplayDirty(DEP_MARQUEE);
+  renderCurrentMode();
+  displayPan = 0;
+  return (uint32_t)(tftSink.spiBytes() - before);
+}
+
+// `steps` steps on each path from the same start; JSON object
+String benchMarquee(int steps) {
+  bool savedHw = tftSink.isScrolling();
+  int savedPos = marqueePos;
+  String json = "{\"steps\":" + String(steps);
+  for (int hw = 1; hw >= 0; hw--) {
+    marqueeUseHw(hw);
+    if (hw && !tftSink.isScrolling()) continue;  // Panel can't pan
+    marqueePos = savedPos;
+    markDisplayDirty(DEP_MARQUEE);
+    renderCurrentMode();
+    uint64_t bytes = 0;
+    unsigned long start = micros();
+    for (int i = 0; i < steps; i++) {
+      bytes += marqueeStep();
+      yield();
+    }
+    unsigned long us = micros() - start;
+    json += String(hw ? ",\"hw\":" : ",\"sw\":") +
+            "{\"bytes_per_step\":" + String((uint32_t)(bytes / steps)) +
+            ",\"us_per_step\":" + String(us / steps) + "}";
+  }
+  marqueeUseHw(savedHw);
+  json += "}";
+  return json;
+}
+#endif
+
+// ======================== DISPLAY SELF-TEST ========================
+// Renders every mode at fixed simulated times/sensor values and compares
+// the composed frame with the goldens in include/golden_frames.h. Also
+// times a full redraw of each mode in both styles against a budget, so a
+// change that slows rendering fails just like a visual change. A mode
+// with no golden case is a failure, not a skip.
+// Frames are compared at scr level - pixels are a pure function of scr and
+// style via include/led_renderer.h (checked per image by test/test_golden).
+#if DISPLAY_SELFTEST
+
+void applyGoldenCase(const GoldenCase& c) {
+  hours24 = c.hour24;
+  hours = c.hour24 % 12;
+  if (hours == 0) hours = 12;
+  minutes = c.minute;
+  seconds = c.second;
+  day = c.day;
+  month = c.month;
+  year = c.year;
+  temperature = c.temperature;
+  humidity = c.humidity;
+  pressure = GOLDEN_PRESSURE;
+  sensorAvailable = (c.flags & GOLDEN_NO_SENSOR) == 0;
+  use24HourFormat = (c.flags & GOLDEN_24H) != 0;
+  useFahrenheit = (c.flags & GOLDEN_FAHRENHEIT) != 0;
+}
+
+// Sets up the case and composes its mode into scr. Returns the mode index,
+// -1 if the mode isn't in this build (scr untouched).
+int composeGoldenCase(const GoldenCase& c) {
+  int mode = findDisplayMode(c.mode);
+  if (mode < 0) return -1;
+  applyGoldenCase(c);
+  #if LIFE_MODE_ENABLED
+    // Life takes over the previous frame: one LIFE_RULE generation from
+    // this case's Time+Temp frame, as if the rotation just switched in
+    if (displayModes[mode].compose == displayLife) {
+      displayTimeAndTemp();
+      life.setRule(LIFE_RULE);
+      lifeLastStepMs = millis() - 2000;
+    }
+  #endif
+  #if TIMER_MODES_ENABLED
+    // Timers running for c.state ms (a paused or expired one blinks)
+    timerPrecision = (c.flags & GOLDEN_TENTHS) ? 1 : 2;
+    if (displayModes[mode].compose == displayStopwatch) {
+      stopwatch.setDuration(0);
+      stopwatch.start(millis() - c.state);
+    } else if (displayModes[mode].compose == displayCountdown) {
+      countdown.setDuration(GOLDEN_COUNTDOWN_MS);
+      countdown.start(millis() - c.state);
+    }
+  #endif
+  #if MARQUEE_ENABLED
+    // Clock text for the case's time and sensor values, c.state columns in
+    if (displayModes[mode].compose == displayMarquee) {
+      struct tm t = {};
+      t.tm_hour = c.hour24;
+      t.tm_min = c.minute;
+      t.tm_sec = c.second;
+      t.tm_mday = c.day;
+      t.tm_mon = c.month - 1;
+      t.tm_year = c.year - 1900;
+      t.tm_isdst = -1;
+      mktime(&t);  // Fills in the weekday
+      marqueeCustom = false;
+      buildMarqueeText(&t);
+      marqueePos = c.state % (marqueeTextCols + LINE_WIDTH);
+    }
+  #endif
+  displayModes[mode].compose();
+  return mode;
+}
+
+// Runs the suite and appends a JSON report to json. Returns number of failures.
+int runDisplaySelfTest(String& json) {
+  // Save everything the cases overwrite
+  int savedHours = hours, savedHours24 = hours24, savedMinutes = minutes, savedSeconds = seconds;
+  int savedDay = day, savedMonth = month, savedYear = year;
+  int savedTemperature = temperature, savedHumidity = humidity, savedPressure = pressure;
+  bool savedSensor = sensorAvailable, saved24h = use24HourFormat, savedFahrenheit = useFahrenheit;
+  int savedStyle = displayStyle;
+  #if LIFE_MODE_ENABLED
+    LifeAutomaton savedLife = life;
+    unsigned long savedLifeStepMs = lifeLastStepMs;
+  #endif
+  #if TIMER_MODES_ENABLED
+    Stopwatch savedStopwatch = stopwatch, savedCountdown = countdown;
+    int savedPrecision = timerPrecision;
+  #endif
+  #if MARQUEE_ENABLED
+    char savedMarqueeText[2][MARQUEE_MAX_TEXT];
+    memcpy(savedMarqueeText, marqueeText, sizeof(marqueeText));
+    bool savedMarqueeCustom = marqueeCustom;
+    int savedMarqueeCols = marqueeTextCols, savedMarqueePos = marqueePos;
+  #endif
+
+  int failures = 0;
+  int firstCase[numDisplayModes];  // Representative case per mode for the render check
+  for (int mode = 0; mode < numDisplayModes; mode++) firstCase[mode] = -1;
+
+  json += "{\"cases\":[";
+  bool first = true;
+  for (int i = 0; i < numGoldenCases; i++) {
+    GoldenCase c;
+    memcpy_P(&c, &goldenCases[i], sizeof(c));
+
+    unsigned long start = micros();
+    int mode = composeGoldenCase(c);
+    unsigned long composeUs = micros() - start;
+    if (mode < 0) continue;  // Mode compiled out
+    if (firstCase[mode] < 0) firstCase[mode] = i;
+
+    bool pass = memcmp(scr, c.frame, sizeof(scr)) == 0;
+    if (!pass) failures++;
+
+    if (!first) json += ",";
+    first = false;
+    char buf[112];
+    snprintf(buf, sizeof(buf), "{\"mode\":\"%s\",\"time\":\"%02d:%02d:%02d\",\"pass\":%s,\"compose_us\":%lu}",
+             c.mode, c.hour24, c.minute, c.second, pass ? "true" : "false", composeUs);
+    json += buf;
+    if (!pass) LOG(LOG_DISPLAY, LOG_WARN, "Self-test FAIL: %s at %02d:%02d:%02d", displayModes[mode].name, c.hour24, c.minute, c.second);
+  }
+
+  // Modes nobody wrote a golden for
+  json += "],\"untested\":[";
+  first = true;
+  for (int mode = 0; mode < numDisplayModes; mode++) {
+    if (firstCase[mode] >= 0) continue;
+    failures++;
+    if (!first) json += ",";
+    first = false;
+    json += "\"" + String(displayModes[mode].name) + "\"";
+    LOG(LOG_DISPLAY, LOG_WARN, "Self-test FAIL: no golden case for %s", displayModes[mode].name);
+  }
+
+  // Render cost: full redraw of each mode in each style
+  json += "],\"render\":[";
+  const unsigned long budgets[2] = {SELFTEST_BUDGET_DEFAULT_US, SELFTEST_BUDGET_REALISTIC_US};
+  first = true;
+  for (int style = 0; style <= 1; style++) {
+    displayStyle = style;
+    for (int mode = 0; mode < numDisplayModes; mode++) {
+      if (firstCase[mode] < 0) continue;
+      GoldenCase c;
+      memcpy_P(&c, &goldenCases[firstCase[mode]], sizeof(c));
+      composeGoldenCase(c);
+
+      forceFullRedraw = true;
+      unsigned long start = micros();
+      refreshAll();
+      unsigned long renderUs = micros() - start;
+      bool pass = renderUs <= budgets[style];
+      if (!pass) failures++;
+
+      if (!first) json += ",";
+      first = false;
+      char buf[112];
+      snprintf(buf, sizeof(buf), "{\"mode\":\"%s\",\"style\":%d,\"render_us\":%lu,\"budget_us\":%lu,\"pass\":%s}",
+               displayModes[mode].name, style, renderUs, budgets[style], pass ? "true" : "false");
+      json += buf;
+      yield();
+    }
+  }
+  json += "],\"failures\":" + String(failures) + "}";
+
+  // Restore live state and redraw
+  hours = savedHours; hours24 = savedHours24; minutes = savedMinutes; seconds = savedSeconds;
+  day = savedDay; month = savedMonth; year = savedYear;
+  temperature = savedTemperature; humidity = savedHumidity; pressure = savedPressure;
+  sensorAvailable = savedSensor; use24HourFormat = saved24h; useFahrenheit = savedFahrenheit;
+  displayStyle = savedStyle;
+  #if LIFE_MODE_ENABLED
+    life = savedLife;
+    lifeLastStepMs = savedLifeStepMs;
+  #endif
+  #if TIMER_MODES_ENABLED
+    stopwatch = savedStopwatch;
+    countdown = savedCountdown;
+    timerPrecision = savedPrecision;
+  #endif
+  #if MARQUEE_ENABLED
+    memcpy(marqueeText, savedMarqueeText, sizeof(marqueeText));
+    marqueeCustom = savedMarqueeCustom;
+    marqueeTextCols = savedMarqueeCols;
+    marqueePos = savedMarqueePos;
+  #endif
+  forceFullRedraw = true;
+  markDisplayDirty(DEP_ALL);
+  renderCurrentMode();
+
+  LOG(LOG_DISPLAY, failures ? LOG_WARN : LOG_INFO, "Display self-test: %d failure(s)", failures);
+  return failures;
+}
+
+#endif // DISPLAY_SELFTEST
+
+// ======================== SENSOR FUNCTIONS ========================
+
+bool testSensor() {
+  Wire.begin(SDA_PIN, SCL_PIN);
+  
+  if (!bme280.begin(0x76, &Wire)) {
+    DEBUG(Serial.println("BME280 sensor not found at 0x76"));
+    if (!bme280.begin(0x77, &Wire)) {
+      DEBUG(Serial.println("BME280 sensor not found at 0x77 either"));
+      return false;
+    }
+  }
+  
+  bme280.setSampling(Adafruit_BME280::MODE_FORCED,
+                     Adafruit_BME280::SAMPLING_X1,
+                     Adafruit_BME280::SAMPLING_X1,
+                     Adafruit_BME280::SAMPLING_X1,
+                     Adafruit_BME280::FILTER_OFF);
+  
+  float temp = bme280.readTemperature();
+  float hum = bme280.readHumidity();
+  
+  if (isnan(temp) || isnan(hum) || temp < -50 || temp > 100 || hum < 0 || hum > 100) {
+    DEBUG(Serial.println("BME280 readings invalid"));
+    return false;
+  }
+  
+  DEBUG(Serial.printf("BME280 OK: %.1f°C, %.1f%%\n", temp, hum));
+  return true;
+}
+
+void updateSensorData() {
+  if (!sensorAvailable) return;
+  LatencyProbe timing(latency, latSensor);
+  TRACE_SCOPE("updateSensorData");
+  
+  bme280.takeForcedMeasurement();
+  float temp = bme280.readTemperature();
+  float hum = bme280.readHumidity();
+  float pres = bme280.readPressure() / 100.0F;
+  
+  int oldTemperature = temperature, oldHumidity = humidity, oldPressure = pressure;
+  bool tempOk = !isnan(temp) && temp >= -50 && temp <= 100;
+  bool humOk = !isnan(hum) && hum >= 0 && hum <= 100;
+  bool presOk = !isnan(pres) && pres >= 800 && pres <= 1200;
+  sensorReads++;
+  if (!tempOk || !humOk || !presOk) sensorErrors++;
+  
+  if (tempOk) {
+    temperature = (int)round(temp);
+  }
+  
+  if (humOk) {
+    humidity = (int)round(hum);
+  }
+  
+  if (presOk) {
+    pressure = (int)round(pres);
+  }
+  
+  if (temperature != oldTemperature || humidity != oldHumidity || pressure != oldPressure) {
+    markDisplayDirty(DEP_SENSOR);
+  }
+
+  temperatureHistory[sensorHistoryCount % SENSOR_TREND_SAMPLES] = temperature;
+  humidityHistory[sensorHistoryCount % SENSOR_TREND_SAMPLES] = humidity;
+  sensorHistoryCount++;
+}
+
+// Change since the oldest reading still in the history (0 until it has two)
+int sensorTrend(const int* history) {
+  if (sensorHistoryCount < 2) return 0;
+  int newest = (sensorHistoryCount - 1) % SENSOR_TREND_SAMPLES;
+  int oldest = sensorHistoryCount > SENSOR_TREND_SAMPLES ? sensorHistoryCount % SENSOR_TREND_SAMPLES : 0;
+  return history[newest] - history[oldest];
+}
+
+// ======================== RTC MEMORY FUNCTIONS ========================
+
+uint32_t crc32(const uint8_t* data, size_t length) {
+  uint32_t crc = 0xFFFFFFFF;
+  while (length--) {
+    crc ^= *data++;
+    for (int i = 0; i < 8; i++) {
+      crc = (crc >> 1) ^ (0xEDB88320 & (0 - (crc & 1)));
+    }
+  }
+  return ~crc;
+}
+
+uint32_t rtcStateCrc(const RtcState& state) {
+  // Checksum everything after the crc field
+  const uint8_t* start = (const uint8_t*)&state + offsetof(RtcState, utc);
+  return crc32(start, sizeof(RtcState) - offsetof(RtcState, utc));
+}
+
+// Capture current time and settings into RTC user memory
+void saveRtcState() {
+  struct timeval tv;
+  gettimeofday(&tv, nullptr);
+  if (tv.tv_sec < 24 * 3600) return;  // Nothing worth saving until time is valid
+
+  RtcState state;
+  memset(&state, 0, sizeof(state));
+  state.magic = RTC_STATE_MAGIC;
+  state.utc = (uint32_t)tv.tv_sec;
+  state.utcMillis = (uint32_t)(tv.tv_usec / 1000);
+  state.driftPpm = clockDriftPpm;
+  state.lastNTPUtc = lastNTPUtc;
+  state.mode = (uint8_t)currentMode;
+  state.timezone = (uint8_t)currentTimezone;
+  state.style = (uint8_t)displayStyle;
+  state.flags = (use24HourFormat ? RTC_FLAG_24H : 0) |
+                (useFahrenheit ? RTC_FLAG_FAHRENHEIT : 0) |
+                (surroundMatchesLED ? RTC_FLAG_SURROUND_MATCH : 0);
+  state.ledColor = ledOnColor;
+  state.surroundColor = ledSurroundColor;
+  state.crc = rtcStateCrc(state);
+
+  ESP.rtcUserMemoryWrite(RTC_STATE_OFFSET, (uint32_t*)&state, sizeof(state));
+}
+
+// Restore time and settings from RTC user memory after a warm reset.
+// Returns false on cold boot (power-on garbage fails the magic/CRC check).
+bool restoreRtcState() {
+  // Only resets that follow straight on from running firmware. After deep
+  // sleep or the reset pin (button, serial auto-reset) the snapshot may be
+  // any age, so the time would be wrong until NTP
+  uint32_t reason = ESP.getResetInfoPtr()->reason;
+  if (reason != REASON_SOFT_RESTART && reason != REASON_WDT_RST &&
+      reason != REASON_EXCEPTION_RST && reason != REASON_SOFT_WDT_RST) {
+    DEBUG(Serial.printf("RTC memory: not restored after reset reason %u\n", reason));
+    return false;
+  }
+
+  RtcState state;
+  if (!ESP.rtcUserMemoryRead(RTC_STATE_OFFSET, (uint32_t*)&state, sizeof(state))) {
+    return false;
+  }
+  if (state.magic != RTC_STATE_MAGIC || state.crc != rtcStateCrc(state)) {
+    DEBUG(Serial.println("RTC memory: no valid snapshot (cold boot)"));
+    return false;
+  }
+
+  // Settings - validate ranges in case the layout changed between firmware versions
+  if (state.mode < numDisplayModes && displayModes[state.mode].dwellMs) {
+    currentMode = state.mode;  // Timer modes are not restored - their state is not saved
+  }
+  if (state.timezone < numTimezones) currentTimezone = state.timezone;
+  if (state.style <= 1) displayStyle = state.style;
+  use24HourFormat = (state.flags & RTC_FLAG_24H) != 0;
+  useFahrenheit = (state.flags & RTC_FLAG_FAHRENHEIT) != 0;
+  surroundMatchesLED = (state.flags & RTC_FLAG_SURROUND_MATCH) != 0;
+  ledOnColor = state.ledColor;
+  ledSurroundColor = state.surroundColor;
+  ledOffColor = ledOnColor >> 3;
+  clockDriftPpm = state.driftPpm;
+  lastNTPUtc = state.lastNTPUtc;
+
+  // Time - add the time spent booting since reset (millis() restarts at 0)
+  uint32_t bootMs = millis() + state.utcMillis;
+  struct timeval tv;
+  tv.tv_sec = state.utc + bootMs / 1000;
+  tv.tv_usec = (bootMs % 1000) * 1000;
+  setenv("TZ", timezones[currentTimezone].tzString, 1);
+  tzset();
+  settimeofday(&tv, nullptr);
+
+  DEBUG(Serial.printf("RTC memory: restored time %lu, mode %d, drift %ld ppm\n",
+                      (unsigned long)tv.tv_sec, currentMode, (long)clockDriftPpm));
+  return true;
+}
+
+// Called by the SNTP client each time it sets the system clock.
+// Compares elapsed millis() against elapsed NTP time to estimate oscillator drift.
+void onNTPTimeSet() {
+  static uint32_t prevUtcMs = 0;
+  static unsigned long prevMillis = 0;
+
+  struct timeval tv;
+  gettimeofday(&tv, nullptr);
+  unsigned long nowMillis = millis();
+  uint32_t utcMs = (uint32_t)tv.tv_sec * 1000UL + tv.tv_usec / 1000;  // Wraps, only deltas used
+
+  if (prevMillis != 0) {
+    int32_t ntpElapsed = (int32_t)(utcMs - prevUtcMs);
+    int32_t localElapsed = (int32_t)(nowMillis - prevMillis);
+    if (ntpElapsed > 60000) {  // Ignore back-to-back syncs, too short to measure
+      clockDriftPpm = (int32_t)((int64_t)(localElapsed - ntpElapsed) * 1000000LL / ntpElapsed);
+    }
+    ntpSyncDriftMs = ntpElapsed - localElapsed;
+  }
+  ntpSyncCount++;
+  prevUtcMs = utcMs;
+  prevMillis = nowMillis;
+  lastNTPUtc = (uint32_t)tv.tv_sec;
+
+  struct tm timeinfo;
+  time_t now = tv.tv_sec;
+  localtime_r(&now, &timeinfo);
+  LOG(LOG_NTP, LOG_INFO, "Time synced: %02d:%02d:%02d %02d/%02d/%d", timeinfo.tm_hour, timeinfo.tm_min,
+      timeinfo.tm_sec, timeinfo.tm_mday, timeinfo.tm_mon + 1, timeinfo.tm_year + 1900);
+  saveRtcState();
+  #if ALARMS_ENABLED
+    alarmsClockChanged = true;
+  #endif
+  #if FLEET_SYNC_ENABLED
+    fleetSync.clockStepped();  // Beacon offsets were measured against the old clock
+  #endif
+}
+
+// ======================== NTP SYNC FUNCTION ========================
+
+// Starts a sync and returns at once: onNTPTimeSet() logs the reply, and
+// ntpTimeoutTask() counts a failure if none came within NTP_SYNC_TIMEOUT
+void syncNTP() {
+  MemProbe probe(memStats, memSiteNTP);
+  LatencyProbe timing(latency, latNTP);
+  TRACE_SCOPE("syncNTP");
+  LOG(LOG_NTP, LOG_INFO, "Syncing time with NTP (%s)...", timezones[currentTimezone].name);
+
+  ntpSyncsBefore = ntpSyncCount;
+  configTime(timezones[currentTimezone].tzString, "pool.ntp.org", "time.nist.gov");
+  scheduler.runIn(taskNTPTimeout, NTP_SYNC_TIMEOUT);
+}
+
+// Only onNTPTimeSet() shows a server answered: time() is already valid
+// after the first sync or an RTC restore, so it proves nothing
+void ntpTimeoutTask() {
+  if (ntpSyncCount != ntpSyncsBefore) return;
+  ntpFailCount++;
+  LOG(LOG_NTP, LOG_WARN, "NTP sync failed: no reply within %u ms", (unsigned)NTP_SYNC_TIMEOUT);
+}
+
+// ======================== FLEET PHASE SYNC FUNCTIONS ========================
+
+// Wall clock the display ticks on: the local clock, shifted onto the
+// leader's while following a beacon
+void displayClock(struct timeval& tv) {
+  gettimeofday(&tv, nullptr);
+  #if FLEET_SYNC_ENABLED
+    int64_t offset = fleetSync.offsetUs();
+    if (offset != 0) {
+      int64_t us = (int64_t)tv.tv_sec * 1000000LL + tv.tv_usec + offset;
+      tv.tv_sec = us / 1000000LL;
+      tv.tv_usec = us % 1000000LL;
+    }
+  #endif
+}
+
+#if FLEET_SYNC_ENABLED
+const char* const fleetRoleNames[] = {"off", "leader", "follower"};
+
+void setFleetRole(int role) {
+  fleetRole = role;
+  fleetUdp.stop();
+  fleetSync.reset();
+  if (role == FLEET_FOLLOWER) {
+    fleetUdp.beginMulticast(WiFi.localIP(), IPAddress(FLEET_SYNC_GROUP), FLEET_SYNC_PORT);
+  }
+  scheduler.setActive(taskFleetSync, role == FLEET_FOLLOWER);
+  LOG(LOG_NTP, LOG_INFO, "Fleet sync role: %s", fleetRoleNames[role]);
+}
+
+// Leader: stamp the beacon with the time it actually leaves, not the nominal edge
+void sendFleetBeacon() {
+  uint8_t packet[PHASE_PKT_SIZE];
+  struct timeval tv;
+  gettimeofday(&tv, nullptr);
+  fleetSync.buildBeacon(packet, tv.tv_sec, tv.tv_usec);
+  fleetUdp.beginPacketMulticast(IPAddress(FLEET_SYNC_GROUP), FLEET_SYNC_PORT, WiFi.localIP());
+  fleetUdp.write(packet, sizeof(packet));
+  fleetUdp.endPacket();
+}
+
+String fleetStatusJson() {
+  IPAddress leader(fleetSync.leader());
+  return "{\"role\":\"" + String(fleetRoleNames[fleetRole]) + "\"" +
+         ",\"group\":\"" + IPAddress(FLEET_SYNC_GROUP).toString() + "\"" +
+         ",\"port\":" + String(FLEET_SYNC_PORT) +
+         ",\"locked\":" + String(fleetSync.isLocked() ? "true" : "false") +
+         ",\"leader\":\"" + (fleetSync.isLocked() ? leader.toString() : String("")) + "\"" +
+         ",\"offset_us\":" + String((long)fleetSync.offsetUs()) +
+         ",\"error_us\":" + String(fleetSync.errorUs()) +
+         ",\"max_error_us\":" + String(fleetSync.maxErrorUs()) +
+         ",\"spread_us\":" + String(fleetSync.spreadUs()) +
+         ",\"beacons\":" + String(fleetSync.beaconCount()) +
+         ",\"lost\":" + String(fleetSync.lostCount()) +
+         ",\"stale\":" + String(fleetSync.staleCount()) +
+         ",\"malformed\":" + String(fleetSync.malformedCount()) +
+         ",\"steps\":" + String(fleetSync.stepCount()) +
+         ",\"sent\":" + String(fleetSync.sentCount()) + "}";
+}
+#endif
+
+// ======================== ALARM FUNCTIONS ========================
+#if ALARMS_ENABLED
+
+uint32_t alarmStoreCrc(const AlarmStore& store) {
+  const uint8_t* start = (const uint8_t*)&store + offsetof(AlarmStore, count);
+  return crc32(start, sizeof(AlarmStore) - offsetof(AlarmStore, count));
+}
+
+void loadAlarms() {
+  AlarmStore store;
+  EEPROM.get(EEPROM_ALARM_ADDR, store);
+  if (store.magic != ALARM_STORE_MAGIC || store.crc != alarmStoreCrc(store)) {
+    LOG(LOG_SYS, LOG_INFO, "No stored alarms");
+    return;
+  }
+  alarms.load(store.alarms, store.count);
+  LOG(LOG_SYS, LOG_INFO, "Loaded %d alarms", alarms.count());
+}
+
+// Write the table after an edit or a fired one-off - a no-op otherwise
+void saveAlarms() {
+  if (!alarms.needsSave()) return;
+  AlarmStore store;
+  memset(&store, 0, sizeof(store));
+  store.magic = ALARM_STORE_MAGIC;
+  store.count = alarms.count();
+  memcpy(store.alarms, alarms.table(), alarms.count() * sizeof(Alarm));
+  store.crc = alarmStoreCrc(store);
+  EEPROM.put(EEPROM_ALARM_ADDR, store);
+  EEPROM.commit();
+  alarms.saved();
+  LOG(LOG_SYS, LOG_INFO, "Alarms saved (%d)", alarms.count());
+}
+
+// Rebuild the next-trigger index. Never earlier than the last alarm fired,
+// so a clock stepped back a few seconds by NTP can't repeat it.
+void reindexAlarms(time_t now) {
+  alarms.recompute(now > alarmLastFired ? now : alarmLastFired);
+  alarmsClockChanged = false;
+  time_t next = alarms.nextTrigger();
+  if (next == ALARM_NONE) {
+    LOG(LOG_SYS, LOG_DEBUG, "No alarm pending");
+    return;
+  }
+  struct tm t;
+  localtime_r(&next, &t);
+  LOG(LOG_SYS, LOG_INFO, "Next alarm %04d-%02d-%02d %02d:%02d",
+      t.tm_year + 1900, t.tm_mon + 1, t.tm_mday, t.tm_hour, t.tm_min);
+}
+
+void stopAlarmFlash() {
+  if (!alarmFlashing) return;
+  alarmFlashing = false;
+  alarmFlashInverted = false;
+  scheduler.setActive(taskAlarmFlash, false);
+  markDisplayDirty(DEP_ALL);
+  renderCurrentMode();
+}
+
+void fireAlarms(uint16_t due) {
+  for (int i = 0; i < alarms.count(); i++) {
+    if (!(due & (1U << i))) continue;
+    const Alarm& a = alarms.alarm(i);
+    LOG(LOG_SYS, LOG_INFO, "Alarm %d fired (%02d:%02d)", i, a.hour, a.minute);
+    if (a.action == ALARM_MODE) {
+      if (a.arg < numDisplayModes) setDisplayMode(a.arg);
+    } else {
+      alarmFlashUntil = millis() + (a.arg ? a.arg : ALARM_FLASH_SECONDS) * 1000UL;
+      alarmFlashing = true;
+      scheduler.setActive(taskAlarmFlash, true);
+    }
+  }
+}
+
+// Once per second from updateTime(): one comparison unless an alarm is due
+void checkAlarms(time_t now) {
+  time_t next = alarms.nextTrigger();
+  uint16_t due = alarms.poll(now);  // Before any reindex, so a small clock jump can't skip an alarm
+  if (due) {
+    alarmLastFired = next;
+    fireAlarms(due);
+  }
+  if (alarmsClockChanged) reindexAlarms(now);
+  saveAlarms();
+}
+
+static const char* const alarmDayNames[7] = {"sun", "mon", "tue", "wed", "thu", "fri", "sat"};
+
+// "YYYY-MM-DD" -> day number, -1 if malformed or out of the 16-bit range
+int32_t parseAlarmDate(const String& text) {
+  int y, m, d;
+  if (sscanf(text.c_str(), "%d-%d-%d", &y, &m, &d) != 3 || m < 1 || m > 12 || d < 1 || d > 31) return -1;
+  int32_t dayNum = AlarmSchedule::dayNumber(y, m, d);
+  return dayNum >= 0 && dayNum <= 0xFFFF ? dayNum : -1;
+}
+
+String formatAlarmDate(int32_t dayNum) {
+  int y, m, d;
+  AlarmSchedule::dayToDate(dayNum, y, m, d);
+  char buf[12];
+  snprintf(buf, sizeof(buf), "%04d-%02d-%02d", y, m, d);
+  return String(buf);
+}
+
+// Build an alarm from the request args of /api/alarms?add=1. Day rule is one of
+//   days=daily|weekdays|weekends|mon,wed,...   date=YYYY-MM-DD (one-off)
+//   pattern=11110000[&from=YYYY-MM-DD]         (shift rota, one digit per day)
+// Returns an error message, or nullptr on success.
+const char* parseAlarmArgs(Alarm& a) {
+  memset(&a, 0, sizeof(a));
+  int h, m;
+  if (sscanf(server.arg("time").c_str(), "%d:%d", &h, &m) != 2 || h < 0 || h > 23 || m < 0 || m > 59) {
+    return "time must be HH:MM";
+  }
+  a.hour = h;
+  a.minute = m;
+  a.flags = ALARM_ENABLED;
+
+  if (server.hasArg("date")) {
+    int32_t d = parseAlarmDate(server.arg("date"));
+    if (d < 0) return "date must be YYYY-MM-DD";
+    a.day = d;
+  } else if (server.hasArg("pattern")) {
+    String pattern = server.arg("pattern");
+    if (pattern.length() < 1 || pattern.length() > ALARM_MAX_CYCLE) return "pattern must be 1-32 digits of 0/1";
+    for (unsigned i = 0; i < pattern.length(); i++) {
+      if (pattern[i] == '1') a.mask |= 1UL << i;
+      else if (pattern[i] != '0') return "pattern must be 1-32 digits of 0/1";
+    }
+    a.cycle = pattern.length();
+    time_t now = time(nullptr);
+    struct tm t;
+    localtime_r(&now, &t);
+    int32_t from = server.hasArg("from") ? parseAlarmDate(server.arg("from"))
+                                         : AlarmSchedule::dayNumber(t.tm_year + 1900, t.tm_mon + 1, t.tm_mday);
+    if (from < 0) return "from must be YYYY-MM-DD";
+    a.day = from;
+  } else {
+    String days = server.hasArg("days") ? server.arg("days") : String("daily");
+    days.toLowerCase();
+    a.cycle = 7;
+    a.day = ALARM_SUNDAY;
+    if (days == "daily") {
+      a.cycle = 1;
+      a.day = 0;
+      a.mask = 1;
+    } else if (days == "weekdays") {
+      a.mask = 0x3E;
+    } else if (days == "weekends") {
+      a.mask = 0x41;
+    } else {
+      for (int i = 0; i < 7; i++) {
+        if (days.indexOf(alarmDayNames[i]) >= 0) a.mask |= 1UL << i;
+      }
+      if (a.mask == 0) return "days must be daily, weekdays, weekends or e.g. mon,wed,fri";
+    }
+  }
+
+  String action = server.arg("action");
+  if (action == "mode") {
+    a.action = ALARM_MODE;
+    if (!server.hasArg("arg") || server.arg("arg").toInt() < 0 || server.arg("arg").toInt() >= numDisplayModes) {
+      return "mode alarms need arg=<display mode index>";
+    }
+    a.arg = server.arg("arg").toInt();
+  } else if (action.length() == 0 || action == "flash") {
+    a.action = ALARM_FLASH;
+    a.arg = server.hasArg("arg") ? constrain(server.arg("arg").toInt(), 1L, 255L) : ALARM_FLASH_SECONDS;
+  } else {
+    return "action must be flash or mode";
+  }
+  return nullptr;
+}
+
+String alarmsJson() {
+  time_t next = alarms.nextTrigger();
+  String json = "{\"next\":" + (next == ALARM_NONE ? String("null") : String((uint32_t)next)) +
+                ",\"next_alarms\":" + String(alarms.nextAlarms()) +
+                ",\"flashing\":" + String(alarmFlashing ? "true" : "false") +
+                ",\"recomputes\":" + String(alarms.recomputeCount()) +
+                ",\"alarms\":[";
+  for (int i = 0; i < alarms.count(); i++) {
+    const Alarm& a = alarms.alarm(i);
+    char hhmm[8];
+    snprintf(hhmm, sizeof(hhmm), "%02d:%02d", a.hour, a.minute);
+    String rule;
+    if (a.cycle == 0) {
+      rule = "\"date\":\"" + formatAlarmDate(a.day) + "\"";
+    } else if (a.cycle == 7 && a.day == ALARM_SUNDAY) {
+      rule = "\"days\":\"";
+      for (int d = 0, n = 0; d < 7; d++) {
+        if (!(a.mask & (1UL << d))) continue;
+        if (n++) rule += ",";
+        rule += alarmDayNames[d];
+      }
+      rule += "\"";
+    } else if (a.cycle == 1) {
+      rule = "\"days\":\"daily\"";
+    } else {
+      rule = "\"pattern\":\"";
+      for (int d = 0; d < a.cycle; d++) rule += (a.mask & (1UL << d)) ? '1' : '0';
+      rule += "\",\"from\":\"" + formatAlarmDate(a.day) + "\"";
+    }
+    if (i) json += ",";
+    json += "{\"id\":" + String(i) + ",\"time\":\"" + String(hhmm) + "\"," + rule +
+            ",\"action\":\"" + String(a.action == ALARM_MODE ? "mode" : "flash") + "\"" +
+            ",\"arg\":" + String(a.arg) +
+            ",\"enabled\":" + String((a.flags & ALARM_ENABLED) ? "true" : "false") + "}";
+  }
+  json += "]}";
+  return json;
+}
+
+#endif
+
+// ======================== TIME UPDATE FUNCTION ========================
+
+void updateTime() {
+  LatencyProbe timing(latency, latUpdateTime);
+  TRACE_SCOPE("updateTime");
+  struct timeval tv;
+  displayClock(tv);
+  time_t now = tv.tv_sec;
+  if (now < 24 * 3600) return;
+  
+  struct tm timeinfo;
+  localtime_r(&now, &timeinfo);
+  
+  hours = timeinfo.tm_hour % 12;
+  if (hours == 0) hours = 12;
+  hours24 = timeinfo.tm_hour;
+  minutes = timeinfo.tm_min;
+  seconds = timeinfo.tm_sec;
+  day = timeinfo.tm_mday;
+  month = timeinfo.tm_mon + 1;
+  year = timeinfo.tm_year + 1900;
+  
+  if (seconds != lastSecond) {
+    lastSecond = seconds;
+    saveRtcState();  // ~40 bytes to RTC memory, a few microseconds
+    
+    uint8_t changed = DEP_SECOND;
+    if (minutes != lastMinute) {
+      lastMinute = minutes;
+      changed |= DEP_MINUTE;
+    }
+    markDisplayDirty(changed);
+    #if ALARMS_ENABLED
+      checkAlarms(now);
+    #endif
+    
+    // Auto-switch modes once the current one has been shown for its dwell time
+    const DisplayMode& shown = displayModes[currentMode];
+    if (shown.dwellMs && millis() - lastModeSwitch >= shown.dwellMs) {
+      setDisplayMode(nextRotationMode());
+    }
+    
+    renderCurrentMode();
+  }
+}
+
+// ======================== INFO PANEL FUNCTIONS ========================
+// Each formatter is called every INFO_PANEL_INTERVAL; the panel only draws
+// when the text differs from what is on screen, so keep the output coarse
+// (minutes, whole degrees) to keep redraws rare.
+
+void formatPanelIp(char* buf, size_t size) {
+  if (WiFi.status() != WL_CONNECTED) {
+    snprintf(buf, size, "WiFi offline");
+    return;
+  }
+  IPAddress ip = WiFi.localIP();
+  snprintf(buf, size, "IP %u.%u.%u.%u", ip[0], ip[1], ip[2], ip[3]);
+}
+
+void formatPanelSync(char* buf, size_t size) {
+  #if OTA_ENABLED
+    if (ota.active()) {
+      int pct = ota.percent();
+      if (pct >= 0) snprintf(buf, size, "OTA %d%% %uKB/s", pct, ota.bytesPerSecond() / 1024);
+      else snprintf(buf, size, "OTA %uKB %uKB/s", ota.receivedBytes() / 1024, ota.bytesPerSecond() / 1024);
+      return;
+    }
+  #endif
+  if (lastNTPUtc == 0) {
+    snprintf(buf, size, "NTP not synced");
+    return;
+  }
+  long age = (long)(time(nullptr) - lastNTPUtc) / 60;
+  if (age < 1) snprintf(buf, size, "NTP synced");
+  else if (age < 120) snprintf(buf, size, "NTP %ldm ago", age);
+  else snprintf(buf, size, "NTP %ldh ago", age / 60);
+}
+
+// "23C +1  45% -2" - change over the trend window, omitted when flat
+void formatPanelSensor(char* buf, size_t size) {
+  if (!sensorAvailable) {
+    snprintf(buf, size, "No sensor");
+    return;
+  }
+  int temp = useFahrenheit ? (temperature * 9 / 5 + 32) : temperature;
+  int tempTrend = sensorTrend(temperatureHistory);
+  if (useFahrenheit) tempTrend = tempTrend * 9 / 5;
+  int humTrend = sensorTrend(humidityHistory);
+
+  int n = snprintf(buf, size, "%d%c", temp, useFahrenheit ? 'F' : 'C');
+  if (tempTrend) n += snprintf(buf + n, size - n, " %+d", tempTrend);
+  n += snprintf(buf + n, size - n, "  %d%%", humidity);
+  if (humTrend) snprintf(buf + n, size - n, " %+d", humTrend);
+}
+
+// "Alarm Mon 07:30" within the next six days, "Alarm 24 Dec 07:30" beyond
+void formatPanelAlarm(char* buf, size_t size) {
+  #if ALARMS_ENABLED
+    if (alarmFlashing) {
+      snprintf(buf, size, "ALARM");
+      return;
+    }
+    time_t next = alarms.nextTrigger();
+    if (next != ALARM_NONE) {
+      struct tm t;
+      localtime_r(&next, &t);
+      bool soon = next - time(nullptr) < 6 * 86400L;
+      if (use24HourFormat) strftime(buf, size, soon ? "Alarm %a %H:%M" : "Alarm %d %b %H:%M", &t);
+      else strftime(buf, size, soon ? "Alarm %a %I:%M%p" : "Alarm %d %b %I:%M%p", &t);
+      return;
+    }
+  #endif
+  snprintf(buf, size, "No alarm set");
+}
+
+void invalidateInfoPanel() {
+  #if INFO_PANEL_ENABLED
+    infoPanel.invalidate();
+  #endif
+}
+
+#if INFO_PANEL_ENABLED
+// Two fields in each band around the centred matrix. Returns false if the
+// bands are too small for the font (e.g. a taller LED_SIZE).
+bool initInfoPanel() {
+  int band = (tft.height() - DISPLAY_HEIGHT) / 2;
+  int fontH = tft.fontHeight(INFO_PANEL_FONT);
+  if (band < fontH) {
+    LOG(LOG_DISPLAY, LOG_WARN, "Info panel disabled - %dpx band, font needs %d", band, fontH);
+    return false;
+  }
+  int half = tft.width() / 2 - 4;
+  int topY = (band - fontH) / 2;
+  int bottomY = tft.height() - band + topY;
+  infoPanel.addField("ip", formatPanelIp, 4, topY, half, INFO_PANEL_FONT, TL_DATUM);
+  infoPanel.addField("sync", formatPanelSync, tft.width() - 4, topY, half, INFO_PANEL_FONT, TR_DATUM);
+  infoPanel.addField("sensor", formatPanelSensor, 4, bottomY, half, INFO_PANEL_FONT, TL_DATUM);
+  infoPanel.addField("alarm", formatPanelAlarm, tft.width() - 4, bottomY, half, INFO_PANEL_FONT, TR_DATUM);
+  return true;
+}
+#endif
+
+// ======================== STOPWATCH / COUNTDOWN CONTROL ========================
+#if TIMER_MODES_ENABLED
+// Put sw on screen and make it the target of start/stop/reset
+void showTimer(Stopwatch& sw) {
+  activeTimer = &sw;
+  void (*compose)() = (&sw == &countdown) ? displayCountdown : displayStopwatch;
+  for (int i = 0; i < numDisplayModes; i++) {
+    if (displayModes[i].compose == compose && i != currentMode) setDisplayMode(i);
+  }
+}
+
+// Verbs of timerCommand(), in switch order. Logged from here: EventLog
+// keeps the %s pointer, and the caller's verb is a request/packet buffer.
+const char* const timerVerbs[] = {"stopwatch", "countdown", "start", "stop", "toggle",
+                                  "reset", "hz", "precision", "clock"};
+
+// Shared by /api/timer and the UDP socket. Returns false for an unknown verb.
+bool timerCommand(const char* verb, long arg) {
+  int v = 0;
+  const int numVerbs = sizeof(timerVerbs) / sizeof(timerVerbs[0]);
+  while (v < numVerbs && strcmp(verb, timerVerbs[v]) != 0) v++;
+
+  uint32_t now = millis();
+  switch (v) {
+    case 0:  // stopwatch
+      showTimer(stopwatch);
+      break;
+    case 1:  // countdown
+      if (arg > 0) countdown.setDuration(constrain(arg, 1L, 359999L) * 1000UL);
+      showTimer(countdown);
+      break;
+    case 2:  // start
+      activeTimer->start(now);
+      showTimer(*activeTimer);
+      break;
+    case 3:  // stop
+      activeTimer->stop(now);
+      break;
+    case 4:  // toggle
+      activeTimer->toggle(now);
+      showTimer(*activeTimer);
+      break;
+    case 5:  // reset
+      activeTimer->reset();
+      break;
+    case 6:  // hz
+      timerRefreshHz = constrain(arg, 10L, 100L);
+      scheduler.setPeriod(taskTimer, 1000 / timerRefreshHz);
+      timerMeter.reset(1000000UL / timerRefreshHz);
+      timerChangedBytes = 0;
+      break;
+    case 7:  // precision
+      timerPrecision = arg == 1 ? 1 : 2;
+      break;
+    case 8:  // clock
+      setDisplayMode(0);
+      break;
+    default:
+      return false;
+  }
+  LOG(LOG_DISPLAY, LOG_DEBUG, "Timer command: %s %ld", timerVerbs[v], arg);
+  markDisplayDirty(DEP_TIMER);
+  return true;
+}
+
+// Timer state plus achieved frame rate / jitter of the current timer session
+String timerStatusJson() {
+  uint32_t frames = timerMeter.frameCount();
+  String json = "{\"timer\":\"" + String(activeTimer == &countdown ? "countdown" : "stopwatch") + "\"" +
+                ",\"shown\":" + String((displayModes[currentMode].deps & DEP_TIMER) ? "true" : "false") +
+                ",\"running\":" + String(activeTimer->isRunning() ? "true" : "false") +
+                ",\"expired\":" + String(activeTimer->isExpired() ? "true" : "false") +
+                ",\"value_ms\":" + String(activeTimer->value(millis())) +
+                ",\"countdown_ms\":" + String(countdown.durationMs()) +
+                ",\"precision\":" + String(timerPrecision) +
+                ",\"target_hz\":" + String(timerRefreshHz) +
+                ",\"achieved_hz\":" + String(timerMeter.rateHzX10() / 10.0f, 1) +
+                ",\"jitter_us\":" + String(timerMeter.jitterUs()) +
+                ",\"min_interval_us\":" + String(timerMeter.minIntervalUs()) +
+                ",\"max_interval_us\":" + String(timerMeter.maxIntervalUs()) +
+                ",\"frames\":" + String(frames) +
+                ",\"render_avg_us\":" + String(timerMeter.avgRenderUs()) +
+                ",\"render_max_us\":" + String(timerMeter.maxRenderUs()) +
+                ",\"bytes_per_frame\":" + String(frames ? (float)timerChangedBytes / frames : 0.0f, 1) + "}";
+  return json;
+}
+#endif
+
+// ======================== METRICS ========================
+// Prometheus text format for /metrics, formatted line by line into one
+// static buffer that goes out as an HTTP chunk whenever it fills
+#if METRICS_ENABLED
+char metricsBuffer[METRICS_BUFFER_SIZE];
+uint32_t metricsScrapeUs = 0;     // Duration of the previous scrape
+uint32_t metricsScrapeBytes = 0;
+
+void sendMetricsChunk(const char* data, size_t len, void*) {
+  server.sendContent(data, len);
+}
+
+// Latency histogram as a cumulative Prometheus histogram (bucket i = [2^i, 2^(i+1)) us)
+void writeLatencyHistogram(MetricsWriter& m, const char* name, const LatencyHistogram& h) {
+  uint64_t cumulative = 0;
+  for (int i = 0; i < LAT_BUCKETS - 1; i++) {
+    cumulative += h.buckets[i];
+    m.bucket(name, 2ULL << i, cumulative);
+  }
+  m.bucket(name, 0, h.count);
+  char series[64];
+  snprintf(series, sizeof(series), "%s_sum", name);
+  m.sample(series, h.totalUs);
+  snprintf(series, sizeof(series), "%s_count", name);
+  m.sample(series, h.count);
+}
+
+void writeMetrics(MetricsWriter& m) {
+  HeapSample heap = memStats.sample();
+
+  m.family("retroclock_uptime_seconds", "gauge", "Seconds since boot");
+  m.sample("retroclock_uptime_seconds", micros64() / 1000000ULL);
+  m.family("retroclock_heap_free_bytes", "gauge", "Free heap");
+  m.sample("retroclock_heap_free_bytes", heap.freeHeap);
+  m.family("retroclock_heap_max_block_bytes", "gauge", "Largest free heap block");
+  m.sample("retroclock_heap_max_block_bytes", heap.maxBlock);
+  m.family("retroclock_heap_fragmentation_percent", "gauge", "Heap fragmentation");
+  m.sample("retroclock_heap_fragmentation_percent", heap.fragmentation);
+
+  m.family("retroclock_frames_rendered_total", "counter", "Frames pushed to the display sinks");
+  m.sample("retroclock_frames_rendered_total", framesRendered);
+  m.family("retroclock_leds_pushed_total", "counter", "LED cells redrawn on the TFT");
+  m.sample("retroclock_leds_pushed_total", ledsPushed);
+  m.family("retroclock_spi_bytes_total", "counter", "Bytes sent to the TFT for LED cells (upper bound)");
+  m.sample("retroclock_spi_bytes_total", tftSink.spiBytes());
+  #if SPI_CAL_ENABLED
+    m.family("retroclock_spi_clock_hz", "gauge", "TFT SPI write clock in use");
+    m.sample("retroclock_spi_clock_hz", spiClockHz);
+    m.family("retroclock_full_redraw_microseconds", "gauge", "Last full matrix redraw measured at that clock (0 = not measured)");
+    m.sample("retroclock_full_redraw_microseconds", spiRedrawUs);
+  #endif
+
+  m.family("retroclock_loop_latency_microseconds", "histogram", "loop() iteration time");
+  writeLatencyHistogram(m, "retroclock_loop_latency_microseconds", latency.site(0));  // Site 0 = loop
+  m.family("retroclock_loop_stalls_total", "counter", "loop() iterations over the stall threshold");
+  m.sample("retroclock_loop_stalls_total", latency.totalStalls());
+
+  m.family("retroclock_ntp_syncs_total", "counter", "Times NTP set the clock");
+  m.sample("retroclock_ntp_syncs_total", ntpSyncCount);
+  m.family("retroclock_ntp_failures_total", "counter", "NTP syncs with no reply within the timeout");
+  m.sample("retroclock_ntp_failures_total", ntpFailCount);
+  m.family("retroclock_ntp_drift_milliseconds", "gauge", "NTP minus local elapsed time between the last two syncs");
+  m.sampleSigned("retroclock_ntp_drift_milliseconds", ntpSyncDriftMs);
+  m.family("retroclock_ntp_last_sync_timestamp_seconds", "gauge", "UTC of the last NTP sync (0 = never)");
+  m.sample("retroclock_ntp_last_sync_timestamp_seconds", lastNTPUtc);
+  m.family("retroclock_clock_drift_ppm", "gauge", "Local oscillator drift vs NTP");
+  m.sampleSigned("retroclock_clock_drift_ppm", clockDriftPpm);
+
+  m.family("retroclock_sensor_reads_total", "counter", "BME280 readings taken");
+  m.sample("retroclock_sensor_reads_total", sensorReads);
+  m.family("retroclock_sensor_errors_total", "counter", "BME280 readings with a missing or out-of-range value");
+  m.sample("retroclock_sensor_errors_total", sensorErrors);
+  if (sensorAvailable) {
+    m.family("retroclock_temperature_celsius", "gauge", "Last temperature reading");
+    m.sampleSigned("retroclock_temperature_celsius", temperature);
+    m.family("retroclock_humidity_percent", "gauge", "Last humidity reading");
+    m.sample("retroclock_humidity_percent", humidity);
+    m.family("retroclock_pressure_hpa", "gauge", "Last pressure reading");
+    m.sample("retroclock_pressure_hpa", pressure);
+  }
+
+  m.family("retroclock_http_requests_total", "counter", "Requests handled per path");
+  for (int i = 0; i < memStats.count(); i++) {
+    const MemSite& site = memStats.site(i);
+    if (site.name[0] == '/') m.sample("retroclock_http_requests_total", "path", site.name, site.calls);
+  }
+
+  m.family("retroclock_wifi_rssi_dbm", "gauge", "Signal strength of the current AP");
+  m.sampleSigned("retroclock_wifi_rssi_dbm", WiFi.status() == WL_CONNECTED ? WiFi.RSSI() : 0);
+  m.family("retroclock_wifi_reconnects_total", "counter", "Times the station got an IP again after the first connect");
+  m.sample("retroclock_wifi_reconnects_total", wifiConnects > 0 ? wifiConnects - 1 : 0);
+
+  #if MQTT_ENABLED
+    m.family("retroclock_mqtt_connected", "gauge", "1 while connected to the MQTT broker");
+    m.sample("retroclock_mqtt_connected", mqtt.connected() ? 1 : 0);
+    m.family("retroclock_mqtt_queued_samples", "gauge", "Telemetry samples waiting to be published");
+    m.sample("retroclock_mqtt_queued_samples", telemetry.queued());
+    m.family("retroclock_mqtt_dropped_samples_total", "counter", "Samples overwritten while the queue was full");
+    m.sample("retroclock_mqtt_dropped_samples_total", telemetry.droppedCount());
+    m.family("retroclock_mqtt_batches_total", "counter", "Telemetry batches acknowledged by the broker");
+    m.sample("retroclock_mqtt_batches_total", telemetry.batchCount());
+    m.family("retroclock_mqtt_publish_latency_milliseconds", "gauge", "Publish-to-ack time of the last batch");
+    m.sample("retroclock_mqtt_publish_latency_milliseconds", telemetry.lastLatencyMs());
+  #endif
+
+  m.family("retroclock_metrics_scrape_microseconds", "gauge", "Time taken by the previous /metrics scrape");
+  m.sample("retroclock_metrics_scrape_microseconds", metricsScrapeUs);
+  m.family("retroclock_metrics_scrape_bytes", "gauge", "Size of the previous /metrics response");
+  m.sample("retroclock_metrics_scrape_bytes", metricsScrapeBytes);
+}
+#endif
+
+// ======================== MQTT TELEMETRY FUNCTIONS ========================
+#if MQTT_ENABLED
+// AsyncMqttClient callbacks run from the network stack whenever the loop
+// task yields - delay() or yield() inside a task as well as between loop()
+// iterations - so they only record acks and drops; serviceMqtt() applies
+// them to the telemetry queue
+void setupMqtt() {
+  snprintf(mqttClientId, sizeof(mqttClientId), "retroclock-%06x", ESP.getChipId());
+  snprintf(mqttTopic, sizeof(mqttTopic), "%s/%06x/telemetry", MQTT_TOPIC_PREFIX, ESP.getChipId());
+  snprintf(mqttStatusTopic, sizeof(mqttStatusTopic), "%s/%06x/status", MQTT_TOPIC_PREFIX, ESP.getChipId());
+  mqttBackoff.seed(ESP.getChipId());
+
+  mqtt.setServer(MQTT_HOST, MQTT_PORT);
+  mqtt.setClientId(mqttClientId);
+  if (strlen(MQTT_USER) > 0) mqtt.setCredentials(MQTT_USER, MQTT_PASSWORD);
+  mqtt.setWill(mqttStatusTopic, 1, true, "offline");
+
+  mqtt.onConnect([](bool) {
+    mqttConnecting = false;
+    mqttConnects++;
+    mqttBackoff.succeeded();
+    mqtt.publish(mqttStatusTopic, 1, true, "online");
+    mqttLastBatch = millis() - MQTT_BATCH_INTERVAL;  // Flush the backlog now
+    LOG(LOG_WIFI, LOG_INFO, "MQTT connected to %s:%d, %u samples queued", MQTT_HOST, MQTT_PORT, telemetry.queued());
+  });
+  mqtt.onDisconnect([](AsyncMqttClientDisconnectReason reason) {
+    if (!mqttConnecting) mqttDisconnects++;
+    mqttConnecting = false;
+    mqttLastReason = (int)reason;
+    mqttDropped = true;  // Unacknowledged batch goes out again after reconnecting
+    mqttBackoff.failed(millis());
+    LOG(LOG_WIFI, LOG_WARN, "MQTT disconnected (reason %d), retry in %ums", (int)reason, mqttBackoff.waitMs(millis()));
+  });
+  mqtt.onPublish([](uint16_t packetId) {
+    mqttAckedMs = millis();
+    mqttAckedId = packetId;  // One batch in flight at a time
+  });
+}
+
+void sampleTelemetry() {
+  time_t now = time(nullptr);
+  if (now < 24 * 3600) return;  // No valid clock yet
+  TelemetrySample s;
+  s.time = now;
+  s.ntpAge = lastNTPUtc ? (uint32_t)(now - lastNTPUtc) : TELEMETRY_NEVER;
+  s.heap = ESP.getFreeHeap();
+  s.temp = sensorAvailable ? temperature : TELEMETRY_NO_VALUE;
+  s.hum = sensorAvailable ? humidity : TELEMETRY_NO_VALUE;
+  s.pres = sensorAvailable ? pressure : TELEMETRY_NO_VALUE;
+  s.rssi = WiFi.status() == WL_CONNECTED ? WiFi.RSSI() : 0;
+  s.load = scheduler.loadPercent();
+  telemetry.push(s);
+}
+
+// Connect/publish step: every call returns at once, the client works in the background
+void serviceMqtt() {
+  uint32_t now = millis();
+  if (mqttAckedId) {
+    telemetry.acked(mqttAckedId, mqttAckedMs);
+    mqttAckedId = 0;
+  }
+  if (mqttDropped) {
+    mqttDropped = false;
+    telemetry.requeue();
+  }
+  if (!mqtt.connected()) {
+    if (mqttConnecting) {
+      if (now - mqttConnectStart >= MQTT_CONNECT_TIMEOUT) {
+        mqtt.disconnect(true);  // onDisconnect backs off
+      }
+    } else if (WiFi.status() == WL_CONNECTED && mqttBackoff.due(now)) {
+      mqttConnecting = true;
+      mqttConnectStart = now;
+      mqttAttempts++;
+      mqtt.connect();
+    }
+    return;
+  }
+
+  if (telemetry.ackOverdue(now, MQTT_ACK_TIMEOUT)) telemetry.requeue();
+  if (telemetry.busy() || telemetry.queued() == 0) return;
+  if (telemetry.queued() < TELEMETRY_BATCH_MAX && now - mqttLastBatch < MQTT_BATCH_INTERVAL) return;
+  size_t len = telemetry.takeBatch(mqttPayload, sizeof(mqttPayload), mqttClientId, now);
+  if (len == 0) return;
+  telemetry.sent(mqtt.publish(mqttTopic, 1, false, mqttPayload, len));  // QoS 1: acked via onPublish
+  mqttLastBatch = now;
+}
+
+String mqttStatusJson() {
+  return "{\"broker\":\"" + String(MQTT_HOST) + ":" + String(MQTT_PORT) + "\"" +
+         ",\"topic\":\"" + String(mqttTopic) + "\"" +
+         ",\"connected\":" + String(mqtt.connected() ? "true" : "false") +
+         ",\"queued\":" + String(telemetry.queued()) +
+         ",\"capacity\":" + String(telemetry.capacity()) +
+         ",\"dropped\":" + String(telemetry.droppedCount()) +
+         ",\"batches\":" + String(telemetry.batchCount()) +
+         ",\"samples_published\":" + String(telemetry.samplesPublished()) +
+         ",\"requeued\":" + String(telemetry.requeueCount()) +
+         ",\"publish_latency_ms\":{\"last\":" + String(telemetry.lastLatencyMs()) +
+         ",\"avg\":" + String(telemetry.avgLatencyMs()) +
+         ",\"max\":" + String(telemetry.maxLatencyMs()) + "}" +
+         ",\"connect_attempts\":" + String(mqttAttempts) +
+         ",\"connects\":" + String(mqttConnects) +
+         ",\"disconnects\":" + String(mqttDisconnects) +
+         ",\"last_disconnect_reason\":" + String(mqttLastReason) +
+         ",\"backoff_ms\":" + String(mqttBackoff.currentMs()) +
+         ",\"retry_in_ms\":" + String(mqtt.connected() ? 0 : mqttBackoff.waitMs(millis())) +
+         ",\"max_service_us\":" + String(mqttMaxServiceUs) + "}";
+}
+#endif
+
+// ======================== OTA UPDATE FUNCTIONS ========================
+#if OTA_ENABLED
+// Thin bar along the bottom edge (only when the size was declared)
+void drawOtaProgress() {
+  int pct = ota.percent();
+  if (pct < 0) return;
+  tft.fillRect(0, tft.height() - OTA_BAR_HEIGHT, tft.width() * pct / 100, OTA_BAR_HEIGHT, ledOnColor);
+}
+
+// handleClient() owns the loop until the whole upload has arrived, so the
+// clock and the progress display are driven from here between pieces
+void otaTick() {
+  static unsigned long lastDraw = 0;
+  updateTime();  // Renders on each second edge as usual
+  if (millis() - lastDraw >= OTA_PROGRESS_INTERVAL && !tftSink.isScrolling()) {
+    lastDraw = millis();
+    drawOtaProgress();
+    #if INFO_PANEL_ENABLED
+      infoPanel.update(INFO_PANEL_BUDGET_US);
+    #endif
+  }
+}
+
+// Anyone on the network could otherwise flash the clock
+bool otaAuthorized() {
+  return strlen(OTA_PASSWORD) > 0 && server.authenticate(OTA_USERNAME, OTA_PASSWORD);
+}
+
+void handleOtaUpload() {
+  HTTPUpload& upload = server.upload();
+  if (upload.status == UPLOAD_FILE_START) {
+    if (!otaAuthorized()) {
+      ota.reject(strlen(OTA_PASSWORD) ? "unauthorized" : "OTA_PASSWORD not set", millis());
+      LOG(LOG_SYS, LOG_WARN, "OTA rejected: %s", ota.error());
+      return;
+    }
+    uint32_t maxSize = (ESP.getFreeSketchSpace() - 0x1000) & 0xFFFFF000;
+    if (ota.begin(server.arg("size").toInt(), maxSize, server.arg("md5").c_str(), millis())) {
+      LOG(LOG_SYS, LOG_INFO, "OTA started (max %u bytes)", maxSize);
+    } else {
+      LOG(LOG_SYS, LOG_WARN, "OTA rejected: %s", ota.error());
+    }
+  } else if (upload.status == UPLOAD_FILE_WRITE) {
+    ota.feed(upload.buf, upload.currentSize, millis());
+    otaTick();
+  } else if (upload.status == UPLOAD_FILE_END) {
+    if (ota.finish(millis())) {
+      LOG(LOG_SYS, LOG_INFO, "OTA verified: %u bytes in %ums", ota.writtenBytes(), ota.elapsedMs());
+    } else if (ota.status() == OTA_FAILED) {
+      LOG(LOG_SYS, LOG_WARN, "OTA failed: %s", ota.error());
+    }
+  } else if (upload.status == UPLOAD_FILE_ABORTED) {
+    ota.abort(millis());
+    LOG(LOG_SYS, LOG_WARN, "OTA upload aborted");
+  }
+}
+
+String otaStatusJson() {
+  static const char* const states[] = {"idle", "receiving", "done", "failed"};
+  return "{\"state\":\"" + String(states[ota.status()]) + "\"" +
+         ",\"error\":\"" + String(ota.error()) + "\"" +
+         ",\"writer_error\":" + String(ota.writerError()) +
+         ",\"received\":" + String(ota.receivedBytes()) +
+         ",\"written\":" + String(ota.writtenBytes()) +
+         ",\"chunks\":" + String(ota.chunkCount()) +
+         ",\"chunk_size\":" + String(OTA_CHUNK_SIZE) +
+         ",\"percent\":" + String(ota.percent()) +
+         ",\"elapsed_ms\":" + String(ota.elapsedMs()) +
+         ",\"bytes_per_sec\":" + String(ota.bytesPerSecond()) +
+         ",\"max_chunk_write_us\":" + String(ota.maxChunkUs()) + "}";
+}
+#endif
+
+// ======================== SPI CLOCK CALIBRATION FUNCTIONS ========================
+#if SPI_CAL_ENABLED
+static_assert(SPI_CAL_PIXELS % SPI_CAL_BLOCK_WIDTH == 0, "SPI_CAL_PIXELS must fill whole rows of the test block");
+
+void TftCalPanel::setClock(uint32_t clock) {
+  hz = clock;
+  SPI.setFrequency(clock);
+}
+
+void TftCalPanel::writePixels(const uint16_t* px, int n) {
+  tft.pushImage(0, 0, SPI_CAL_BLOCK_WIDTH, n / SPI_CAL_BLOCK_WIDTH, (uint16_t*)px);
+}
+
+// TFT_eSPI reads at SPI_READ_FREQUENCY and then switches back to
+// SPI_FREQUENCY, so the clock under test is put back afterwards
+bool TftCalPanel::readPixels(uint16_t* px, int n) {
+  tft.readRect(0, 0, SPI_CAL_BLOCK_WIDTH, n / SPI_CAL_BLOCK_WIDTH, px);
+  SPI.setFrequency(hz);
+  return true;
+}
+
+// Every LED cell redrawn with whatever is on screen now
+uint32_t TftCalPanel::redrawUs() {
+  forceFullRedraw = true;
+  unsigned long start = micros();
+  refreshAll();
+  return micros() - start;
+}
+
+void applySpiClock(uint32_t hz, uint8_t source) {
+  spiCalPanel.setClock(hz);
+  spiClockHz = hz;
+  spiClockSource = source;
+}
+
+uint32_t spiCalStoreCrc(const SpiCalStore& store) {
+  const uint8_t* start = (const uint8_t*)&store + offsetof(SpiCalStore, hz);
+  return crc32(start, sizeof(SpiCalStore) - offsetof(SpiCalStore, hz));
+}
+
+void loadSpiClock() {
+  SpiCalStore store;
+  EEPROM.get(EEPROM_SPI_CAL_ADDR, store);
+  if (store.magic != SPI_CAL_STORE_MAGIC || store.crc != spiCalStoreCrc(store) || store.hz == 0) {
+    LOG(LOG_DISPLAY, LOG_INFO, "No stored SPI clock, using %u Hz", (unsigned)SPI_FREQUENCY);
+    return;
+  }
+  applySpiClock(store.hz, store.source);
+  spiRedrawUs = store.redrawUs;
+  LOG(LOG_DISPLAY, LOG_INFO, "SPI clock %u Hz (stored), full redraw %u us", store.hz, store.redrawUs);
+}
+
+void saveSpiClock() {
+  SpiCalStore store;
+  memset(&store, 0, sizeof(store));
+  store.magic = SPI_CAL_STORE_MAGIC;
+  store.hz = spiClockHz;
+  store.redrawUs = spiRedrawUs;
+  store.source = spiClockSource;
+  store.crc = spiCalStoreCrc(store);
+  EEPROM.put(EEPROM_SPI_CAL_ADDR, store);
+  EEPROM.commit();
+}
+
+// Back to SPI_FREQUENCY; the next cold boot calibrates again (SPI_CAL_AT_BOOT)
+void clearSpiClock() {
+  SpiCalStore store;
+  memset(&store, 0, sizeof(store));
+  EEPROM.put(EEPROM_SPI_CAL_ADDR, store);
+  EEPROM.commit();
+  applySpiClock(SPI_FREQUENCY, SPI_CLOCK_DEFAULT);
+  spiRedrawUs = 0;
+  LOG(LOG_DISPLAY, LOG_INFO, "SPI clock reset to %u Hz", (unsigned)SPI_FREQUENCY);
+}
+
+void clearSpiTestBlock() {
+  tft.fillRect(0, 0, SPI_CAL_BLOCK_WIDTH, SPI_CAL_PIXELS / SPI_CAL_BLOCK_WIDTH, BG_COLOR);
+  invalidateInfoPanel();  // The block sits in the top band
+}
+
+// A clock that corrupted pixels may have corrupted command bytes too
+// (MADCTL, the address window, the scroll area): initialise the controller
+// again and redraw everything at the clock now in use
+void resetTftAfterBadClock() {
+  tft.init();
+  tft.setRotation(3);
+  spiCalPanel.setClock(spiClockHz);  // init() went back to SPI_FREQUENCY
+  tftSink.panelReset();
+  tft.fillScreen(BG_COLOR);
+  invalidateInfoPanel();
+  forceFullRedraw = true;
+  refreshAll();
+}
+
+// Try every SPI_CAL_CLOCKS entry and keep the fastest that reads back
+// clean. Returns 0 (clock unchanged, nothing stored) without a read path.
+uint32_t calibrateSpiClock() {
+  const int n = sizeof(spiCalClocks) / sizeof(spiCalClocks[0]);
+  uint32_t chosen = spiCal.run(spiCalClocks, n, spiClockHz);
+  if (chosen) applySpiClock(chosen, SPI_CLOCK_CALIBRATED);
+  if (spiCal.anyFailed()) {
+    resetTftAfterBadClock();
+  } else {
+    clearSpiTestBlock();
+  }
+  if (!chosen) {
+    LOG(LOG_DISPLAY, LOG_WARN, "SPI calibration: no clean read-back at %u Hz (MISO wired?), keeping %u Hz",
+        spiCalClocks[0], spiClockHz);
+    return 0;
+  }
+  spiRedrawUs = spiCal.chosenRedrawUs();
+  saveSpiClock();
+  LOG(LOG_DISPLAY, LOG_INFO, "SPI clock calibrated: %u Hz, full redraw %u us (%u ms)",
+      chosen, spiRedrawUs, spiCal.durationMs());
+  return chosen;
+}
+
+String spiStatusJson() {
+  static const char* const sources[] = {"default", "calibrated", "manual", "unverified"};
+  String clocks;
+  for (int i = 0; i < spiCal.trialCount(); i++) {
+    const SpiClockTrial& t = spiCal.result(i);
+    if (i) clocks += ",";
+    clocks += "{\"hz\":" + String(t.hz) +
+              ",\"errors\":" + String(t.errors) +
+              ",\"pixels\":" + String(t.pixels) +
+              ",\"redraw_us\":" + String(t.redrawUs) + "}";
+  }
+  return "{\"active_hz\":" + String(spiClockHz) +
+         ",\"source\":\"" + String(sources[spiClockSource]) + "\"" +
+         ",\"default_hz\":" + String((uint32_t)SPI_FREQUENCY) +
+         ",\"read_hz\":" + String((uint32_t)SPI_READ_FREQUENCY) +
+         ",\"redraw_us\":" + String(spiRedrawUs) +
+         ",\"calibration\":{\"runs\":" + String(spiCal.runCount()) +
+         ",\"baseline_ok\":" + String(spiCal.baselinePassed() ? "true" : "false") +
+         ",\"chosen_hz\":" + String(spiCal.chosenHz()) +
+         ",\"duration_ms\":" + String(spiCal.durationMs()) +
+         ",\"rounds\":" + String(SPI_CAL_ROUNDS) +
+         ",\"patterns\":" + String(SPI_CAL_PATTERNS) +
+         ",\"pixels_per_pattern\":" + String(SPI_CAL_PIXELS) +
+         ",\"clocks\":[" + clocks + "]}}";
+}
+#endif
+
+// ======================== WEB SERVER FUNCTIONS ========================
+
+// Register a handler wrapped with per-path instrumentation
+void serverOn(const char* uri, ESP8266WebServer::THandlerFunction handler) {
+  int memSite = memStats.addSite(uri);
+  server.on(uri, [uri, memSite, handler]() {
+    MemProbe probe(memStats, memSite);
+    latency.setContext(uri);  // Blamed path if this iteration stalls
+    TRACE_SCOPE(uri);
+    handler();
+  });
+}
+
+// Same for upload endpoints; upload runs once per received piece of the body
+void serverOn(const char* uri, HTTPMethod method, ESP8266WebServer::THandlerFunction handler,
+              ESP8266WebServer::THandlerFunction upload) {
+  int memSite = memStats.addSite(uri);
+  server.on(uri, method, [uri, memSite, handler]() {
+    MemProbe probe(memStats, memSite);
+    latency.setContext(uri);
+    TRACE_SCOPE(uri);
+    handler();
+  }, upload);
+}
+
+void setupWebServer() {
+  // Root page handler
+  serverOn("/", []() {
+    String html = "<!DOCTYPE html><html><head>";
+    html += "<meta charset='UTF-8'>";
+    html += "<meta name='viewport' content='width=device-width, initial-scale=1.0'>";
+    html += "<title>TFT LED Clock</title>";
+    html += "<style>";
+    html += "*{box-sizing:border-box;}";
+    html += "body{font-family:'Segoe UI',Arial,sans-serif;margin:0;padding:15px;background:#1a1a1a;color:#fff;max-width:1200px;margin:0 auto;}";
     html += ".header{text-align:center;margin-bottom:20px;}";
     html += "h1{color:#fff;font-size:clamp(20px,5vw,28px);font-weight:600;margin:0 0 30px 0;}";
     html += ".time-display{background:linear-gradient(135deg,#2a2a2a,#1e1e1e);padding:clamp(20px,5vw,40px);border-radius:15px;box-shadow:0 8px 32px rgba(0,0,0,0.3);margin-bottom:20px;}";
@@ -953,6 +3083,14 @@ void setupWebServer() {
     html += "}}}})";
     html += ".catch(function(e){console.log('Display update failed:',e);});";
     html += "}";
+    html += "function timer(q){";
+    html += "fetch('/api/timer?'+q)";
+    html += ".then(function(r){return r.json();})";
+    html += ".then(function(d){";
+    html += "var t=document.getElementById('timerState');";
+    html += "if(t)t.textContent=d.timer+(d.running?' running':' stopped')+(d.shown?' | '+d.achieved_hz+' Hz of '+d.target_hz+', jitter '+d.jitter_us+' µs':'');";
+    html += "});";
+    html += "}";
     html += "setInterval(updateDisplay,500);";
     html += "setTimeout(function(){initCanvas();updateDisplay();},200);";
     html += "</script>";
@@ -1044,6 +3182,18 @@ void setupWebServer() {
     html += "<div class='card'><h2>Settings</h2>";
     html += "<button onclick=\"location.href='/temperature?mode=toggle'\">Toggle °C/°F</button>";
     html += "</div>";
+
+    #if TIMER_MODES_ENABLED
+    html += "<div class='card'><h2>Stopwatch / Countdown</h2>";
+    html += "<button onclick=\"timer('mode=stopwatch')\">Stopwatch</button> ";
+    html += "<input id='cdMinutes' type='number' min='1' max='5999' value='" + String(countdown.durationMs() / 60000) + "' style='width:70px'> min ";
+    html += "<button onclick=\"timer('mode=countdown&seconds='+document.getElementById('cdMinutes').value*60)\">Countdown</button><br><br>";
+    html += "<button onclick=\"timer('action=toggle')\">Start / Stop</button> ";
+    html += "<button onclick=\"timer('action=reset')\">Reset</button> ";
+    html += "<button onclick=\"timer('mode=clock')\">Back to Clock</button>";
+    html += "<p id='timerState'></p>";
+    html += "</div>";
+    #endif
     
     html += "<div class='card'><h2>Display Style</h2>";
     html += "<p>Current Style: " + String(displayStyle == 0 ? "Default (Blocks)" : "Realistic (LEDs)") + "</p>";
@@ -1082,94 +3232,634 @@ void setupWebServer() {
       html += timezones[i].name;
       html += "</option>";
     }
-    html += "</select><br><br>";
-    
-    html += "<p>Time Format: " + String(use24HourFormat ? "24-Hour" : "12-Hour") + "</p>";
-    html += "<button onclick=\"location.href='/timeformat?mode=toggle'\">Toggle 12/24 Hour</button>";
-    if (use24HourFormat) {
-      html += "<p style='color:#666;font-size:12px;margin-top:10px;'>⚠️ Note: In Time+Temp mode, seconds not displayed when hours ≥ 10 due to space constraints</p>";
+    html += "</select><br><br>";
+    
+    html += "<p>Time Format: " + String(use24HourFormat ? "24-Hour" : "12-Hour") + "</p>";
+    html += "<button onclick=\"location.href='/timeformat?mode=toggle'\">Toggle 12/24 Hour</button>";
+    if (use24HourFormat) {
+      html += "<p style='color:#666;font-size:12px;margin-top:10px;'>⚠️ Note: In Time+Temp mode, seconds not displayed when hours ≥ 10 due to space constraints</p>";
+    }
+    html += "</div>";
+    
+    html += "<div class='card'><h2>System</h2>";
+    html += "<p>IP: " + WiFi.localIP().toString() + "</p>";
+    html += "<p>Uptime: " + String(millis() / 1000) + "s</p>";
+    html += "<button onclick=\"if(confirm('Reset WiFi?'))location.href='/reset'\">Reset WiFi</button>";
+    html += "</div>";
+
+    // About footer
+    html += "<div class='footer'>";
+    html += "<p>ESP8266 TFT LED Retro Clock v" + String(VERSION) + "</p>";
+    html += "<p>Created by <a href='https://bsky.app/profile/anthonyclarke.bsky.social' target='_blank'>Anthony Clarke</a></p>";
+    html += "<p><a href='https://github.com/anthonyjclarke/ESP8266_TFT_RetroClock' target='_blank'>GitHub Repository</a></p>";
+    html += "</div>";
+
+    html += "</body></html>";
+    server.send(200, "text/html", html);
+  });
+  
+  // API endpoints
+  serverOn("/api/time", []() {
+    String json = "{\"hours\":" + String(hours24) + ",\"minutes\":" + String(minutes) +
+                  ",\"seconds\":" + String(seconds) + ",\"day\":" + String(day) +
+                  ",\"month\":" + String(month) + ",\"year\":" + String(year) +
+                  ",\"use24hour\":" + String(use24HourFormat ? "true" : "false") + "}";
+    server.send(200, "application/json", json);
+  });
+  
+  // Display buffer API endpoint - returns 64-byte screen buffer and display settings
+  // This enables real-time TFT display mirroring on the web page with minimal overhead
+  serverOn("/api/display", []() {
+    String json = "{\"buffer\":[";
+    for (int i = 0; i < LINE_WIDTH * DISPLAY_ROWS; i++) {
+      json += String(scr[i]);
+      if (i < LINE_WIDTH * DISPLAY_ROWS - 1) json += ",";
+    }
+    json += "],\"style\":" + String(displayStyle);
+    json += ",\"ledColor\":" + String(ledOnColor);
+    json += ",\"surroundColor\":" + String(ledSurroundColor);
+    json += ",\"width\":" + String(TOTAL_WIDTH);
+    json += ",\"height\":" + String(TOTAL_HEIGHT);
+    json += "}";
+    server.send(200, "application/json", json);
+  });
+  
+  serverOn("/api/status", []() {
+    int tempDisplay = useFahrenheit ? (temperature * 9 / 5 + 32) : temperature;
+    String json = "{\"sensor_available\":" + String(sensorAvailable ? "true" : "false") +
+                  ",\"temperature\":" + String(tempDisplay) +
+                  ",\"humidity\":" + String(humidity) +
+                  ",\"pressure\":" + String(pressure) +
+                  ",\"temp_unit\":\"" + String(useFahrenheit ? "Fahrenheit" : "Celsius") + "\"" +
+                  ",\"warm_boot\":" + String(warmBoot ? "true" : "false") +
+                  ",\"drift_ppm\":" + String(clockDriftPpm) +
+                  ",\"wifi_fast_path\":" + String(wifiFastPathUsed ? "true" : "false") +
+                  ",\"wifi_connect_ms\":" + String(wifiConnectMs) +
+                  ",\"boot_to_online_ms\":" + String(bootToOnlineMs);
+    #if FRAME_INPUT_ENABLED
+    json += ",\"frame_input\":{\"active\":" + String(frameInput.isActive() ? "true" : "false") +
+            ",\"port\":" + String(FRAME_UDP_PORT) +
+            ",\"packets\":" + String(frameInput.stats.packets) +
+            ",\"frames\":" + String(frameInput.stats.frames) +
+            ",\"stale\":" + String(frameInput.stats.stale) +
+            ",\"lost\":" + String(frameInput.stats.lost) +
+            ",\"malformed\":" + String(frameInput.stats.malformed) +
+            ",\"sessions\":" + String(frameInput.stats.sessions) + "}";
+    #endif
+    #if INFO_PANEL_ENABLED
+    json += ",\"info_panel\":{\"passes\":" + String(infoPanel.passCount()) +
+            ",\"deferred\":" + String(infoPanel.deferredCount()) +
+            ",\"last_us\":" + String(infoPanel.lastPassUs()) +
+            ",\"max_us\":" + String(infoPanel.maxPassUs()) +
+            ",\"fields\":[";
+    for (int i = 0; i < infoPanel.count(); i++) {
+      const InfoField& f = infoPanel.field(i);
+      if (i > 0) json += ",";
+      json += "{\"name\":\"" + String(f.name) + "\",\"text\":\"" + String(f.shown) +
+              "\",\"draws\":" + String(f.draws) + "}";
+    }
+    json += "]}";
+    #endif
+    json += "}";
+    server.send(200, "application/json", json);
+  });
+  
+  #if DISPLAY_SELFTEST
+  // Golden-frame regression + render budget check (takes ~1-2s, display flickers)
+  serverOn("/api/selftest", []() {
+    String json;
+    json.reserve(2048);
+    int failures = runDisplaySelfTest(json);
+    server.send(failures == 0 ? 200 : 500, "application/json", json);
+  });
+  #endif
+  
+  // Heap instrumentation - watermarks and per-site free-heap deltas
+  serverOn("/api/mem", []() {
+    HeapSample now = memStats.sample();
+    String json = "{\"free\":" + String(now.freeHeap) +
+                  ",\"max_block\":" + String(now.maxBlock) +
+                  ",\"fragmentation\":" + String(now.fragmentation) +
+                  ",\"low_free\":" + String(memStats.lowFree) +
+                  ",\"high_free\":" + String(memStats.highFree) +
+                  ",\"low_max_block\":" + String(memStats.lowMaxBlock) +
+                  ",\"high_fragmentation\":" + String(memStats.highFragmentation) +
+                  ",\"sites\":[";
+    for (int i = 0; i < memStats.count(); i++) {
+      const MemSite& m = memStats.site(i);
+      if (i > 0) json += ",";
+      json += "{\"name\":\"" + String(m.name) + "\"";
+      json += ",\"calls\":" + String(m.calls);
+      json += ",\"last_delta\":" + String(m.lastDelta);
+      json += ",\"worst_delta\":" + String(m.worstDelta);
+      json += ",\"net_delta\":" + String(m.netDelta);
+      json += ",\"min_free_after\":" + String(m.calls ? m.minFreeAfter : 0) + "}";
+    }
+    json += "]}";
+    server.send(200, "application/json", json);
+  });
+  
+  // Latency histograms (bucket i = [2^i, 2^(i+1)) us) and recent stalls
+  serverOn("/api/latency", []() {
+    String json = "{\"stall_threshold_us\":" + String(latency.stallThreshold()) + ",\"histograms\":[";
+    for (int i = 0; i < latency.count(); i++) {
+      const LatencyHistogram& h = latency.site(i);
+      if (i > 0) json += ",";
+      json += "{\"name\":\"" + String(h.name) + "\"";
+      json += ",\"count\":" + String(h.count);
+      json += ",\"max_us\":" + String(h.maxUs);
+      json += ",\"avg_us\":" + String(h.count ? (uint32_t)(h.totalUs / h.count) : 0);
+      json += ",\"buckets\":[";
+      for (int b = 0; b < LAT_BUCKETS; b++) {
+        if (b > 0) json += ",";
+        json += String(h.buckets[b]);
+      }
+      json += "]}";
+    }
+    json += "],\"total_stalls\":" + String(latency.totalStalls()) + ",\"stalls\":[";
+    int shown = latency.totalStalls() < LAT_STALL_SLOTS ? latency.totalStalls() : LAT_STALL_SLOTS;
+    for (int i = 0; i < shown; i++) {
+      const StallRecord& st = latency.stall(i);
+      if (i > 0) json += ",";
+      json += "{\"at_ms\":" + String(st.atMs);
+      json += ",\"iteration_us\":" + String(st.iterationUs);
+      json += ",\"site\":\"" + String(st.site) + "\"";
+      json += ",\"site_us\":" + String(st.siteUs);
+      json += ",\"context\":\"" + String(st.context ? st.context : "") + "\"}";
+    }
+    json += "]}";
+    server.send(200, "application/json", json);
+  });
+  
+  // Recent log records + per-module levels; ?module=ntp&level=debug changes a level
+  serverOn("/api/log", []() {
+    if (server.hasArg("module") && server.hasArg("level")) {
+      int module = EventLog::moduleByName(server.arg("module").c_str());
+      String levelArg = server.arg("level");
+      int level = -1;
+      for (int i = 0; i <= LOG_DEBUG; i++) {
+        if (levelArg == logLevelNames[i] || levelArg == String(i)) level = i;
+      }
+      if (module < 0 || level < 0) {
+        server.send(400, "application/json", "{\"error\":\"unknown module or level\"}");
+        return;
+      }
+      eventLog.setLevel(module, level);
+    }
+
+    String json = "{\"levels\":{";
+    for (int i = 0; i < LOG_MODULES; i++) {
+      if (i > 0) json += ",";
+      json += "\"" + String(logModuleNames[i]) + "\":\"" + String(logLevelNames[eventLog.level(i)]) + "\"";
+    }
+    json += "},\"total\":" + String(eventLog.totalRecords());
+    json += ",\"dropped\":" + String(eventLog.droppedRecords());
+    json += ",\"pending\":" + String(eventLog.pendingRecords()) + ",\"records\":[";
+    for (int i = 0; i < eventLog.available(); i++) {
+      const LogRecord& rec = eventLog.recent(i);
+      char msg[LOG_LINE_MAX];
+      eventLog.formatMessage(rec, msg, sizeof(msg));
+      if (i > 0) json += ",";
+      json += "{\"ms\":" + String(rec.ms);
+      json += ",\"module\":\"" + String(logModuleNames[rec.module]) + "\"";
+      json += ",\"level\":\"" + String(logLevelNames[rec.level]) + "\",\"msg\":\"";
+      for (char* c = msg; *c; c++) {
+        if (*c == '"' || *c == '\\') json += '\\';
+        json += *c;
+      }
+      json += "\"}";
+    }
+    json += "]}";
+    server.send(200, "application/json", json);
+  });
+  
+  #if LIFE_MODE_ENABLED
+  // Life screensaver stats; ?rule=B36/S23 changes the rule, ?show=1 switches to it,
+  // ?bench=N times N generations (compute only, then with full refresh)
+  serverOn("/api/life", []() {
+    if (server.hasArg("rule") && !life.setRule(server.arg("rule").c_str())) {
+      server.send(400, "application/json", "{\"error\":\"rule must look like B3/S23\"}");
+      return;
+    }
+    if (server.hasArg("show")) {
+      for (int i = 0; i < numDisplayModes; i++) {
+        if (displayModes[i].compose == displayLife) setDisplayMode(i);
+      }
+      renderCurrentMode();
+    }
+
+    String bench;
+    if (server.hasArg("bench")) {
+      int n = constrain(server.arg("bench").toInt(), 1, 200);
+      LifeAutomaton scratch = life;
+      unsigned long start = micros();
+      for (int i = 0; i < n; i++) scratch.step();
+      unsigned long computeUs = micros() - start;
+
+      uint8_t saved[sizeof(scr)];
+      memcpy(saved, scr, sizeof(scr));
+      start = micros();
+      for (int i = 0; i < n; i++) {
+        scratch.step();
+        scratch.store(scr);
+        refreshAll();
+        yield();
+      }
+      unsigned long renderUs = micros() - start;
+      memcpy(scr, saved, sizeof(scr));
+      refreshAll();
+
+      bench = ",\"bench\":{\"generations\":" + String(n) +
+              ",\"compute_us\":" + String(computeUs) +
+              ",\"compute_gens_per_sec\":" + String(computeUs ? (uint32_t)((uint64_t)n * 1000000 / computeUs) : 0) +
+              ",\"render_us\":" + String(renderUs) +
+              ",\"render_gens_per_sec\":" + String(renderUs ? (uint32_t)((uint64_t)n * 1000000 / renderUs) : 0) + "}";
+    }
+
+    char rule[24];
+    life.ruleString(rule, sizeof(rule));
+    String json = "{\"rule\":\"" + String(rule) + "\"" +
+                  ",\"active\":" + String(displayModes[currentMode].compose == displayLife ? "true" : "false") +
+                  ",\"generation\":" + String(life.generations()) +
+                  ",\"population\":" + String(life.population()) +
+                  ",\"gens_per_sec\":" + String(lifeGensPerSec) +
+                  ",\"step_us\":" + String(lifeStepUs) +
+                  ",\"frame_us\":" + String(animationFrameUs) + bench + "}";
+    server.send(200, "application/json", json);
+  });
+  #endif
+  
+  #if TIMER_MODES_ENABLED
+  // Stopwatch/countdown control and frame-rate report. Applied in order:
+  // ?hz=10-100, ?precision=1|2, ?mode=stopwatch|countdown|clock (&seconds=N), ?action=start|stop|toggle|reset
+  serverOn("/api/timer", []() {
+    if (server.hasArg("hz")) timerCommand("hz", server.arg("hz").toInt());
+    if (server.hasArg("precision")) timerCommand("precision", server.arg("precision").toInt());
+    if (server.hasArg("mode") && !timerCommand(server.arg("mode").c_str(), server.arg("seconds").toInt())) {
+      server.send(400, "application/json", "{\"error\":\"mode must be stopwatch, countdown or clock\"}");
+      return;
+    }
+    if (server.hasArg("action") && !timerCommand(server.arg("action").c_str(), 0)) {
+      server.send(400, "application/json", "{\"error\":\"action must be start, stop, toggle or reset\"}");
+      return;
+    }
+    server.send(200, "application/json", timerStatusJson());
+  });
+  #endif
+
+  #if OTA_ENABLED
+  // Firmware upload: multipart POST with ?md5=<hex>[&size=<bytes>], basic auth
+  // OTA_USERNAME/OTA_PASSWORD. The image goes straight to flash; on success
+  // the clock reboots into it (warm boot)
+  serverOn("/update", HTTP_POST, []() {
+    if (!otaAuthorized()) {
+      server.requestAuthentication();
+      return;
+    }
+    bool ok = ota.status() == OTA_DONE;
+    server.send(ok ? 200 : 400, "application/json", otaStatusJson());
+    if (ok) {
+      saveRtcState();  // New firmware shows the time at once
+      delay(100);
+      server.client().stop();
+      ESP.restart();
+    }
+    tft.fillRect(0, tft.height() - OTA_BAR_HEIGHT, tft.width(), OTA_BAR_HEIGHT, BG_COLOR);
+  }, handleOtaUpload);
+
+  // Result and throughput of the last/current upload
+  serverOn("/api/ota", []() {
+    server.send(200, "application/json", otaStatusJson());
+  });
+  #endif
+
+  #if SPI_CAL_ENABLED
+  // TFT write clock: ?calibrate=1 finds and stores the fastest verified one,
+  // ?hz= sets one by hand (stored only if it reads back clean), ?reset=1
+  // goes back to SPI_FREQUENCY, ?redraw=1 times a full redraw at the current clock
+  serverOn("/api/spi", []() {
+    if (server.hasArg("reset")) clearSpiClock();
+    if (server.hasArg("hz")) {
+      long hz = server.arg("hz").toInt();
+      if (hz < 1000000 || hz > 80000000) {
+        server.send(400, "application/json", "{\"error\":\"hz must be 1000000-80000000\"}");
+        return;
+      }
+      uint32_t errors = spiCal.verify(hz, spiCalClocks[0], spiClockHz);
+      if (errors) resetTftAfterBadClock();
+      else clearSpiTestBlock();
+      if (errors == SPI_CAL_UNVERIFIED) {
+        // No read path to check it with: this session only
+        applySpiClock(hz, SPI_CLOCK_UNVERIFIED);
+        spiRedrawUs = spiCalPanel.redrawUs();
+        LOG(LOG_DISPLAY, LOG_WARN, "SPI clock set to %ld Hz unverified (no read-back), not stored", hz);
+      } else if (errors) {
+        LOG(LOG_DISPLAY, LOG_WARN, "SPI clock %ld Hz rejected: %u pixel errors", hz, errors);
+        server.send(400, "application/json", "{\"error\":\"hz failed read-back\",\"pixel_errors\":" + String(errors) + "}");
+        return;
+      } else {
+        applySpiClock(hz, SPI_CLOCK_MANUAL);
+        spiRedrawUs = spiCalPanel.redrawUs();
+        saveSpiClock();
+        LOG(LOG_DISPLAY, LOG_INFO, "SPI clock set to %ld Hz, full redraw %u us", hz, spiRedrawUs);
+      }
+    }
+    if (server.hasArg("calibrate")) calibrateSpiClock();
+    if (server.hasArg("redraw")) spiRedrawUs = spiCalPanel.redrawUs();
+    server.send(200, "application/json", spiStatusJson());
+  });
+  #endif
+
+  #if METRICS_ENABLED
+  // Prometheus scrape target - streamed in METRICS_BUFFER_SIZE chunks, no String building
+  serverOn("/metrics", []() {
+    unsigned long start = micros();
+    server.setContentLength(CONTENT_LENGTH_UNKNOWN);
+    server.send(200, "text/plain; version=0.0.4", "");
+    MetricsWriter m(metricsBuffer, sizeof(metricsBuffer), sendMetricsChunk, nullptr);
+    writeMetrics(m);
+    m.finish();
+    server.sendContent("");  // Last chunk
+    metricsScrapeUs = micros() - start;
+    metricsScrapeBytes = m.bytes();
+  });
+  #endif
+
+  #if FLEET_SYNC_ENABLED
+  // Beacon role and sync error stats; ?role=off|leader|follower switches role
+  serverOn("/api/fleet", []() {
+    if (server.hasArg("role")) {
+      String role = server.arg("role");
+      int r = role == "leader" ? FLEET_LEADER : role == "follower" ? FLEET_FOLLOWER : role == "off" ? FLEET_OFF : -1;
+      if (r < 0) {
+        server.send(400, "application/json", "{\"error\":\"role must be off, leader or follower\"}");
+        return;
+      }
+      setFleetRole(r);
     }
-    html += "</div>";
-    
-    html += "<div class='card'><h2>System</h2>";
-    html += "<p>IP: " + WiFi.localIP().toString() + "</p>";
-    html += "<p>Uptime: " + String(millis() / 1000) + "s</p>";
-    html += "<button onclick=\"if(confirm('Reset WiFi?'))location.href='/reset'\">Reset WiFi</button>";
-    html += "</div>";
+    server.send(200, "application/json", fleetStatusJson());
+  });
+  #endif
 
-    // About footer
-    html += "<div class='footer'>";
-    html += "<p>ESP8266 TFT LED Retro Clock v" + String(VERSION) + "</p>";
-    html += "<p>Created by <a href='https://bsky.app/profile/anthonyclarke.bsky.social' target='_blank'>Anthony Clarke</a></p>";
-    html += "<p><a href='https://github.com/anthonyjclarke/ESP8266_TFT_RetroClock' target='_blank'>GitHub Repository</a></p>";
-    html += "</div>";
+  #if MQTT_ENABLED
+  // Telemetry publisher: queue depth, backoff and publish latency
+  serverOn("/api/mqtt", []() {
+    server.send(200, "application/json", mqttStatusJson());
+  });
+  #endif
 
-    html += "</body></html>";
-    server.send(200, "text/html", html);
+  #if ALARMS_ENABLED
+  // Alarm table and next trigger; add/delete/enable edit it (saved to EEPROM),
+  // dismiss stops a flashing alarm
+  serverOn("/api/alarms", []() {
+    if (server.hasArg("dismiss")) stopAlarmFlash();
+    if (server.hasArg("add")) {
+      Alarm a;
+      const char* error = parseAlarmArgs(a);
+      if (!error && alarms.add(a) < 0) error = "alarm table full";
+      if (error) {
+        server.send(400, "application/json", "{\"error\":\"" + String(error) + "\"}");
+        return;
+      }
+    }
+    if (server.hasArg("delete")) alarms.remove(server.arg("delete").toInt());
+    if (server.hasArg("enable")) alarms.setEnabled(server.arg("enable").toInt(), server.arg("on") != "0");
+    if (server.hasArg("clear")) alarms.clear();
+    if (alarms.needsSave()) {
+      saveAlarms();
+      reindexAlarms(time(nullptr));
+    }
+    server.send(200, "application/json", alarmsJson());
   });
+  #endif
   
-  // API endpoints
-  server.on("/api/time", []() {
-    String json = "{\"hours\":" + String(hours24) + ",\"minutes\":" + String(minutes) +
-                  ",\"seconds\":" + String(seconds) + ",\"day\":" + String(day) +
-                  ",\"month\":" + String(month) + ",\"year\":" + String(year) +
-                  ",\"use24hour\":" + String(use24HourFormat ? "true" : "false") + "}";
+  #if ANALOG_MODE_ENABLED
+  // Analog dial cache stats; ?show=1 switches to the mode, ?bench=N compares
+  // N simulated ticks of every clock mode (display flickers while it runs)
+  serverOn("/api/analog", []() {
+    if (server.hasArg("show")) {
+      for (int i = 0; i < numDisplayModes; i++) {
+        if (displayModes[i].compose == displayAnalog) setDisplayMode(i);
+      }
+      renderCurrentMode();
+    }
+
+    String bench;
+    if (server.hasArg("bench")) {
+      int n = constrain(server.arg("bench").toInt(), 1, 300);
+      bench = ",\"bench\":{\"ticks\":" + String(n) + ",\"modes\":" + benchClockModes(n) + "}";
+    }
+
+    String json = "{\"active\":" + String(displayModes[currentMode].compose == displayAnalog ? "true" : "false") +
+                  ",\"hands_rasterised\":" + String(analogClock.rasterCount()) +
+                  ",\"cache_hits\":" + String(analogClock.cacheHits()) +
+                  ",\"cached_angles\":" + String(analogClock.cachedAngles()) + bench + "}";
     server.send(200, "application/json", json);
   });
+  #endif
   
-  // Display buffer API endpoint - returns 64-byte screen buffer and display settings
-  // This enables real-time TFT display mirroring on the web page with minimal overhead
-  server.on("/api/display", []() {
-    String json = "{\"buffer\":[";
-    for (int i = 0; i < LINE_WIDTH * DISPLAY_ROWS; i++) {
-      json += String(scr[i]);
-      if (i < LINE_WIDTH * DISPLAY_ROWS - 1) json += ",";
+  #if MARQUEE_ENABLED
+  // Ticker text, scroll path and SPI cost per step. ?text=&text2= set the
+  // lines (text= empty: time/date + sensors), ?hw=0|1 picks the path,
+  // ?show=1 switches to the mode, ?bench=N times N steps on each path
+  serverOn("/api/marquee", []() {
+    if (server.hasArg("text") || server.hasArg("text2")) {
+      marqueeCustom = server.arg("text").length() > 0;
+      if (marqueeCustom) {
+        setMarqueeLine(0, server.arg("text").c_str());
+        setMarqueeLine(1, server.arg("text2").c_str());
+      }
+      buildMarqueeText();
+      marqueePos = 0;
+      markDisplayDirty(DEP_MARQUEE);
     }
-    json += "],\"style\":" + String(displayStyle);
-    json += ",\"ledColor\":" + String(ledOnColor);
-    json += ",\"surroundColor\":" + String(ledSurroundColor);
-    json += ",\"width\":" + String(TOTAL_WIDTH);
-    json += ",\"height\":" + String(TOTAL_HEIGHT);
-    json += "}";
+    if (server.hasArg("hw")) marqueeHw = server.arg("hw").toInt() != 0;
+    bool shown = displayModes[currentMode].compose == displayMarquee;
+    if ((server.hasArg("show") || server.hasArg("bench")) && !shown) {
+      for (int i = 0; i < numDisplayModes; i++) {
+        if (displayModes[i].compose == displayMarquee) setDisplayMode(i);
+      }
+      shown = true;
+    } else if (shown) {
+      marqueeUseHw(marqueeHw);
+    }
+    renderCurrentMode();
+
+    String bench;
+    if (server.hasArg("bench")) {
+      int n = constrain(server.arg("bench").toInt(), 1, 500);
+      bench = ",\"bench\":" + benchMarquee(n);
+    }
+
+    const HwScroll<TFT_eSPI>& scroll = tftSink.hwScroll();
+    String json = "{\"active\":" + String(shown ? "true" : "false") +
+                  ",\"text\":[\"" + String(marqueeText[0]) + "\",\"" + String(marqueeText[1]) + "\"]" +
+                  ",\"step_ms\":" + String(MARQUEE_STEP_MS) +
+                  ",\"hw_supported\":" + String(tftSink.canScroll() ? "true" : "false") +
+                  ",\"hw_enabled\":" + String(marqueeHw ? "true" : "false") +
+                  ",\"hw_active\":" + String(tftSink.isScrolling() ? "true" : "false") +
+                  ",\"pan_columns\":" + String(scroll.offsetColumns()) +
+                  ",\"pans\":" + String(scroll.panCount()) +
+                  ",\"last_step_bytes\":" + String(marqueeLastBytes) +
+                  ",\"last_step_us\":" + String(marqueeLastUs) +
+                  ",\"hw_steps\":" + String(marqueeHwSteps) +
+                  ",\"hw_bytes_per_step\":" + String(marqueeHwSteps ? (uint32_t)(marqueeHwBytes / marqueeHwSteps) : 0) +
+                  ",\"sw_steps\":" + String(marqueeSwSteps) +
+                  ",\"sw_bytes_per_step\":" + String(marqueeSwSteps ? (uint32_t)(marqueeSwBytes / marqueeSwSteps) : 0) +
+                  bench + "}";
+    server.send(200, "application/json", json);
+  });
+  #endif
+
+  #if SPECTRUM_MODE_ENABLED
+  // Spectrum analyser bars, peaks and per-frame cost; ?show=1 switches to the mode
+  serverOn("/api/spectrum", []() {
+    if (server.hasArg("show")) {
+      for (int i = 0; i < numDisplayModes; i++) {
+        if (displayModes[i].compose == displaySpectrum) setDisplayMode(i);
+      }
+      renderCurrentMode();
+    }
+    bool active = displayModes[currentMode].compose == displaySpectrum;
+    uint32_t renderUs = animationFrameUs > spectrumSampleUs + spectrumFftUs
+                      ? animationFrameUs - spectrumSampleUs - spectrumFftUs : 0;
+    String json = "{\"active\":" + String(active ? "true" : "false") +
+                  ",\"sample_rate\":" + String(SPECTRUM_SAMPLE_RATE) +
+                  ",\"fft_size\":" + String(SPECTRUM_FFT_SIZE) +
+                  ",\"windows\":" + String(spectrum.windowCount()) +
+                  ",\"sample_us\":" + String(spectrumSampleUs) +
+                  ",\"fft_us\":" + String(spectrumFftUs) +
+                  ",\"render_us\":" + String(active ? renderUs : 0) + ",\"columns\":[";
+    for (int c = 0; c < SPECTRUM_COLUMNS; c++) {
+      if (c > 0) json += ",";
+      json += "{\"hz\":" + String((uint32_t)spectrum.columnFirstBin(c) * SPECTRUM_SAMPLE_RATE / SPECTRUM_FFT_SIZE);
+      json += ",\"height\":" + String(spectrumHeights[c]);
+      json += ",\"peak\":" + String(spectrum.peak(c)) + "}";
+    }
+    json += "]}";
     server.send(200, "application/json", json);
   });
+  #endif
   
-  server.on("/api/status", []() {
-    int tempDisplay = useFahrenheit ? (temperature * 9 / 5 + 32) : temperature;
-    String json = "{\"sensor_available\":" + String(sensorAvailable ? "true" : "false") +
-                  ",\"temperature\":" + String(tempDisplay) +
-                  ",\"humidity\":" + String(humidity) +
-                  ",\"pressure\":" + String(pressure) +
-                  ",\"temp_unit\":\"" + String(useFahrenheit ? "Fahrenheit" : "Celsius") + "\"}";
+  #if MAX7219_EMU_ENABLED
+  // MAX7219 emulator state; ?modules=8&wide=4&reverse=0 reconfigures the cascade
+  serverOn("/api/max7219", []() {
+    if (server.hasArg("modules") || server.hasArg("wide") || server.hasArg("reverse")) {
+      int modules = server.hasArg("modules") ? server.arg("modules").toInt() : max7219Emu.modulesConfigured();
+      int wide = server.hasArg("wide") ? server.arg("wide").toInt() : max7219Emu.modulesWide();
+      bool reverse = server.hasArg("reverse") ? server.arg("reverse").toInt() != 0 : max7219Emu.reversed();
+      if (modules < 0 || wide < 0 || !max7219Emu.configure(modules, wide, reverse)) {
+        server.send(400, "application/json", "{\"error\":\"cascade does not fit the 32x16 matrix\"}");
+        return;
+      }
+    }
+
+    String json = "{\"active\":" + String(max7219Emu.isActive() ? "true" : "false") +
+                  ",\"udp_port\":" + String(MAX7219_EMU_UDP_PORT) +
+                  ",\"modules\":" + String(max7219Emu.modulesConfigured()) +
+                  ",\"wide\":" + String(max7219Emu.modulesWide()) +
+                  ",\"reverse\":" + String(max7219Emu.reversed() ? "true" : "false") +
+                  ",\"packets\":" + String(max7219Emu.stats.packets) +
+                  ",\"latches\":" + String(max7219Emu.stats.latches) +
+                  ",\"writes\":" + String(max7219Emu.stats.writes) +
+                  ",\"errors\":" + String(max7219Emu.stats.errors) + ",\"state\":[";
+    for (int m = 0; m < max7219Emu.modulesConfigured(); m++) {
+      const Max7219Module& mod = max7219Emu.module(m);
+      if (m > 0) json += ",";
+      json += "{\"intensity\":" + String(mod.intensity);
+      json += ",\"scan_limit\":" + String(mod.scanLimit);
+      json += ",\"decode_mode\":" + String(mod.decodeMode);
+      json += ",\"shutdown\":" + String(mod.shutdown ? "true" : "false");
+      json += ",\"display_test\":" + String(mod.displayTest ? "true" : "false") + "}";
+    }
+    json += "]}";
+    server.send(200, "application/json", json);
+  });
+  #endif
+  
+  #if TRACE_ENABLED
+  // Chrome Trace Event JSON of the recorded scopes (?serial=1 dumps to Serial instead, ?clear=1 empties the ring)
+  serverOn("/api/trace", []() {
+    if (server.hasArg("clear")) {
+      traceRecorder.clear();
+      server.send(200, "application/json", "{\"cleared\":true}");
+      return;
+    }
+    if (server.hasArg("serial")) {
+      traceRecorder.writeJson(Serial);
+      server.send(200, "application/json", "{\"events\":" + String(traceRecorder.count()) + "}");
+      return;
+    }
+
+    // Stream in ~512-byte chunks rather than building the whole document in a String
+    struct ChunkedOut {
+      char buf[512];
+      size_t len;
+      size_t write(const uint8_t* data, size_t n) {
+        if (len + n > sizeof(buf)) flush();
+        memcpy(buf + len, data, n);
+        len += n;
+        return n;
+      }
+      void flush() {
+        if (len > 0) server.sendContent(buf, len);
+        len = 0;
+      }
+    } out;
+    out.len = 0;
+    server.setContentLength(CONTENT_LENGTH_UNKNOWN);
+    server.sendHeader("Content-Disposition", "attachment; filename=trace.json");
+    server.send(200, "application/json", "");
+    traceRecorder.writeJson(out);
+    out.flush();
+    server.sendContent("");
+  });
+  #endif
+  
+  // Scheduler statistics - per-task run counts, overruns and worst-case latency
+  serverOn("/api/tasks", []() {
+    String json = "{\"load_percent\":" + String(scheduler.loadPercent()) + ",\"tasks\":[";
+    for (int i = 0; i < scheduler.count(); i++) {
+      const SchedulerTask& t = scheduler.task(i);
+      if (i > 0) json += ",";
+      json += "{\"name\":\"" + String(t.name) + "\"";
+      json += ",\"period_ms\":" + String(t.period);
+      json += ",\"priority\":" + String(t.priority);
+      json += ",\"runs\":" + String(t.runs);
+      json += ",\"overruns\":" + String(t.overruns);
+      json += ",\"max_latency_ms\":" + String(t.maxLatency);
+      json += ",\"max_run_ms\":" + String(t.maxRunTime);
+      json += ",\"total_run_ms\":" + String(t.totalRunTime) + "}";
+    }
+    json += "]}";
     server.send(200, "application/json", json);
   });
   
   // Temperature unit toggle endpoint
-  server.on("/temperature", []() {
+  serverOn("/temperature", []() {
     if (server.hasArg("mode")) {
       useFahrenheit = !useFahrenheit;
-      DEBUG(Serial.printf("Temperature unit: %s\n", useFahrenheit ? "Fahrenheit" : "Celsius"));
+      LOG(LOG_HTTP, LOG_INFO, "Temperature unit: %s", useFahrenheit ? "Fahrenheit" : "Celsius");
 
       // Force immediate display update
-      switch (currentMode) {
-        case 0: displayTimeAndTemp(); break;
-        case 1: displayTimeLarge(); break;
-        case 2: displayTimeAndDate(); break;
-      }
-      refreshAll();
+      markDisplayDirty(DEP_SENSOR);
+      renderCurrentMode();
     }
     server.sendHeader("Location", "/");
     server.send(302, "text/plain", "");
   });
   
   // Timezone configuration endpoint
-  server.on("/timezone", []() {
+  serverOn("/timezone", []() {
     if (server.hasArg("tz")) {
       int newTimezone = server.arg("tz").toInt();
       if (newTimezone >= 0 && newTimezone < numTimezones) {
         currentTimezone = newTimezone;
-        DEBUG(Serial.printf("Timezone changed to: %s\n", timezones[currentTimezone].name));
+        LOG(LOG_HTTP, LOG_INFO, "Timezone changed to: %s", timezones[currentTimezone].name);
         syncNTP();
+        #if ALARMS_ENABLED
+          alarmsClockChanged = true;  // Same local times, different UTC instants
+        #endif
       }
     }
     server.sendHeader("Location", "/");
@@ -1177,34 +3867,30 @@ void setupWebServer() {
   });
   
   // Time format (12/24 hour) toggle endpoint
-  server.on("/timeformat", []() {
+  serverOn("/timeformat", []() {
     if (server.hasArg("mode")) {
       use24HourFormat = !use24HourFormat;
-      DEBUG(Serial.printf("Time format changed to: %s\n", use24HourFormat ? "24-Hour" : "12-Hour"));
+      LOG(LOG_HTTP, LOG_INFO, "Time format changed to: %s", use24HourFormat ? "24-Hour" : "12-Hour");
 
       // Force immediate display update
       forceFullRedraw = true;
-      switch (currentMode) {
-        case 0: displayTimeAndTemp(); break;
-        case 1: displayTimeLarge(); break;
-        case 2: displayTimeAndDate(); break;
-      }
-      refreshAll();
+      markDisplayDirty(DEP_SETTINGS);
+      renderCurrentMode();
     }
     server.sendHeader("Location", "/");
     server.send(302, "text/plain", "");
   });
   
   // Display style configuration endpoint
-  server.on("/style", []() {
+  serverOn("/style", []() {
     bool changed = false;
     
     // Toggle display style
     if (server.hasArg("mode") && server.arg("mode") == "toggle") {
       displayStyle = (displayStyle == 0) ? 1 : 0;
       changed = true;
-      DEBUG(Serial.printf("Display style toggled to: %d (%s)\n", 
-                          displayStyle, displayStyle == 0 ? "Default" : "Realistic"));
+      LOG(LOG_HTTP, LOG_INFO, "Display style toggled to: %d (%s)",
+          displayStyle, displayStyle == 0 ? "Default" : "Realistic");
     }
     
     // Set LED color
@@ -1230,7 +3916,7 @@ void setupWebServer() {
       }
       
       changed = true;
-      DEBUG(Serial.printf("LED color changed to index: %d\n", colorIdx));
+      LOG(LOG_HTTP, LOG_INFO, "LED color changed to index: %d", colorIdx);
     }
     
     // Set surround color
@@ -1275,28 +3961,25 @@ void setupWebServer() {
           surroundMatchesLED = false;
       }
       changed = true;
-      DEBUG(Serial.printf("Surround color changed to index: %d, match mode: %s\n", 
-                          colorIdx, surroundMatchesLED ? "ON" : "OFF"));
+      LOG(LOG_HTTP, LOG_INFO, "Surround color changed to index: %d, match mode: %s",
+          colorIdx, surroundMatchesLED ? "ON" : "OFF");
     }
     
     // Force a complete redraw if anything changed
     if (changed) {
       // Clear the entire screen to black
       tft.fillScreen(BG_COLOR);
+      invalidateInfoPanel();
       
       // Set the global flag to force FAST_REFRESH to ignore its cache
       forceFullRedraw = true;
       
       // Immediately trigger display update with new colors
       // This ensures instant visual feedback instead of waiting for next second
-      switch (currentMode) {
-        case 0: displayTimeAndTemp(); break;
-        case 1: displayTimeLarge(); break;
-        case 2: displayTimeAndDate(); break;
-      }
-      refreshAll();  // Draw immediately with new colors
+      markDisplayDirty(DEP_SETTINGS);
+      renderCurrentMode();  // Draw immediately with new colors
 
-      DEBUG(Serial.println("Style changed - immediate redraw complete"));
+      LOG(LOG_DISPLAY, LOG_DEBUG, "Style changed - immediate redraw complete");
     }
     
     server.sendHeader("Location", "/");
@@ -1304,11 +3987,12 @@ void setupWebServer() {
   });
   
   // Reset WiFi
-  server.on("/reset", []() {
+  serverOn("/reset", []() {
     server.send(200, "text/html", 
       "<html><body><h1>WiFi Reset</h1><p>WiFi settings cleared. Device will restart...</p></body></html>");
     delay(1000);
     wifiManager.resetSettings();
+    saveRtcState();  // Keep time + settings across the restart
     ESP.restart();
   });
   
@@ -1316,8 +4000,130 @@ void setupWebServer() {
   DEBUG(Serial.println("Web server started"));
 }
 
+// ======================== WIFI FUNCTIONS ========================
+
+uint32_t wifiCacheCrc(const WifiCache& cache) {
+  const uint8_t* start = (const uint8_t*)&cache + offsetof(WifiCache, bssid);
+  return crc32(start, sizeof(WifiCache) - offsetof(WifiCache, bssid));
+}
+
+bool loadWifiCache(WifiCache& cache) {
+  EEPROM.get(EEPROM_WIFI_CACHE_ADDR, cache);
+  return cache.magic == WIFI_CACHE_MAGIC && cache.crc == wifiCacheCrc(cache);
+}
+
+// Store current BSSID/channel/lease - only writes flash when something changed
+void saveWifiCache() {
+  WifiCache cache;
+  memset(&cache, 0, sizeof(cache));
+  cache.magic = WIFI_CACHE_MAGIC;
+  memcpy(cache.bssid, WiFi.BSSID(), 6);
+  cache.channel = (uint8_t)WiFi.channel();
+  cache.ip = (uint32_t)WiFi.localIP();
+  cache.gateway = (uint32_t)WiFi.gatewayIP();
+  cache.subnet = (uint32_t)WiFi.subnetMask();
+  cache.dns = (uint32_t)WiFi.dnsIP();
+  cache.crc = wifiCacheCrc(cache);
+
+  WifiCache stored;
+  if (loadWifiCache(stored) && memcmp(&stored, &cache, sizeof(cache)) == 0) {
+    return;
+  }
+  EEPROM.put(EEPROM_WIFI_CACHE_ADDR, cache);
+  EEPROM.commit();
+  LOG(LOG_WIFI, LOG_INFO, "WiFi cache updated: %02X:%02X:%02X:%02X:%02X:%02X",
+      cache.bssid[0], cache.bssid[1], cache.bssid[2], cache.bssid[3], cache.bssid[4], cache.bssid[5]);
+  LOG(LOG_WIFI, LOG_INFO, "WiFi cache channel: %d", cache.channel);
+}
+
+// Try to join the cached AP directly. Returns false (and leaves the radio
+// ready for WiFiManager) if there is no cache or association times out.
+// Runs with persistence off: the channel/BSSID pin and the timeout
+// disconnect only touch the SDK's current config, never the credentials
+// saved in flash that WiFiManager falls back on.
+bool fastReconnect() {
+  WifiCache cache;
+  if (!loadWifiCache(cache) || WiFi.SSID().length() == 0) {
+    DEBUG(Serial.println("WiFi cache: empty, using full connect"));
+    return false;
+  }
+
+  // The fallback below rewrites the current config, so keep the credentials
+  String ssid = WiFi.SSID();
+  String psk = WiFi.psk();
+
+  DEBUG(Serial.printf("WiFi fast path: ch %d\n", cache.channel));
+  WiFi.persistent(false);  // begin()/disconnect() below touch the current config only, never flash
+  WiFi.mode(WIFI_STA);
+  #if WIFI_CACHE_STATIC_IP
+    if (cache.ip != 0) {
+      WiFi.config(IPAddress(cache.ip), IPAddress(cache.gateway),
+                  IPAddress(cache.subnet), IPAddress(cache.dns));
+    }
+  #endif
+  WiFi.begin(ssid.c_str(), psk.c_str(), cache.channel, cache.bssid, true);  // Current config: ssid/psk + BSSID pin
+
+  unsigned long start = millis();
+  while (WiFi.status() != WL_CONNECTED) {
+    if (millis() - start >= WIFI_FAST_TIMEOUT) {
+      DEBUG(Serial.println("WiFi fast path timed out, falling back to WiFiManager"));
+      // disconnect() blanks the whole current config (ssid/psk too), and
+      // WiFiManager's autoConnect() reconnects with a bare WiFi.begin() from
+      // that config - so write ssid/psk back without the BSSID pin/channel
+      WiFi.disconnect(false);
+      WiFi.begin(ssid.c_str(), psk.c_str());
+      #if WIFI_CACHE_STATIC_IP
+        WiFi.config(IPAddress(0, 0, 0, 0), IPAddress(0, 0, 0, 0), IPAddress(0, 0, 0, 0));
+      #endif
+      WiFi.persistent(true);  // WiFiManager saves what the portal configures
+      return false;
+    }
+    delay(10);
+  }
+  WiFi.persistent(true);
+  return true;
+}
+
 // ======================== FORWARD DECLARATIONS ========================
 void configModeCallback(WiFiManager* myWiFiManager);
+void displayTask();
+void httpTask();
+void sensorTask();
+void ntpTask();
+void ntpTimeoutTask();
+void statusTask();
+void frameInputTask();
+void max7219EmuTask();
+void mdMaxTask();
+void animationTask();
+void infoPanelTask();
+void timerTask();
+void timerControlTask();
+void alarmFlashTask();
+void fleetSyncTask();
+void telemetryTask();
+void marqueeTask();
+void mqttTask();
+
+// scheduler.addPeriodic() for setup(): a full table returns SCHED_INVALID
+// and the task would never run, so say which one was lost
+int addPeriodicTask(const char* name, TaskFunction fn, uint32_t period, uint8_t priority, int32_t firstDelay = -1) {
+  int id = scheduler.addPeriodic(name, fn, period, priority, firstDelay);
+  if (id == SCHED_INVALID) {
+    LOG(LOG_SYS, LOG_ERROR, "Scheduler table full (%d tasks): '%s' will not run", SCHED_MAX_TASKS, name);
+  }
+  return id;
+}
+
+// scheduler.addOneShot() for setup(), registered idle until runIn() arms it
+int addIdleTask(const char* name, TaskFunction fn, uint8_t priority) {
+  int id = scheduler.addOneShot(name, fn, 0, priority);
+  if (id == SCHED_INVALID) {
+    LOG(LOG_SYS, LOG_ERROR, "Scheduler table full (%d tasks): '%s' will not run", SCHED_MAX_TASKS, name);
+  }
+  scheduler.setActive(id, false);
+  return id;
+}
 
 // ======================== SETUP ========================
 
@@ -1335,8 +4141,19 @@ void setup() {
   
   // Initialize TFT display
   initTFT();
+  initDisplaySinks();
+  #if ANALOG_MODE_ENABLED
+    analogClock.begin();
+  #endif
 
-  showMessage("INIT");
+  // Warm boot: restore time + settings from RTC memory and show the clock at once
+  warmBoot = restoreRtcState();
+  if (warmBoot) {
+    updateTime();
+  } else {
+    showMessage("INIT");
+  }
+  settimeofday_cb(onNTPTimeSet);
 
   // Test sensor
   sensorAvailable = testSensor();
@@ -1344,71 +4161,392 @@ void setup() {
     updateSensorData();
   }
   
-  // WiFi setup
+  // WiFi setup - cached BSSID/channel first, full WiFiManager flow on failure
+  EEPROM.begin(EEPROM_SIZE);
+  wifiGotIpHandler = WiFi.onStationModeGotIP([](const WiFiEventStationModeGotIP&) { wifiConnects++; });
+  #if ALARMS_ENABLED
+    loadAlarms();  // Indexed on the first tick with a valid clock
+  #endif
+  #if SPI_CAL_ENABLED
+    loadSpiClock();
+    #if SPI_CAL_AT_BOOT
+      if (spiClockSource == SPI_CLOCK_DEFAULT && !warmBoot) calibrateSpiClock();  // First boot of this unit
+    #endif
+  #endif
   wifiManager.setAPCallback(configModeCallback);
   wifiManager.setTimeout(180);
   
-  if (!wifiManager.autoConnect("TFT_Clock_Setup")) {
+  unsigned long wifiStart = millis();
+  wifiFastPathUsed = fastReconnect();
+  if (!wifiFastPathUsed && !wifiManager.autoConnect("TFT_Clock_Setup")) {
     DEBUG(Serial.println("Failed to connect, restarting..."));
     delay(3000);
+    saveRtcState();
     ESP.restart();
   }
+  wifiConnectMs = millis() - wifiStart;
+  bootToOnlineMs = millis();
+  saveWifiCache();
   
   DEBUG(Serial.printf("Connected! IP: %s\n", WiFi.localIP().toString().c_str()));
-  showMessage("WIFI OK");
-  delay(1000);
+  DEBUG(Serial.printf("WiFi: %s path, connect %lums, boot-to-online %lums\n",
+                      wifiFastPathUsed ? "fast" : "full", wifiConnectMs, bootToOnlineMs));
+  if (!warmBoot) {
+    showMessage("WIFI OK");
+    delay(1000);
+  }
   
-  // Sync time
+  // Sync time. A cold boot has no clock to show until the first reply,
+  // and nothing is scheduled yet, so waiting for it here stalls nothing
+  taskNTPTimeout = addIdleTask("ntptimeout", ntpTimeoutTask, 0);
   syncNTP();
-  showMessage("TIME OK");
-  delay(1000);
+  if (!warmBoot) {
+    unsigned long start = millis();
+    while (ntpSyncCount == ntpSyncsBefore && millis() - start < NTP_SYNC_TIMEOUT) {
+      delay(100);
+    }
+    showMessage("TIME OK");
+    delay(1000);
+  }
   
   // Start web server
   setupWebServer();
-  showMessage("READY");
-  delay(1000);
+  if (!warmBoot) {
+    showMessage("READY");
+    delay(1000);
 
-  // Initialize display with current time
-  clearScreen();
-  tft.fillScreen(BG_COLOR);
+    // Initialize display with current time
+    clearScreen();
+    tft.fillScreen(BG_COLOR);
+    invalidateInfoPanel();
+  }
   updateTime();
-
-  lastNTPSync = millis();
-  lastSensorUpdate = millis();
-  lastStatusPrint = millis();
   lastModeSwitch = millis();
+
+  // Register periodic work with the scheduler (higher priority runs first)
+  taskDisplay = addPeriodicTask("display", displayTask, 1000, 3, 0);
+  taskHttp    = addPeriodicTask("http", httpTask, HTTP_POLL_INTERVAL, 2, 0);
+  taskSensor  = addPeriodicTask("sensor", sensorTask, SENSOR_UPDATE_INTERVAL, 1);
+  taskNTP     = addPeriodicTask("ntp", ntpTask, NTP_SYNC_INTERVAL, 0);
+  taskStatus  = addPeriodicTask("status", statusTask, STATUS_PRINT_INTERVAL, 0);
+
+  #if FRAME_INPUT_ENABLED
+    frameUdp.begin(FRAME_UDP_PORT);
+    taskFrameInput = addPeriodicTask("frames", frameInputTask, FRAME_POLL_INTERVAL, 2, 0);
+    LOG(LOG_SYS, LOG_INFO, "Frame input listening on UDP %d", FRAME_UDP_PORT);
+  #endif
+  #if MAX7219_EMU_ENABLED
+    max7219Udp.begin(MAX7219_EMU_UDP_PORT);
+    taskMax7219Emu = addPeriodicTask("max7219", max7219EmuTask, FRAME_POLL_INTERVAL, 2, 0);
+    LOG(LOG_SYS, LOG_INFO, "MAX7219 emulator listening on UDP %d", MAX7219_EMU_UDP_PORT);
+  #endif
+  #if LIFE_MODE_ENABLED
+    life.setRule(LIFE_RULE);
+  #endif
+  #if SPECTRUM_MODE_ENABLED
+    spectrum.begin();
+    spectrum.setNoiseFloor(SPECTRUM_NOISE_FLOOR);
+  #endif
+  #if LIFE_MODE_ENABLED || SPECTRUM_MODE_ENABLED
+    taskAnimation = addPeriodicTask("animation", animationTask, ANIMATION_INTERVAL, 3, 0);
+  #endif
+  #if MDMAX_SHIM_ENABLED
+    mx.begin();
+    mxBottom.begin();
+    taskMdMax = addPeriodicTask("mdmax", mdMaxTask, FRAME_POLL_INTERVAL, 2, 0);
+  #endif
+  #if TIMER_MODES_ENABLED
+    countdown.setDuration(TIMER_DEFAULT_COUNTDOWN * 1000UL);
+    timerUdp.begin(TIMER_UDP_PORT);
+    taskTimer = addPeriodicTask("timer", timerTask, 1000 / timerRefreshHz, 3, 0);
+    scheduler.setActive(taskTimer, false);  // Enabled by setDisplayMode() when a timer is shown
+    taskTimerControl = addPeriodicTask("timerctl", timerControlTask, TIMER_CONTROL_INTERVAL, 2, 0);
+    LOG(LOG_SYS, LOG_INFO, "Timer control listening on UDP %d", TIMER_UDP_PORT);
+  #endif
+  #if MARQUEE_ENABLED
+    taskMarquee = addPeriodicTask("marquee", marqueeTask, MARQUEE_STEP_MS, 3, 0);
+    scheduler.setActive(taskMarquee, displayModes[currentMode].compose == displayMarquee);  // Then toggled by setDisplayMode()
+  #endif
+  #if ALARMS_ENABLED
+    taskAlarmFlash = addPeriodicTask("alarmflash", alarmFlashTask, ALARM_FLASH_INTERVAL, 3, 0);
+    scheduler.setActive(taskAlarmFlash, false);  // Enabled by fireAlarms()
+  #endif
+  #if FLEET_SYNC_ENABLED
+    taskFleetSync = addPeriodicTask("fleetsync", fleetSyncTask, FLEET_POLL_INTERVAL, 3, 0);
+    setFleetRole(fleetRole);  // Follower polling only runs while following
+  #endif
+  #if MQTT_ENABLED
+    setupMqtt();
+    taskTelemetry = addPeriodicTask("telemetry", telemetryTask, MQTT_SAMPLE_INTERVAL, 1);
+    taskMqtt = addPeriodicTask("mqtt", mqttTask, MQTT_SERVICE_INTERVAL, 1, 0);
+  #endif
+  #if INFO_PANEL_ENABLED
+    // Lowest priority: only ever draws when nothing display-critical is due
+    if (initInfoPanel()) {
+      taskInfoPanel = addPeriodicTask("infopanel", infoPanelTask, INFO_PANEL_INTERVAL, 0, 0);
+    }
+  #endif
 }
 
-// ======================== MAIN LOOP ========================
+// ======================== SCHEDULED TASKS ========================
 
-void loop() {
-  server.handleClient();
-  
-  unsigned long now = millis();
-  
-  // Update time
+void displayTask() {
   updateTime();
+  #if FLEET_SYNC_ENABLED
+    if (fleetRole == FLEET_LEADER) sendFleetBeacon();
+  #endif
 
-  // Update sensor data
-  if (sensorAvailable && now - lastSensorUpdate >= SENSOR_UPDATE_INTERVAL) {
-    updateSensorData();
-    lastSensorUpdate = now;
+  // Wake just after the next second edge rather than polling for it
+  struct timeval tv;
+  displayClock(tv);
+  scheduler.runIn(taskDisplay, 1000 - tv.tv_usec / 1000 + 2);
+}
+
+// Frame tick for animated modes; a flag test when the current mode is static
+void animationTask() {
+  if (!(displayModes[currentMode].deps & DEP_ANIMATION)) return;
+  unsigned long start = micros();
+  markDisplayDirty(DEP_ANIMATION);
+  renderCurrentMode();
+  animationFrameUs = micros() - start;
+}
+
+void httpTask() {
+  LatencyProbe timing(latency, latHandleClient);
+  TRACE_SCOPE("handleClient");
+  server.handleClient();
+}
+
+void sensorTask() {
+  updateSensorData();  // No-op when sensor is not available
+}
+
+void ntpTask() {
+  syncNTP();
+}
+
+void statusTask() {
+  HeapSample heap = memStats.sample();
+  LOG(LOG_SYS, LOG_INFO, "Time: %02d:%02d | Date: %02d/%02d/%04d | Load: %d%%",
+      hours24, minutes, day, month, year, scheduler.loadPercent());
+  LOG(LOG_SENSOR, LOG_INFO, "Temp: %d°C | Hum: %d%% | Pressure: %d hPa", temperature, humidity, pressure);
+  LOG(LOG_SYS, LOG_INFO, "Heap: %u free, %u block, %u%% frag (low %u)",
+      heap.freeHeap, heap.maxBlock, heap.fragmentation, memStats.lowFree);
+}
+
+#if FRAME_INPUT_ENABLED
+// Decode every queued datagram, then present only the newest frame
+void frameInputTask() {
+  uint8_t packet[FRAME_PKT_MAX];
+  bool wasActive = frameInput.isActive();
+
+  int size;
+  while ((size = frameUdp.parsePacket()) > 0) {
+    int len = frameUdp.read(packet, sizeof(packet));
+    if (len < size) len = 0;  // Oversized datagram - counted as malformed
+    frameInput.handlePacket(packet, len, millis());
   }
-  
-  // Periodic NTP sync
-  if (now - lastNTPSync >= NTP_SYNC_INTERVAL) {
-    syncNTP();
-    lastNTPSync = now;
+  frameInput.expire(millis());
+
+  if (frameInput.takeFrame(scr)) {
+    refreshAll();
   }
-  
-  // Print status
-  if (now - lastStatusPrint >= STATUS_PRINT_INTERVAL) {
-    DEBUG(Serial.printf("Time: %02d:%02d | Date: %02d/%02d/%04d | Temp: %d°C | Hum: %d%% | Pressure: %d hPa\n",
-                        hours24, minutes, day, month, year, temperature, humidity, pressure));
-    lastStatusPrint = now;
+  if (wasActive && !frameInput.isActive()) {
+    LOG(LOG_DISPLAY, LOG_INFO, "Frame input ended - back to clock");
+    markDisplayDirty(DEP_ALL);
+    renderCurrentMode();
+  } else if (!wasActive && frameInput.isActive()) {
+    LOG(LOG_DISPLAY, LOG_INFO, "Frame input started");
   }
-  
-  delay(100);
+}
+#endif
+
+#if MAX7219_EMU_ENABLED
+// Decode queued register writes, then refresh once for the whole batch
+void max7219EmuTask() {
+  uint8_t buf[256];
+  bool wasActive = max7219Emu.isActive();
+  uint8_t lastIntensity = max7219Emu.intensity();
+
+  while (max7219Udp.parsePacket() > 0) {
+    int len;
+    while ((len = max7219Udp.read(buf, sizeof(buf))) > 0) {
+      max7219Emu.feed(buf, len, millis());
+    }
+    max7219Emu.resync();  // Packets never span datagrams
+  }
+  #if MAX7219_EMU_SERIAL
+    int avail;
+    while ((avail = Serial.available()) > 0) {
+      int len = Serial.readBytes(buf, avail < (int)sizeof(buf) ? avail : sizeof(buf));
+      max7219Emu.feed(buf, len, millis());
+    }
+  #endif
+  max7219Emu.expire(millis());
+
+  if (!max7219Emu.isActive()) {
+    if (wasActive) {
+      LOG(LOG_DISPLAY, LOG_INFO, "MAX7219 stream ended - back to clock");
+      digitalWrite(LED_PIN, HIGH);  // Full backlight again
+      markDisplayDirty(DEP_ALL);
+      renderCurrentMode();
+    }
+    return;
+  }
+  if (!wasActive) {
+    LOG(LOG_DISPLAY, LOG_INFO, "MAX7219 stream started");
+  }
+  if (max7219Emu.takeFrame(scr)) {
+    refreshAll();
+  }
+  // One backlight for the whole panel: follow the brightest module
+  uint8_t level = max7219Emu.intensity();
+  if (!wasActive || level != lastIntensity) {
+    analogWrite(LED_PIN, (level + 1) * 16 - 1);
+  }
+}
+#endif
+
+#if INFO_PANEL_ENABLED
+// Redraw changed info fields, within budget so the matrix tick is never held up
+void infoPanelTask() {
+  if (tftSink.isScrolling()) return;  // Bands pan with the marquee - blank until it ends
+  TRACE_SCOPE("infoPanel");
+  infoPanel.update(INFO_PANEL_BUDGET_US);
+}
+#endif
+
+#if MARQUEE_ENABLED
+void marqueeTask() {
+  unsigned long start = micros();
+  marqueeLastBytes = marqueeStep();
+  marqueeLastUs = micros() - start;
+  if (tftSink.isScrolling()) {
+    marqueeHwSteps++;
+    marqueeHwBytes += marqueeLastBytes;
+  } else {
+    marqueeSwSteps++;
+    marqueeSwBytes += marqueeLastBytes;
+  }
+}
+#endif
+
+#if TIMER_MODES_ENABLED
+// Fixed-rate frame while a timer is shown; refreshAll() only pushes the changed digit columns
+void timerTask() {
+  static uint8_t previous[sizeof(scr)];
+  unsigned long start = micros();
+  markDisplayDirty(DEP_TIMER);
+  renderCurrentMode();
+  timerMeter.frame(start, micros() - start);
+  timerChangedBytes += __builtin_popcountll(frameDiff(scr, previous));
+}
+
+// Text commands over UDP ("countdown 90", "start", ...), reply is the status JSON.
+// Also brings a finished countdown on screen even if another mode is showing.
+void timerControlTask() {
+  if (countdown.poll(millis())) {
+    LOG(LOG_DISPLAY, LOG_INFO, "Countdown finished");
+    showTimer(countdown);
+  }
+
+  while (timerUdp.parsePacket() > 0) {
+    char cmd[32];
+    int len = timerUdp.read((uint8_t*)cmd, sizeof(cmd) - 1);
+    if (len < 0) len = 0;
+    while (len > 0 && isspace((unsigned char)cmd[len - 1])) len--;
+    cmd[len] = 0;
+
+    char* arg = strchr(cmd, ' ');
+    long value = 0;
+    if (arg) {
+      *arg++ = 0;
+      value = atol(arg);
+    }
+    bool ok = timerCommand(cmd, value);
+    String reply = ok ? timerStatusJson() : String("{\"error\":\"unknown command\"}");
+    timerUdp.beginPacket(timerUdp.remoteIP(), timerUdp.remotePort());
+    timerUdp.write((const uint8_t*)reply.c_str(), reply.length());
+    timerUdp.endPacket();
+  }
+}
+#endif
+
+#if ALARMS_ENABLED
+// Alternate normal/inverted frames until the flash time is up
+void alarmFlashTask() {
+  if ((long)(millis() - alarmFlashUntil) >= 0) {
+    stopAlarmFlash();
+    return;
+  }
+  alarmFlashInverted = !alarmFlashInverted;
+  markDisplayDirty(DEP_ALL);
+  renderCurrentMode();
+}
+#endif
+
+#if FLEET_SYNC_ENABLED
+// Follower: stamp beacons as soon as they are seen. A stepped offset moves
+// the second edge, so the display task is re-aimed at once.
+void fleetSyncTask() {
+  uint8_t packet[PHASE_PKT_SIZE + 1];
+  bool wasLocked = fleetSync.isLocked();
+  uint32_t steps = fleetSync.stepCount();
+
+  while (fleetUdp.parsePacket() > 0) {
+    struct timeval tv;
+    gettimeofday(&tv, nullptr);
+    int len = fleetUdp.read(packet, sizeof(packet));
+    if (len < 0) len = 0;
+    fleetSync.handleBeacon(packet, len, (uint32_t)fleetUdp.remoteIP(),
+                           (int64_t)tv.tv_sec * 1000000LL + tv.tv_usec, millis());
+  }
+  fleetSync.expire(millis());
+
+  if (fleetSync.isLocked() != wasLocked) {
+    LOG(LOG_NTP, LOG_INFO, "Fleet sync %s", fleetSync.isLocked() ? "locked" : "lost - using local clock");
+  }
+  if (fleetSync.stepCount() != steps || fleetSync.isLocked() != wasLocked) {
+    scheduler.runIn(taskDisplay, 0);
+  }
+}
+#endif
+
+#if MQTT_ENABLED
+void telemetryTask() {
+  sampleTelemetry();
+}
+
+void mqttTask() {
+  unsigned long start = micros();
+  serviceMqtt();
+  unsigned long us = micros() - start;
+  if (us > mqttMaxServiceUs) mqttMaxServiceUs = us;
+}
+#endif
+
+#if MDMAX_SHIM_ENABLED
+// Batched MD_MAX72xx updates: every draw call since the last poll goes out in one refresh
+void mdMaxTask() {
+  mx.service();
+  mxBottom.service();
+}
+#endif
+
+// ======================== MAIN LOOP ========================
+
+void loop() {
+  // Run due tasks, then sleep only until the next deadline
+  // (delay() still services the WiFi stack while idle)
+  latency.beginIteration();
+  uint32_t sleepMs = scheduler.runDue(SCHED_MAX_SLEEP);
+  latency.endIteration();  // Iteration time excludes the idle sleep
+
+  // Idle: format queued log records into whatever room the UART FIFO has
+  #if DEBUG_ENABLED
+    if (sleepMs > 0) eventLog.drain(Serial);
+  #endif
+  delay(sleepMs);
 }
 
 // ======================== HELPER FUNCTIONS ========================
@@ -0,0 +1,16 @@
+// Adafruit_BME280.h - host stand-in (native tests): no sensor present
+#pragma once
+#include <Wire.h>
+
+class Adafruit_BME280 {
+public:
+  enum sensor_mode { MODE_FORCED };
+  enum sensor_sampling { SAMPLING_X1 };
+  enum sensor_filter { FILTER_OFF };
+  bool begin(int, TwoWire*) { return false; }
+  void setSampling(sensor_mode, sensor_sampling, sensor_sampling, sensor_sampling, sensor_filter) {}
+  bool takeForcedMeasurement() { return false; }
+  float readTemperature() { return NAN; }
+  float readHumidity() { return NAN; }
+  float readPressure() { return NAN; }
+};
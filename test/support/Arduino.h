@@ -0,0 +1,223 @@
+/*
+ * Arduino.h - Host Stand-In for the ESP8266 Arduino Core (native tests)
+ *
+ * Just enough of the core for include/ and src/main_tft.cpp to compile
+ * and run on the build machine. Everything is header-only, so a test
+ * suite needs no extra sources.
+ *
+ * Time is a fake clock: it starts at 0 and only moves when a test calls
+ * hostAdvanceMs()/hostAdvanceUs() or the code under test calls delay().
+ * analogRead() returns hostAnalogRead(pin) when a test installs one.
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <ctype.h>
+#include <math.h>
+#include <stdarg.h>
+#include <string>
+#include "binary.h"
+
+typedef uint8_t byte;
+typedef bool boolean;
+
+#define PROGMEM
+#define PSTR(x) (x)
+#define F(x) (x)
+#define pgm_read_byte(p)  (*(const uint8_t*)(p))
+#define pgm_read_word(p)  (*(const uint16_t*)(p))
+#define pgm_read_dword(p) (*(const uint32_t*)(p))
+#define memcpy_P memcpy
+#define strcpy_P strcpy
+#define strlen_P strlen
+#define snprintf_P snprintf
+#define ICACHE_RAM_ATTR
+#define IRAM_ATTR
+
+#define HIGH   1
+#define LOW    0
+#define OUTPUT 1
+#define INPUT  0
+
+#define D0 16
+#define D1 5
+#define D2 4
+#define D3 0
+#define D4 2
+#define D5 14
+#define D6 12
+#define D7 13
+#define D8 15
+#define A0 17
+#define PIN_D1 5
+#define PIN_D2 4
+#define PIN_D6 12
+
+// ---- Fake clock ----
+inline uint64_t hostMicros = 0;
+inline void hostAdvanceUs(uint64_t us) { hostMicros += us; }
+inline void hostAdvanceMs(uint32_t ms) { hostMicros += ms * 1000ULL; }
+
+inline unsigned long millis() { return (uint32_t)(hostMicros / 1000); }
+inline unsigned long micros() { return (uint32_t)hostMicros; }
+inline uint64_t micros64() { return hostMicros; }
+inline void delay(unsigned long ms) { hostAdvanceMs(ms); }
+inline void delayMicroseconds(unsigned int us) { hostAdvanceUs(us); }
+inline void yield() {}
+
+// ---- Pins ----
+inline int (*hostAnalogRead)(int pin) = nullptr;
+inline int analogRead(int pin) { return hostAnalogRead ? hostAnalogRead(pin) : 0; }
+inline void pinMode(int, int) {}
+inline void digitalWrite(int, int) {}
+inline int digitalRead(int) { return 0; }
+inline void analogWrite(int, int) {}
+inline void analogWriteRange(uint32_t) {}
+inline void analogWriteFreq(uint32_t) {}
+
+// Deterministic, so renders that use random() are repeatable
+inline uint32_t hostRandomState = 1;
+inline long random(long howBig) {
+  if (howBig <= 0) return 0;
+  hostRandomState = hostRandomState * 1103515245UL + 12345UL;
+  return (hostRandomState >> 8) % howBig;
+}
+inline long random(long lo, long hi) { return hi > lo ? lo + random(hi - lo) : lo; }
+inline void randomSeed(unsigned long seed) { hostRandomState = seed ? seed : 1; }
+
+template <class T> T min(T a, T b) { return a < b ? a : b; }
+template <class T> T max(T a, T b) { return a > b ? a : b; }
+template <class T, class L, class H> T constrain(T x, L lo, H hi) { return x < lo ? lo : (x > hi ? hi : x); }
+
+// ---- String (the subset the sketch uses) ----
+class String {
+public:
+  std::string s;
+  String() {}
+  String(const char* c) : s(c ? c : "") {}
+  String(const std::string& c) : s(c) {}
+  String(char c) : s(1, c) {}
+  String(int v) : s(std::to_string(v)) {}
+  String(unsigned v) : s(std::to_string(v)) {}
+  String(long v) : s(std::to_string(v)) {}
+  String(unsigned long v) : s(std::to_string(v)) {}
+  String(long long v) : s(std::to_string(v)) {}
+  String(unsigned long long v) : s(std::to_string(v)) {}
+  String(float v, int d = 2) { char b[32]; snprintf(b, sizeof(b), "%.*f", d, v); s = b; }
+  String(double v, int d = 2) { char b[32]; snprintf(b, sizeof(b), "%.*f", d, v); s = b; }
+  const char* c_str() const { return s.c_str(); }
+  unsigned length() const { return s.size(); }
+  long toInt() const { return atol(s.c_str()); }
+  float toFloat() const { return atof(s.c_str()); }
+  void reserve(unsigned n) { s.reserve(n); }
+  String& operator+=(const String& o) { s += o.s; return *this; }
+  String& operator+=(const char* o) { s += o; return *this; }
+  String& operator+=(char o) { s += o; return *this; }
+  String& operator+=(int o) { s += std::to_string(o); return *this; }
+  bool operator==(const char* o) const { return s == o; }
+  bool operator==(const String& o) const { return s == o.s; }
+  bool operator!=(const char* o) const { return s != o; }
+  char operator[](unsigned i) const { return s[i]; }
+  bool equalsIgnoreCase(const String& o) const { return strcasecmp(s.c_str(), o.s.c_str()) == 0; }
+  int indexOf(char c) const { size_t p = s.find(c); return p == std::string::npos ? -1 : (int)p; }
+  int indexOf(const char* c) const { size_t p = s.find(c); return p == std::string::npos ? -1 : (int)p; }
+  void toLowerCase() { for (auto& ch : s) ch = tolower(ch); }
+  String substring(unsigned a) const { return String(s.substr(a)); }
+  String substring(unsigned a, unsigned b) const { return String(s.substr(a, b - a)); }
+  bool startsWith(const char* p) const { return s.rfind(p, 0) == 0; }
+};
+inline String operator+(const String& a, const String& b) { return String(a.s + b.s); }
+inline String operator+(const String& a, const char* b) { return String(a.s + b); }
+inline String operator+(const char* a, const String& b) { return String(std::string(a) + b.s); }
+inline String operator+(const String& a, char b) { return String(a.s + b); }
+
+// ---- Print / Stream / Serial ----
+class Print {
+public:
+  virtual ~Print() {}
+  virtual size_t write(uint8_t) = 0;
+  virtual size_t write(const uint8_t* b, size_t n) { for (size_t i = 0; i < n; i++) write(b[i]); return n; }
+  size_t write(const char* s) { return write((const uint8_t*)s, strlen(s)); }
+  size_t print(const char*) { return 0; }
+  size_t print(const String&) { return 0; }
+  size_t print(int) { return 0; }
+  size_t println(const char* = "") { return 0; }
+  size_t println(const String&) { return 0; }
+  size_t println(int) { return 0; }
+  size_t printf(const char*, ...) __attribute__((format(printf, 2, 3))) { return 0; }
+};
+
+class Stream : public Print {
+public:
+  virtual int available() { return 0; }
+  virtual int read() { return -1; }
+  virtual int peek() { return -1; }
+  size_t readBytes(uint8_t*, size_t) { return 0; }
+};
+
+class HardwareSerial : public Stream {
+public:
+  void begin(unsigned long) {}
+  size_t write(uint8_t) override { return 1; }
+  using Print::write;
+  int availableForWrite() { return 64; }
+  void flush() {}
+  operator bool() { return true; }
+};
+inline HardwareSerial Serial;
+
+class IPAddress {
+public:
+  IPAddress() {}
+  IPAddress(uint8_t, uint8_t, uint8_t, uint8_t) {}
+  IPAddress(uint32_t) {}
+  String toString() const { return "0.0.0.0"; }
+  operator uint32_t() const { return 0; }
+  bool isSet() const { return true; }
+  uint8_t operator[](int) const { return 0; }
+  bool fromString(const char*) { return true; }
+};
+
+// ---- ESP ----
+enum RstReason {
+  REASON_DEFAULT_RST = 0, REASON_WDT_RST = 1, REASON_EXCEPTION_RST = 2, REASON_SOFT_WDT_RST = 3,
+  REASON_SOFT_RESTART = 4, REASON_DEEP_SLEEP_AWAKE = 5, REASON_EXT_SYS_RST = 6
+};
+struct rst_info { uint32_t reason; };
+
+class EspClass {
+public:
+  rst_info resetInfo = {REASON_DEFAULT_RST};  // Tests set the reason they simulate
+  uint32_t rtcMemory[128] = {};               // RTC user memory, 512 bytes
+  bool restarted = false;
+
+  void restart() { restarted = true; }
+  uint32_t getFreeHeap() { return 40000; }
+  uint32_t getMaxFreeBlockSize() { return 30000; }
+  uint8_t getHeapFragmentation() { return 10; }
+  void getHeapStats(uint32_t* f, uint16_t* m, uint8_t* h) { *f = 40000; *m = 30000; *h = 10; }
+  bool rtcUserMemoryRead(uint32_t offset, uint32_t* data, size_t size) {
+    if (offset * 4 + size > sizeof(rtcMemory)) return false;
+    memcpy(data, (uint8_t*)rtcMemory + offset * 4, size);
+    return true;
+  }
+  bool rtcUserMemoryWrite(uint32_t offset, uint32_t* data, size_t size) {
+    if (offset * 4 + size > sizeof(rtcMemory)) return false;
+    memcpy((uint8_t*)rtcMemory + offset * 4, data, size);
+    return true;
+  }
+  rst_info* getResetInfoPtr() { return &resetInfo; }
+  String getResetReason() { return ""; }
+  uint32_t getCycleCount() { return (uint32_t)(hostMicros * 80); }
+  uint32_t getChipId() { return 0x1A2B3C; }
+  uint32_t getFreeSketchSpace() { return 1024 * 1024; }
+  uint32_t getSketchSize() { return 512 * 1024; }
+  uint32_t getCpuFreqMHz() { return 80; }
+  void wdtFeed() {}
+};
+inline EspClass ESP;
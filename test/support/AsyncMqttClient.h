@@ -0,0 +1,24 @@
+// AsyncMqttClient.h - host stand-in (native tests): never connects
+#pragma once
+#include <Arduino.h>
+#include <functional>
+enum class AsyncMqttClientDisconnectReason : uint8_t { TCP_DISCONNECTED = 0, MQTT_UNACCEPTABLE_PROTOCOL_VERSION = 1, MQTT_IDENTIFIER_REJECTED = 2, MQTT_SERVER_UNAVAILABLE = 3, MQTT_MALFORMED_CREDENTIALS = 4, MQTT_NOT_AUTHORIZED = 5, ESP8266_NOT_ENOUGH_SPACE = 6, TLS_BAD_FINGERPRINT = 7 };
+class AsyncMqttClient {
+public:
+  typedef std::function<void(bool)> OnConnect;
+  typedef std::function<void(AsyncMqttClientDisconnectReason)> OnDisconnect;
+  typedef std::function<void(uint16_t)> OnPublish;
+  AsyncMqttClient& setKeepAlive(uint16_t) { return *this; }
+  AsyncMqttClient& setClientId(const char*) { return *this; }
+  AsyncMqttClient& setCredentials(const char*, const char* = nullptr) { return *this; }
+  AsyncMqttClient& setWill(const char*, uint8_t, bool, const char*, size_t = 0) { return *this; }
+  AsyncMqttClient& setServer(const char*, uint16_t) { return *this; }
+  AsyncMqttClient& onConnect(OnConnect c) { oc = c; return *this; }
+  AsyncMqttClient& onDisconnect(OnDisconnect c) { od = c; return *this; }
+  AsyncMqttClient& onPublish(OnPublish c) { op = c; return *this; }
+  bool connected() const { return false; }
+  void connect() {}
+  void disconnect(bool = false) {}
+  uint16_t publish(const char*, uint8_t, bool, const char* = nullptr, size_t = 0, bool = false, uint16_t = 0) { return 1; }
+  OnConnect oc; OnDisconnect od; OnPublish op;
+};
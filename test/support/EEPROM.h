@@ -0,0 +1,17 @@
+// EEPROM.h - host stand-in (native tests): a RAM array, erased to 0
+#pragma once
+#include <Arduino.h>
+
+class EEPROMClass {
+public:
+  uint8_t data[4096];
+  void begin(size_t) {}
+  bool commit() { return true; }
+  void end() {}
+  template <class T> T& get(int address, T& t) { memcpy(&t, data + address, sizeof(T)); return t; }
+  template <class T> const T& put(int address, const T& t) { memcpy(data + address, &t, sizeof(T)); return t; }
+  uint8_t read(int address) { return data[address]; }
+  void write(int address, uint8_t v) { data[address] = v; }
+  uint8_t* getDataPtr() { return data; }
+};
+inline EEPROMClass EEPROM;
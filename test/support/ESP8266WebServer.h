@@ -0,0 +1,47 @@
+// ESP8266WebServer.h - host stand-in (native tests): handlers register, nothing is served
+#pragma once
+#include <ESP8266WiFi.h>
+#include <functional>
+
+#define CONTENT_LENGTH_UNKNOWN ((size_t)-1)
+enum HTTPMethod { HTTP_ANY, HTTP_GET, HTTP_POST, HTTP_PUT };
+enum HTTPUploadStatus { UPLOAD_FILE_START, UPLOAD_FILE_WRITE, UPLOAD_FILE_END, UPLOAD_FILE_ABORTED };
+
+struct HTTPUpload {
+  HTTPUploadStatus status;
+  String filename, name, type;
+  size_t totalSize, currentSize, contentLength;
+  uint8_t buf[2048];
+};
+
+class ESP8266WebServer {
+public:
+  typedef std::function<void(void)> THandlerFunction;
+  ESP8266WebServer(int) {}
+  void on(const char*, THandlerFunction) {}
+  void on(const char*, HTTPMethod, THandlerFunction) {}
+  void on(const char*, HTTPMethod, THandlerFunction, THandlerFunction) {}
+  void onNotFound(THandlerFunction) {}
+  void begin() {}
+  void handleClient() {}
+  void send(int, const char*, const String&) {}
+  void send(int, const char*, const char* = "") {}
+  void send_P(int, const char*, const char*) {}
+  void sendHeader(const char*, const String&, bool = false) {}
+  void sendHeader(const char*, const char*, bool = false) {}
+  void setContentLength(size_t) {}
+  void sendContent(const String&) {}
+  void sendContent(const char*) {}
+  void sendContent(const char*, size_t) {}
+  void sendContent_P(const char*) {}
+  bool authenticate(const char*, const char*) { return true; }
+  void requestAuthentication() {}
+  bool hasArg(const char*) { return false; }
+  String arg(const char*) { return ""; }
+  String arg(int) { return ""; }
+  int args() { return 0; }
+  String uri() { return ""; }
+  HTTPMethod method() { return HTTP_GET; }
+  HTTPUpload& upload() { static HTTPUpload u; return u; }
+  WiFiClient client() { return WiFiClient(); }
+};
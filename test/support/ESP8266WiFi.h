@@ -0,0 +1,79 @@
+// ESP8266WiFi.h - host stand-in (native tests): always connected, no traffic
+#pragma once
+#include <Arduino.h>
+#include <functional>
+#include <memory>
+
+#define WL_IDLE_STATUS   0
+#define WL_CONNECTED     3
+#define WL_DISCONNECTED  7
+typedef int wl_status_t;
+#define WIFI_STA     1
+#define WIFI_AP_STA  3
+
+struct WiFiEventStationModeGotIP { IPAddress ip; };
+struct WiFiEventStationModeDisconnected { uint8_t reason; };
+typedef std::shared_ptr<int> WiFiEventHandler;
+
+class WiFiClass {
+public:
+  WiFiEventHandler onStationModeGotIP(std::function<void(const WiFiEventStationModeGotIP&)>) { return nullptr; }
+  WiFiEventHandler onStationModeDisconnected(std::function<void(const WiFiEventStationModeDisconnected&)>) { return nullptr; }
+  IPAddress localIP() { return IPAddress(); }
+  IPAddress softAPIP() { return IPAddress(); }
+  IPAddress gatewayIP() { return IPAddress(); }
+  IPAddress subnetMask() { return IPAddress(); }
+  IPAddress dnsIP(int = 0) { return IPAddress(); }
+  int status() { return WL_CONNECTED; }
+  int32_t RSSI() { return -60; }
+  int32_t channel() { return 1; }
+  uint8_t* BSSID() { static uint8_t b[6]; return b; }
+  String BSSIDstr() { return ""; }
+  String SSID() { return ""; }
+  String psk() { return ""; }
+  int begin(const char*, const char* = nullptr, int32_t = 0, const uint8_t* = nullptr, bool = true) { return 0; }
+  bool config(IPAddress, IPAddress, IPAddress, IPAddress = IPAddress(), IPAddress = IPAddress()) { return true; }
+  bool mode(int) { return true; }
+  bool persistent(bool) { return true; }
+  bool setAutoReconnect(bool) { return true; }
+  bool disconnect(bool = false) { return true; }
+  bool isConnected() { return true; }
+  String macAddress() { return ""; }
+  String hostname() { return ""; }
+  int hostByName(const char*, IPAddress&) { return 1; }
+};
+inline WiFiClass WiFi;
+
+class WiFiClient : public Stream {
+public:
+  size_t write(uint8_t) override { return 1; }
+  using Print::write;
+  bool connected() { return true; }
+  int connect(const char*, uint16_t) { return 1; }
+  int connect(IPAddress, uint16_t) { return 1; }
+  void stop() {}
+  void setNoDelay(bool) {}
+  void setTimeout(unsigned long) {}
+  int availableForWrite() { return 1460; }
+  operator bool() { return true; }
+};
+
+class WiFiUDP : public Stream {
+public:
+  uint8_t begin(uint16_t) { return 1; }
+  uint8_t beginMulticast(IPAddress, IPAddress, uint16_t) { return 1; }
+  void stop() {}
+  int parsePacket() { return 0; }
+  int read() override { return -1; }
+  int read(uint8_t*, size_t) { return 0; }
+  int read(char*, size_t) { return 0; }
+  int beginPacket(IPAddress, uint16_t) { return 1; }
+  int beginPacket(const char*, uint16_t) { return 1; }
+  int beginPacketMulticast(IPAddress, uint16_t, IPAddress, int = 1) { return 1; }
+  int endPacket() { return 1; }
+  size_t write(uint8_t) override { return 1; }
+  using Print::write;
+  IPAddress remoteIP() { return IPAddress(); }
+  uint16_t remotePort() { return 0; }
+  IPAddress destinationIP() { return IPAddress(); }
+};
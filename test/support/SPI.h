@@ -0,0 +1,20 @@
+// SPI.h - host stand-in (native tests): records the clock, transfers nothing
+#pragma once
+#include <Arduino.h>
+
+#define MSBFIRST  1
+#define SPI_MODE0 0
+
+struct SPISettings { SPISettings(uint32_t, uint8_t, uint8_t) {} };
+
+class SPIClass {
+public:
+  uint32_t frequency = 0;
+  void begin() {}
+  void beginTransaction(SPISettings) {}
+  void endTransaction() {}
+  uint8_t transfer(uint8_t) { return 0; }
+  uint16_t transfer16(uint16_t) { return 0; }
+  void setFrequency(uint32_t hz) { frequency = hz; }
+};
+inline SPIClass SPI;
@@ -0,0 +1,67 @@
+// TFT_eSPI.h - host stand-in (native tests): same User_Setup.h, draws nothing.
+// Pixels are checked through the framebuffer sink instead.
+#pragma once
+#include <Arduino.h>
+#include <SPI.h>
+#include "User_Setup.h"
+
+#define TFT_BLACK     0x0000
+#define TFT_WHITE     0xFFFF
+#define TFT_GREEN     0x07E0
+#define TFT_RED       0xF800
+#define TFT_YELLOW    0xFFE0
+#define TFT_CYAN      0x07FF
+#define TFT_DARKGREY  0x7BEF
+#define TL_DATUM      0
+#define TR_DATUM      2
+
+class TFT_eSPI : public Print {
+public:
+  TFT_eSPI(int16_t w = 240, int16_t h = 320) : w0(w), h0(h) {}
+  void init() {}
+  void setRotation(uint8_t r) { rotation = r & 3; }
+  uint8_t getRotation() { return rotation; }
+  int16_t width() { return rotation & 1 ? h0 : w0; }
+  int16_t height() { return rotation & 1 ? w0 : h0; }
+
+  void fillScreen(uint32_t) {}
+  void fillRect(int32_t, int32_t, int32_t, int32_t, uint32_t) {}
+  void drawPixel(int32_t, int32_t, uint32_t) {}
+  void drawFastHLine(int32_t, int32_t, int32_t, uint32_t) {}
+  void drawFastVLine(int32_t, int32_t, int32_t, uint32_t) {}
+  void drawRect(int32_t, int32_t, int32_t, int32_t, uint32_t) {}
+  void drawLine(int32_t, int32_t, int32_t, int32_t, uint32_t) {}
+  void startWrite() {}
+  void endWrite() {}
+  void setAddrWindow(int32_t, int32_t, int32_t, int32_t) {}
+  void setWindow(int32_t, int32_t, int32_t, int32_t) {}
+  void pushColor(uint16_t) {}
+  void pushColor(uint16_t, uint32_t) {}
+  void pushBlock(uint16_t, uint32_t) {}
+  void pushPixels(const void*, uint32_t) {}
+  void pushImage(int32_t, int32_t, int32_t, int32_t, uint16_t*) {}
+  void pushRect(int32_t, int32_t, int32_t, int32_t, uint16_t*) {}
+  void writecommand(uint8_t) {}
+  void writedata(uint8_t) {}
+  uint8_t readcommand8(uint8_t, uint8_t = 0) { return 0; }
+  uint16_t readPixel(int32_t, int32_t) { return 0; }
+  void readRect(int32_t, int32_t, int32_t w, int32_t h, uint16_t* data) { memset(data, 0xFF, w * h * 2); }  // No MISO
+
+  void setTextColor(uint16_t) {}
+  void setTextColor(uint16_t, uint16_t, bool = false) {}
+  void setTextDatum(uint8_t) {}
+  void setTextFont(uint8_t) {}
+  void setTextSize(uint8_t) {}
+  void setTextPadding(uint16_t) {}
+  int16_t drawString(const char*, int32_t, int32_t, uint8_t) { return 0; }
+  int16_t drawString(const char*, int32_t, int32_t) { return 0; }
+  int16_t drawString(const String&, int32_t, int32_t) { return 0; }
+  int16_t drawString(const String&, int32_t, int32_t, uint8_t) { return 0; }
+  int16_t fontHeight(int16_t = 1) { return 16; }
+  int16_t textWidth(const char*, uint8_t = 1) { return 0; }
+  size_t write(uint8_t) override { return 1; }
+
+private:
+  int16_t w0, h0;
+  uint8_t rotation = 0;
+};
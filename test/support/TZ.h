@@ -0,0 +1,9 @@
+// TZ.h - host stand-in (native tests): configTime() only records the zone
+#pragma once
+#include <time.h>
+#include <stdlib.h>
+
+inline void configTime(const char* tz, const char*, const char* = nullptr, const char* = nullptr) {
+  setenv("TZ", tz, 1);
+  tzset();
+}
@@ -0,0 +1,16 @@
+// Updater.h - host stand-in (native tests): accepts and discards everything
+#pragma once
+#include <Arduino.h>
+
+#define U_FLASH 0
+
+class UpdaterClass {
+public:
+  bool begin(size_t, int = U_FLASH) { return true; }
+  bool setMD5(const char*) { return true; }
+  size_t write(uint8_t*, size_t n) { return n; }
+  bool end(bool = false) { return true; }
+  uint8_t getError() { return 0; }
+  bool isRunning() { return false; }
+};
+inline UpdaterClass Update;
@@ -0,0 +1,13 @@
+// WiFiManager.h - host stand-in (native tests): always "connects"
+#pragma once
+#include <ESP8266WiFi.h>
+
+class WiFiManager {
+public:
+  void setAPCallback(void (*)(WiFiManager*)) {}
+  void setTimeout(unsigned long) {}
+  void setConfigPortalTimeout(unsigned long) {}
+  void setConnectTimeout(unsigned long) {}
+  bool autoConnect(const char*) { return true; }
+  void resetSettings() {}
+};
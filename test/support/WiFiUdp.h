@@ -0,0 +1,3 @@
+// WiFiUdp.h - host stand-in (native tests)
+#pragma once
+#include <ESP8266WiFi.h>
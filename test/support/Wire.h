@@ -0,0 +1,6 @@
+// Wire.h - host stand-in (native tests)
+#pragma once
+#include <Arduino.h>
+
+class TwoWire { public: void begin(int, int) {} };
+inline TwoWire Wire;
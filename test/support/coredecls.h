@@ -0,0 +1,5 @@
+// coredecls.h - host stand-in (native tests): the NTP callback never fires
+#pragma once
+#include <functional>
+
+inline void settimeofday_cb(std::function<void()>) {}
@@ -0,0 +1,25 @@
+// sys/time.h - host stand-in (native tests): the real header, but once a
+// test or the sketch calls settimeofday() the wall clock is a fake one that
+// stays where it was set - the build machine's own clock is never touched
+#pragma once
+#include_next <sys/time.h>
+
+inline bool hostWallClockSet = false;
+inline struct timeval hostWallClock = {0, 0};
+
+inline int hostSettimeofday(const struct timeval* tv, const void*) {
+  if (tv) {
+    hostWallClock = *tv;
+    hostWallClockSet = true;
+  }
+  return 0;
+}
+
+inline int hostGettimeofday(struct timeval* tv, void* tz) {
+  if (!hostWallClockSet) return gettimeofday(tv, (struct timezone*)tz);
+  *tv = hostWallClock;
+  return 0;
+}
+
+#define settimeofday hostSettimeofday
+#define gettimeofday hostGettimeofday
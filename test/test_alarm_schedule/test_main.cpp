@@ -0,0 +1,228 @@
+/*
+ * Alarm schedule (include/alarm_schedule.h) on a simulated clock in UK
+ * time: weeks of daily/weekly/rota alarms, both DST changes and the
+ * ALARM_GRACE_SEC skip in poll()
+ */
+
+#include <unity.h>
+#include <stdlib.h>
+#include "alarm_schedule.h"
+
+#define TZ_LONDON  "GMT0BST,M3.5.0/1,M10.5.0"
+#define DAY        86400L
+#define STEP       20   // Seconds between polls, like the 1s tick but faster to run
+
+static AlarmSchedule* sched;
+
+struct Firing {
+  time_t at;      // Trigger time (UTC)
+  uint16_t mask;
+};
+static Firing fired[64];
+static int numFired;
+
+static time_t utc(int year, int month, int day, int hour, int minute) {
+  struct tm t = {};
+  t.tm_year = year - 1900;
+  t.tm_mon = month - 1;
+  t.tm_mday = day;
+  t.tm_hour = hour;
+  t.tm_min = minute;
+  return timegm(&t);
+}
+
+static Alarm alarmAt(int hour, int minute, uint8_t cycle, uint16_t day, uint32_t mask) {
+  Alarm a = {};
+  a.hour = hour;
+  a.minute = minute;
+  a.cycle = cycle;
+  a.day = day;
+  a.mask = mask;
+  a.flags = ALARM_ENABLED;
+  return a;
+}
+
+// Poll every STEP seconds over [from, to), recording each firing
+static void run(time_t from, time_t to) {
+  sched->recompute(from);
+  for (time_t now = from; now < to; now += STEP) {
+    time_t trigger = sched->nextTrigger();
+    uint16_t due = sched->poll(now);
+    if (due && numFired < 64) fired[numFired++] = {trigger, due};
+  }
+}
+
+static struct tm localAt(time_t t) {
+  struct tm tm;
+  localtime_r(&t, &tm);
+  return tm;
+}
+
+void setUp() {
+  setenv("TZ", TZ_LONDON, 1);
+  tzset();
+  sched = new AlarmSchedule();
+  numFired = 0;
+}
+
+void tearDown() {
+  delete sched;
+}
+
+void test_day_numbers() {
+  TEST_ASSERT_EQUAL(0, AlarmSchedule::dayNumber(2000, 1, 1));
+  TEST_ASSERT_EQUAL(ALARM_SUNDAY, AlarmSchedule::dayNumber(2000, 1, 2));
+  int32_t d = AlarmSchedule::dayNumber(2028, 2, 29);
+  int y, m, dd;
+  AlarmSchedule::dayToDate(d, y, m, dd);
+  TEST_ASSERT_EQUAL(2028, y);
+  TEST_ASSERT_EQUAL(2, m);
+  TEST_ASSERT_EQUAL(29, dd);
+  AlarmSchedule::dayToDate(d + 1, y, m, dd);
+  TEST_ASSERT_EQUAL(3, m);
+  TEST_ASSERT_EQUAL(1, dd);
+}
+
+// Daily 07:00 through three weeks spanning the spring change (29 Mar 2026)
+void test_daily_across_spring_forward() {
+  sched->add(alarmAt(7, 0, 1, 0, 0x1));
+  run(utc(2026, 3, 20, 0, 0), utc(2026, 4, 10, 0, 0));
+  TEST_ASSERT_EQUAL(21, numFired);
+  for (int i = 0; i < numFired; i++) {
+    struct tm t = localAt(fired[i].at);
+    TEST_ASSERT_EQUAL(7, t.tm_hour);
+    TEST_ASSERT_EQUAL(0, t.tm_min);
+    TEST_ASSERT_EQUAL(20 + i > 31 ? 20 + i - 31 : 20 + i, t.tm_mday);
+  }
+  TEST_ASSERT_EQUAL(utc(2026, 3, 28, 7, 0), fired[8].at);  // GMT
+  TEST_ASSERT_EQUAL(utc(2026, 3, 29, 6, 0), fired[9].at);  // BST
+}
+
+// Mon/Wed/Fri anchored on a Sunday, four weeks
+void test_weekly_days() {
+  sched->add(alarmAt(6, 30, 7, ALARM_SUNDAY, (1 << 1) | (1 << 3) | (1 << 5)));
+  run(utc(2026, 6, 1, 0, 0), utc(2026, 6, 29, 0, 0));  // Mon 1 Jun .. Sun 28 Jun
+  TEST_ASSERT_EQUAL(12, numFired);
+  for (int i = 0; i < numFired; i++) {
+    struct tm t = localAt(fired[i].at);
+    TEST_ASSERT_EQUAL(1 + 2 * (i % 3), t.tm_wday);
+    TEST_ASSERT_EQUAL(6, t.tm_hour);
+    TEST_ASSERT_EQUAL(30, t.tm_min);
+  }
+}
+
+// 4 on / 4 off rota starting 2 Nov 2026, across the month boundary
+void test_shift_rota() {
+  uint16_t start = AlarmSchedule::dayNumber(2026, 11, 2);
+  sched->add(alarmAt(5, 45, 8, start, 0x0F));
+  run(utc(2026, 11, 1, 0, 0), utc(2026, 12, 3, 0, 0));
+  // 2-5, 10-13, 18-21, 26-29 Nov
+  TEST_ASSERT_EQUAL(16, numFired);
+  const int days[] = {2, 3, 4, 5, 10, 11, 12, 13, 18, 19, 20, 21, 26, 27, 28, 29};
+  for (int i = 0; i < numFired; i++) {
+    TEST_ASSERT_EQUAL(utc(2026, 11, days[i], 5, 45), fired[i].at);
+  }
+}
+
+// 01:30 doesn't exist on 29 Mar 2026: fires once, at 02:30 BST (01:30 UTC)
+void test_spring_forward_gap() {
+  sched->add(alarmAt(1, 30, 1, 0, 0x1));
+  run(utc(2026, 3, 28, 12, 0), utc(2026, 3, 30, 12, 0));
+  TEST_ASSERT_EQUAL(2, numFired);
+  TEST_ASSERT_EQUAL(utc(2026, 3, 29, 1, 30), fired[0].at);
+  struct tm t = localAt(fired[0].at);
+  TEST_ASSERT_EQUAL(2, t.tm_hour);
+  TEST_ASSERT_EQUAL(30, t.tm_min);
+  TEST_ASSERT_EQUAL(utc(2026, 3, 30, 0, 30), fired[1].at);  // 01:30 BST next day
+}
+
+// 01:30 happens twice on 25 Oct 2026 (BST, then GMT): fires once
+void test_fall_back_fires_once() {
+  sched->add(alarmAt(1, 30, 1, 0, 0x1));
+  run(utc(2026, 10, 24, 12, 0), utc(2026, 10, 26, 12, 0));
+  TEST_ASSERT_EQUAL(2, numFired);
+  TEST_ASSERT_EQUAL(1, localAt(fired[0].at).tm_hour);
+  TEST_ASSERT_EQUAL(25, localAt(fired[0].at).tm_mday);
+  TEST_ASSERT_EQUAL(26, localAt(fired[1].at).tm_mday);
+  TEST_ASSERT_EQUAL(utc(2026, 10, 26, 1, 30), fired[1].at);  // GMT
+}
+
+// One-off fires once, disables itself and asks to be saved
+void test_one_off() {
+  sched->add(alarmAt(12, 0, 0, AlarmSchedule::dayNumber(2026, 7, 4), 0));
+  sched->saved();
+  run(utc(2026, 7, 1, 0, 0), utc(2026, 7, 10, 0, 0));
+  TEST_ASSERT_EQUAL(1, numFired);
+  TEST_ASSERT_EQUAL(utc(2026, 7, 4, 11, 0), fired[0].at);  // Noon BST
+  TEST_ASSERT_FALSE(sched->alarm(0).flags & ALARM_ENABLED);
+  TEST_ASSERT_TRUE(sched->needsSave());
+  TEST_ASSERT_EQUAL(ALARM_NONE, sched->nextTrigger());
+}
+
+// Alarms due at the same instant come back in one mask
+void test_simultaneous_alarms() {
+  sched->add(alarmAt(8, 0, 1, 0, 0x1));
+  sched->add(alarmAt(9, 0, 1, 0, 0x1));
+  sched->add(alarmAt(8, 0, 7, ALARM_SUNDAY, 0x7F));
+  run(utc(2026, 8, 1, 0, 0), utc(2026, 8, 1, 12, 0));
+  TEST_ASSERT_EQUAL(2, numFired);
+  TEST_ASSERT_EQUAL_HEX16(0x5, fired[0].mask);
+  TEST_ASSERT_EQUAL_HEX16(0x2, fired[1].mask);
+}
+
+// A clock jump past a trigger: within the grace it still fires, beyond it
+// the trigger is skipped - either way the index moves to the next one
+void test_grace_after_clock_jump() {
+  sched->add(alarmAt(7, 0, 1, 0, 0x1));
+  time_t trigger = utc(2026, 8, 3, 6, 0);  // 07:00 BST
+  sched->recompute(trigger - 3600);
+  TEST_ASSERT_EQUAL(trigger, sched->nextTrigger());
+  TEST_ASSERT_EQUAL_HEX16(0x1, sched->poll(trigger + ALARM_GRACE_SEC));
+  TEST_ASSERT_EQUAL(trigger + DAY, sched->nextTrigger());
+
+  sched->recompute(trigger - 3600);
+  TEST_ASSERT_EQUAL_HEX16(0, sched->poll(trigger + ALARM_GRACE_SEC + 1));
+  TEST_ASSERT_EQUAL(trigger + DAY, sched->nextTrigger());
+
+  // Stale one-off is skipped and still retires
+  sched->clear();
+  sched->add(alarmAt(7, 0, 0, AlarmSchedule::dayNumber(2026, 8, 3), 0));
+  sched->recompute(trigger - 60);
+  TEST_ASSERT_EQUAL_HEX16(0, sched->poll(trigger + 3600));
+  TEST_ASSERT_EQUAL(ALARM_NONE, sched->nextTrigger());
+}
+
+void test_disabled_and_invalid() {
+  Alarm a = alarmAt(7, 0, 1, 0, 0x1);
+  a.flags = 0;
+  sched->add(a);
+  TEST_ASSERT_EQUAL(-1, sched->add(alarmAt(24, 0, 1, 0, 0x1)));
+  TEST_ASSERT_EQUAL(-1, sched->add(alarmAt(7, 0, 4, 0, 0x10)));  // Mask outside the cycle
+  run(utc(2026, 8, 1, 0, 0), utc(2026, 8, 3, 0, 0));
+  TEST_ASSERT_EQUAL(0, numFired);
+  TEST_ASSERT_EQUAL(ALARM_NONE, sched->nextTrigger());
+}
+
+// poll() is one comparison between triggers: no recompute per tick
+void test_recompute_only_on_trigger() {
+  sched->add(alarmAt(7, 0, 1, 0, 0x1));
+  run(utc(2026, 8, 1, 0, 0), utc(2026, 8, 8, 0, 0));
+  TEST_ASSERT_EQUAL(7, numFired);
+  TEST_ASSERT_EQUAL_UINT32(1 + 7, sched->recomputeCount());
+}
+
+int main() {
+  UNITY_BEGIN();
+  RUN_TEST(test_day_numbers);
+  RUN_TEST(test_daily_across_spring_forward);
+  RUN_TEST(test_weekly_days);
+  RUN_TEST(test_shift_rota);
+  RUN_TEST(test_spring_forward_gap);
+  RUN_TEST(test_fall_back_fires_once);
+  RUN_TEST(test_one_off);
+  RUN_TEST(test_simultaneous_alarms);
+  RUN_TEST(test_grace_after_clock_jump);
+  RUN_TEST(test_disabled_and_invalid);
+  RUN_TEST(test_recompute_only_on_trigger);
+  return UNITY_END();
+}
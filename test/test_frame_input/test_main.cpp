@@ -0,0 +1,193 @@
+/*
+ * Realtime frame input (include/frame_input.h): FULL/DELTA/RELEASE packets
+ * built here byte by byte - sequence wrap, stale drops, lost-packet
+ * counting, malformed lengths and the hold timeout
+ */
+
+#include <unity.h>
+
+// Matrix geometry as in src/main_tft.cpp: 64-byte frames
+#define LINE_WIDTH    32
+#define DISPLAY_ROWS  2
+#define LED_SIZE      10
+#include "frame_input.h"
+
+static FrameInput* input;
+static uint8_t pkt[FRAME_PKT_MAX];
+static uint32_t nowMs;
+
+static size_t header(uint8_t type, uint16_t seq, uint16_t timeout = 0) {
+  pkt[0] = 'R';
+  pkt[1] = 'F';
+  pkt[2] = type;
+  pkt[3] = 0;
+  pkt[4] = seq & 0xFF;
+  pkt[5] = seq >> 8;
+  pkt[6] = timeout & 0xFF;
+  pkt[7] = timeout >> 8;
+  return FRAME_PKT_HEADER;
+}
+
+// Every byte of the frame set to `fill`
+static bool sendFull(uint16_t seq, uint8_t fill, uint16_t timeout = 0) {
+  size_t len = header(FRAME_PKT_FULL, seq, timeout);
+  memset(pkt + len, fill, FRAME_BYTES);
+  return input->handlePacket(pkt, len + FRAME_BYTES, nowMs);
+}
+
+static bool sendDelta(uint16_t seq, uint8_t offset, uint8_t value) {
+  size_t len = header(FRAME_PKT_DELTA, seq);
+  pkt[len++] = offset;
+  pkt[len++] = value;
+  return input->handlePacket(pkt, len, nowMs);
+}
+
+static bool sendRelease(uint16_t seq) {
+  return input->handlePacket(pkt, header(FRAME_PKT_RELEASE, seq), nowMs);
+}
+
+void setUp() {
+  input = new FrameInput();
+  nowMs = 10000;
+}
+
+void tearDown() {
+  delete input;
+}
+
+void test_full_then_delta() {
+  uint8_t frame[FRAME_BYTES];
+  TEST_ASSERT_FALSE(input->isActive());
+  TEST_ASSERT_TRUE(sendFull(100, 0x55));
+  TEST_ASSERT_TRUE(input->isActive());
+  TEST_ASSERT_TRUE(input->takeFrame(frame));
+  TEST_ASSERT_EQUAL_HEX8(0x55, frame[FRAME_BYTES - 1]);
+  TEST_ASSERT_FALSE(input->takeFrame(frame));  // Nothing new
+
+  TEST_ASSERT_TRUE(sendDelta(101, 3, 0xF0));
+  TEST_ASSERT_TRUE(sendDelta(102, FRAME_BYTES, 0xFF));  // Offset off the end: ignored
+  TEST_ASSERT_TRUE(input->takeFrame(frame));
+  TEST_ASSERT_EQUAL_HEX8(0xF0, frame[3]);
+  TEST_ASSERT_EQUAL_HEX8(0x55, frame[4]);
+  TEST_ASSERT_EQUAL_UINT32(3, input->stats.frames);
+  TEST_ASSERT_EQUAL_UINT32(1, input->stats.sessions);
+}
+
+// 65534, 65535, 0, 1: nothing lost or stale across the wrap
+void test_sequence_wraps() {
+  const uint16_t seqs[] = {65534, 65535, 0, 1};
+  for (uint16_t seq : seqs) TEST_ASSERT_TRUE(sendDelta(seq, 0, (uint8_t)seq));
+  TEST_ASSERT_EQUAL_UINT32(4, input->stats.frames);
+  TEST_ASSERT_EQUAL_UINT32(0, input->stats.lost);
+  TEST_ASSERT_EQUAL_UINT32(0, input->stats.stale);
+
+  // A gap across the wrap is counted too: 1 -> 65533 is behind, 1 -> 4 skips two
+  TEST_ASSERT_FALSE(sendDelta(65533, 0, 0));
+  TEST_ASSERT_TRUE(sendDelta(4, 0, 0));
+  TEST_ASSERT_EQUAL_UINT32(2, input->stats.lost);
+  TEST_ASSERT_EQUAL_UINT32(1, input->stats.stale);
+}
+
+// Duplicates and anything older than the last accepted packet are dropped
+// without touching the frame
+void test_stale_packets_dropped() {
+  uint8_t frame[FRAME_BYTES];
+  sendFull(500, 0x11);
+  input->takeFrame(frame);
+  TEST_ASSERT_FALSE(sendFull(500, 0x22));  // Duplicate
+  TEST_ASSERT_FALSE(sendFull(499, 0x33));  // Reordered
+  TEST_ASSERT_FALSE(sendRelease(400));     // Late release doesn't end the session
+  TEST_ASSERT_TRUE(input->isActive());
+  TEST_ASSERT_FALSE(input->takeFrame(frame));
+  TEST_ASSERT_EQUAL_UINT32(3, input->stats.stale);
+  TEST_ASSERT_EQUAL_UINT32(1, input->stats.frames);
+}
+
+void test_lost_packets_counted() {
+  sendDelta(10, 0, 1);
+  sendDelta(11, 0, 1);
+  sendDelta(15, 0, 1);  // 12-14 missing
+  TEST_ASSERT_EQUAL_UINT32(3, input->stats.lost);
+  sendDelta(16, 0, 1);
+  TEST_ASSERT_EQUAL_UINT32(3, input->stats.lost);
+
+  // The first packet of a session has nothing to compare with
+  nowMs += FRAME_INPUT_TIMEOUT;
+  input->expire(nowMs);
+  sendDelta(9000, 0, 1);
+  TEST_ASSERT_EQUAL_UINT32(3, input->stats.lost);
+}
+
+void test_malformed_packets() {
+  size_t len = header(FRAME_PKT_FULL, 1);
+  memset(pkt + len, 0xAA, FRAME_BYTES);
+  TEST_ASSERT_FALSE(input->handlePacket(pkt, len + FRAME_BYTES - 1, nowMs));  // FULL one byte short
+  TEST_ASSERT_FALSE(input->handlePacket(pkt, len + FRAME_BYTES + 1, nowMs));  // ... one byte over
+  len = header(FRAME_PKT_DELTA, 2);
+  pkt[len++] = 0;
+  TEST_ASSERT_FALSE(input->handlePacket(pkt, len, nowMs));                    // DELTA, odd payload
+  TEST_ASSERT_FALSE(input->handlePacket(pkt, FRAME_PKT_HEADER - 1, nowMs));   // Short header
+  header(0x04, 3);
+  TEST_ASSERT_FALSE(input->handlePacket(pkt, FRAME_PKT_HEADER, nowMs));       // Unknown type
+  header(FRAME_PKT_FULL, 4);
+  pkt[1] = 'X';
+  TEST_ASSERT_FALSE(input->handlePacket(pkt, FRAME_PKT_HEADER + FRAME_BYTES, nowMs));  // Bad magic
+  TEST_ASSERT_EQUAL_UINT32(6, input->stats.malformed);
+  TEST_ASSERT_EQUAL_UINT32(6, input->stats.packets);
+  TEST_ASSERT_FALSE(input->isActive());
+
+  // An empty DELTA is well formed: a keepalive
+  TEST_ASSERT_TRUE(input->handlePacket(pkt, header(FRAME_PKT_DELTA, 5), nowMs));
+}
+
+void test_timeout_hands_back_to_clock() {
+  sendFull(1, 0x01);  // Default hold
+  nowMs += FRAME_INPUT_TIMEOUT - 1;
+  TEST_ASSERT_FALSE(input->expire(nowMs));
+  TEST_ASSERT_TRUE(input->isActive());
+  nowMs += 1;
+  TEST_ASSERT_TRUE(input->expire(nowMs));
+  TEST_ASSERT_FALSE(input->isActive());
+  TEST_ASSERT_FALSE(input->expire(nowMs));  // Only once
+
+  // A new session accepts any sequence number, even an "older" one
+  TEST_ASSERT_TRUE(sendFull(0, 0x02, 500));  // Hold 500ms from now on
+  TEST_ASSERT_EQUAL_UINT32(2, input->stats.sessions);
+  TEST_ASSERT_EQUAL_UINT32(0, input->stats.stale);
+  nowMs += 499;
+  TEST_ASSERT_FALSE(input->expire(nowMs));
+  nowMs += 1;
+  TEST_ASSERT_TRUE(input->expire(nowMs));
+}
+
+// Each accepted packet restarts the hold
+void test_packets_extend_the_hold() {
+  for (int i = 0; i < 10; i++) {
+    sendDelta(i, 0, i);
+    nowMs += FRAME_INPUT_TIMEOUT / 2;
+    TEST_ASSERT_FALSE(input->expire(nowMs));
+  }
+  TEST_ASSERT_EQUAL_UINT32(1, input->stats.sessions);
+}
+
+void test_release_ends_session_at_once() {
+  sendFull(7, 0x0F);
+  TEST_ASSERT_FALSE(sendRelease(8));
+  TEST_ASSERT_FALSE(input->isActive());
+  TEST_ASSERT_EQUAL_UINT32(0, input->stats.lost);
+  TEST_ASSERT_TRUE(sendDelta(3, 0, 0));  // Next sender starts a new session
+  TEST_ASSERT_EQUAL_UINT32(2, input->stats.sessions);
+}
+
+int main() {
+  UNITY_BEGIN();
+  RUN_TEST(test_full_then_delta);
+  RUN_TEST(test_sequence_wraps);
+  RUN_TEST(test_stale_packets_dropped);
+  RUN_TEST(test_lost_packets_counted);
+  RUN_TEST(test_malformed_packets);
+  RUN_TEST(test_timeout_hands_back_to_clock);
+  RUN_TEST(test_packets_extend_the_hold);
+  RUN_TEST(test_release_ends_session_at_once);
+  return UNITY_END();
+}
@@ -0,0 +1,136 @@
+/*
+ * Headless framebuffer sink: the [env:native] build defines
+ * HEADLESS_FRAMEBUFFER, so refreshAll() mirrors every frame into
+ * framebufferSink (include/framebuffer_sink.h) exactly as the TFT sees it
+ */
+
+#include <unity.h>
+#include "../../src/main_tft.cpp"
+
+// Centre pixel of LED (x, y) - lit in both display styles
+static uint16_t ledCentre(int x, int y) {
+  return framebufferSink.pixel(ledCellX(x) + LED_SIZE / 2, ledCellY(y) + LED_SIZE / 2);
+}
+
+static void redraw() {
+  forceFullRedraw = true;
+  refreshAll();
+}
+
+void setUp() {
+  displayStyle = 0;
+  clearScreen();
+  redraw();
+}
+
+void tearDown() {}
+
+void test_sink_registered() {
+  bool found = false;
+  for (int i = 0; i < numDisplaySinks; i++) {
+    if (displaySinks[i] == &framebufferSink) found = true;
+  }
+  TEST_ASSERT_TRUE(found);
+  TEST_ASSERT_NOT_NULL(framebufferSink.data());
+  TEST_ASSERT_EQUAL(LED_SIZE * LINE_WIDTH, framebufferSink.width());
+  TEST_ASSERT_EQUAL(LED_SIZE * DISPLAY_ROWS * 8 + LED_ROW_GAP, framebufferSink.height());
+}
+
+void test_lit_and_dark_cells() {
+  scr[0] = 0x01;                // LED (0, 0)
+  scr[LINE_WIDTH + 5] = 0x80;   // LED (5, 15), bottom row of matrices
+  refreshAll();
+  TEST_ASSERT_EQUAL_HEX16(ledOnColor, ledCentre(0, 0));
+  TEST_ASSERT_EQUAL_HEX16(ledOnColor, ledCentre(5, 15));
+  TEST_ASSERT_EQUAL_HEX16(BG_COLOR, ledCentre(0, 1));
+  TEST_ASSERT_EQUAL_HEX16(BG_COLOR, ledCentre(31, 15));
+  // The row gap between the two matrix rows stays background
+  TEST_ASSERT_EQUAL_HEX16(BG_COLOR, framebufferSink.pixel(0, LED_SIZE * 8 + 1));
+}
+
+void test_only_dirty_columns_drawn() {
+  uint32_t cells = framebufferSink.cellCount();
+  scr[3] = 0xFF;
+  refreshAll();
+  TEST_ASSERT_EQUAL_UINT32(cells + 8, framebufferSink.cellCount());
+
+  uint32_t presents = framebufferSink.presentCount();
+  refreshAll();  // Nothing changed
+  TEST_ASSERT_EQUAL_UINT32(presents, framebufferSink.presentCount());
+}
+
+void test_incremental_matches_full_redraw() {
+  for (int i = 0; i < LINE_WIDTH * DISPLAY_ROWS; i++) scr[i] = (uint8_t)(i * 37);
+  refreshAll();
+  for (int i = 0; i < LINE_WIDTH * DISPLAY_ROWS; i += 3) scr[i] ^= 0x5A;
+  refreshAll();
+  uint32_t incremental = framebufferSink.hash();
+
+  framebufferSink.begin();  // Wipe, then draw everything from scratch
+  redraw();
+  TEST_ASSERT_EQUAL_HEX32(incremental, framebufferSink.hash());
+}
+
+void test_styles_differ() {
+  for (int i = 0; i < LINE_WIDTH * DISPLAY_ROWS; i++) scr[i] = 0xA5;
+  redraw();
+  uint32_t blocks = framebufferSink.hash();
+  displayStyle = 1;
+  redraw();
+  uint32_t realistic = framebufferSink.hash();
+  TEST_ASSERT_NOT_EQUAL(blocks, realistic);
+  TEST_ASSERT_EQUAL_HEX16(ledOnColor, ledCentre(0, 0));
+}
+
+// A panned TFT is given only the columns the pan didn't already move into
+// place; ledsPushed counts that mask, not the frame diff the other sinks get
+void test_leds_pushed_counts_tft_mask() {
+  tft.setRotation(3);
+  TEST_ASSERT_TRUE(tftSink.enableScroll(true));
+  for (int i = 0; i < LINE_WIDTH * DISPLAY_ROWS; i++) scr[i] = (uint8_t)(i * 37 + 11);
+  redraw();
+
+  scrollLeft();  // Content one column left, new blank column on the right
+  uint64_t before = ledsPushed;
+  uint32_t cells = framebufferSink.cellCount();
+  displayPan = 1;
+  refreshAll();
+  displayPan = 0;
+  uint64_t tftLeds = ledsPushed - before;
+  uint32_t framebufferLeds = framebufferSink.cellCount() - cells;
+  TEST_ASSERT_GREATER_THAN(0, tftLeds);
+  TEST_ASSERT_LESS_THAN(framebufferLeds, (uint32_t)tftLeds);
+  tftSink.enableScroll(false);
+}
+
+void test_ppm_output() {
+  scr[0] = 0x01;
+  refreshAll();
+  const char* path = "test_framebuffer.ppm";
+  TEST_ASSERT_TRUE(framebufferSink.writePPM(path));
+
+  FILE* f = fopen(path, "rb");
+  TEST_ASSERT_NOT_NULL(f);
+  char header[32];
+  int len = snprintf(header, sizeof(header), "P6\n%d %d\n255\n", FB_WIDTH, FB_HEIGHT);
+  char read[32] = {0};
+  TEST_ASSERT_EQUAL(len, (int)fread(read, 1, len, f));
+  TEST_ASSERT_EQUAL_STRING(header, read);
+  fseek(f, 0, SEEK_END);
+  TEST_ASSERT_EQUAL(len + FB_WIDTH * FB_HEIGHT * 3, (int)ftell(f));
+  fclose(f);
+  remove(path);
+}
+
+int main() {
+  initDisplaySinks();
+  UNITY_BEGIN();
+  RUN_TEST(test_sink_registered);
+  RUN_TEST(test_lit_and_dark_cells);
+  RUN_TEST(test_only_dirty_columns_drawn);
+  RUN_TEST(test_incremental_matches_full_redraw);
+  RUN_TEST(test_styles_differ);
+  RUN_TEST(test_leds_pushed_counts_tft_mask);
+  RUN_TEST(test_ppm_output);
+  return UNITY_END();
+}
@@ -0,0 +1,107 @@
+/*
+ * Golden display frames (include/golden_frames.h) on the host: every case
+ * is composed, compared at scr level, then fully redrawn in both styles
+ * through the framebuffer sink and compared by image hash. Render cost is
+ * the SPI traffic the TFT sink would send for that redraw, which is
+ * deterministic where micros() on the host is not.
+ *
+ * A mode in displayModes[] without a golden case fails the suite.
+ * Mismatches print what was rendered so intended changes can be copied
+ * back into golden_frames.h.
+ */
+
+#include <unity.h>
+#include "../../src/main_tft.cpp"
+
+// Full-redraw SPI bytes per style: Default is a fixed 108KB (one window
+// per cell), Realistic ~545-580KB depending on how many LEDs are lit
+static const uint64_t budgetBytes[2] = {120000, 640000};
+
+static void printFrame() {
+  for (int row = 0; row < DISPLAY_ROWS; row++) {
+    printf("    ");
+    for (int x = 0; x < LINE_WIDTH; x++) printf("0x%02X, ", scr[x + row * LINE_WIDTH]);
+    printf("\n");
+  }
+}
+
+// Full redraw into a wiped framebuffer; returns the TFT sink's SPI bytes
+static uint64_t fullRedraw(int style) {
+  displayStyle = style;
+  framebufferSink.begin();
+  uint64_t before = tftSink.spiBytes();
+  forceFullRedraw = true;
+  refreshAll();
+  return tftSink.spiBytes() - before;
+}
+
+void setUp() {
+  ledOnColor = COLOR_RED;  // Image hashes are recorded at the default colors
+  ledSurroundColor = COLOR_DARK_GRAY;
+}
+
+void tearDown() {}
+
+void test_every_mode_has_a_golden() {
+  int missing = 0;
+  for (int mode = 0; mode < numDisplayModes; mode++) {
+    bool found = false;
+    for (int i = 0; i < numGoldenCases; i++) {
+      if (strcmp(goldenCases[i].mode, displayModes[mode].name) == 0) found = true;
+    }
+    if (!found) {
+      printf("no golden case for mode \"%s\"\n", displayModes[mode].name);
+      missing++;
+    }
+  }
+  TEST_ASSERT_EQUAL_MESSAGE(0, missing, "modes without golden cases");
+}
+
+void test_golden_frames_and_images() {
+  int failures = 0, run = 0;
+  for (int i = 0; i < numGoldenCases; i++) {
+    const GoldenCase& c = goldenCases[i];
+    if (composeGoldenCase(c) < 0) continue;  // Mode compiled out
+    run++;
+
+    uint8_t frame[sizeof(scr)];
+    memcpy(frame, scr, sizeof(scr));
+    uint32_t image[2];
+    uint64_t bytes[2];
+    for (int style = 0; style <= 1; style++) {
+      bytes[style] = fullRedraw(style);
+      image[style] = framebufferSink.hash();
+    }
+
+    bool frameOk = memcmp(frame, c.frame, sizeof(frame)) == 0;
+    bool imageOk = image[0] == c.image[0] && image[1] == c.image[1];
+    bool budgetOk = bytes[0] <= budgetBytes[0] && bytes[1] <= budgetBytes[1];
+    if (frameOk && imageOk && budgetOk) continue;
+
+    failures++;
+    printf("case %d (%s %02d:%02d:%02d):%s%s%s\n", i, c.mode, c.hour24, c.minute, c.second,
+           frameOk ? "" : " frame", imageOk ? "" : " image", budgetOk ? "" : " spi-budget");
+    if (!frameOk) printFrame();
+    printf("    {0x%08X, 0x%08X}  spi bytes %llu / %llu\n", image[0], image[1],
+           (unsigned long long)bytes[0], (unsigned long long)bytes[1]);
+  }
+  TEST_ASSERT_GREATER_THAN(0, run);
+  TEST_ASSERT_EQUAL_MESSAGE(0, failures, "golden cases that don't match");
+}
+
+// Same check the device runs from /api/selftest (frames + coverage)
+void test_device_self_test() {
+  String json;
+  int failures = runDisplaySelfTest(json);
+  if (failures) printf("%s\n", json.c_str());
+  TEST_ASSERT_EQUAL(0, failures);
+}
+
+int main() {
+  setup();  // Sinks, mode state (analog dial, rules) exactly as on the device
+  UNITY_BEGIN();
+  RUN_TEST(test_every_mode_has_a_golden);
+  RUN_TEST(test_golden_frames_and_images);
+  RUN_TEST(test_device_self_test);
+  return UNITY_END();
+}
@@ -0,0 +1,229 @@
+/*
+ * Streaming OTA (include/ota_stream.h) against a mock flash writer:
+ * chunking around OTA_CHUNK_SIZE, MD5 verdicts, size limits, and that
+ * every failure releases the partition without committing
+ */
+
+#include <unity.h>
+#include "ota_stream.h"
+
+#define GOOD_MD5  "0123456789abcdef0123456789abcdef"
+#define BAD_MD5   "fedcba9876543210fedcba9876543210"
+#define MAX_IMAGE 8192
+
+// Stands in for the core's UpdaterClass; end(true) "verifies" by comparing
+// the MD5 it was given with the one the image really has (GOOD_MD5)
+struct MockWriter {
+  bool failBegin = false;
+  size_t failWriteAt = 0;  // Short write at this chunk number (1-based), 0 = never
+  bool open = false;
+  bool committed = false;
+  int ends = 0;
+  size_t maxSize = 0;
+  char md5[33] = {0};
+  uint8_t image[MAX_IMAGE];
+  size_t length = 0;
+  int writes = 0;
+  size_t writeSize[16];
+
+  bool begin(size_t size) {
+    if (failBegin) return false;
+    open = true;
+    maxSize = size;
+    length = 0;
+    return true;
+  }
+  bool setMD5(const char* hex) {
+    strncpy(md5, hex, 32);
+    return true;
+  }
+  size_t write(uint8_t* data, size_t len) {
+    if (writes < 16) writeSize[writes] = len;
+    writes++;
+    if (failWriteAt && (size_t)writes == failWriteAt) return len / 2;
+    memcpy(image + length, data, len);
+    length += len;
+    return len;
+  }
+  bool end(bool evenIfRemaining) {
+    ends++;
+    open = false;
+    committed = evenIfRemaining && strcmp(md5, GOOD_MD5) == 0;
+    return committed;
+  }
+  uint8_t getError() { return 7; }
+};
+
+static MockWriter* writer;
+static OtaStream<MockWriter>* ota;
+static uint8_t payload[MAX_IMAGE];
+
+// Feed `size` bytes in `piece`-sized upload pieces, then finish
+static bool upload(size_t size, size_t piece, size_t declared, const char* md5) {
+  if (!ota->begin(declared, MAX_IMAGE, md5, 0)) return false;
+  for (size_t pos = 0; pos < size; pos += piece) {
+    size_t n = size - pos < piece ? size - pos : piece;
+    if (!ota->feed(payload + pos, n, pos)) return false;
+  }
+  return ota->finish(size);
+}
+
+void setUp() {
+  for (int i = 0; i < MAX_IMAGE; i++) payload[i] = (uint8_t)(i * 7 + i / 256);
+  writer = new MockWriter();
+  ota = new OtaStream<MockWriter>(*writer);
+}
+
+void tearDown() {
+  delete ota;
+  delete writer;
+}
+
+static void assertImage(size_t size) {
+  TEST_ASSERT_EQUAL(OTA_DONE, ota->status());
+  TEST_ASSERT_TRUE(writer->committed);
+  TEST_ASSERT_FALSE(writer->open);
+  TEST_ASSERT_EQUAL_UINT32(size, writer->length);
+  TEST_ASSERT_EQUAL_UINT8_ARRAY(payload, writer->image, size);
+  TEST_ASSERT_EQUAL_UINT32(size, ota->writtenBytes());
+}
+
+void test_image_one_short_of_a_chunk() {
+  TEST_ASSERT_TRUE(upload(1023, 100, 1023, GOOD_MD5));
+  assertImage(1023);
+  TEST_ASSERT_EQUAL(1, writer->writes);
+  TEST_ASSERT_EQUAL_UINT32(1023, writer->writeSize[0]);
+}
+
+void test_image_exactly_one_chunk() {
+  TEST_ASSERT_TRUE(upload(1024, 1024, 1024, GOOD_MD5));
+  assertImage(1024);
+  TEST_ASSERT_EQUAL(1, writer->writes);  // No empty trailing write
+  TEST_ASSERT_EQUAL_UINT32(1024, writer->writeSize[0]);
+}
+
+void test_image_one_over_a_chunk() {
+  TEST_ASSERT_TRUE(upload(1025, 1, 1025, GOOD_MD5));
+  assertImage(1025);
+  TEST_ASSERT_EQUAL(2, writer->writes);
+  TEST_ASSERT_EQUAL_UINT32(1024, writer->writeSize[0]);
+  TEST_ASSERT_EQUAL_UINT32(1, writer->writeSize[1]);
+}
+
+// Upload pieces straddling chunk edges still reach flash as whole chunks
+void test_pieces_across_chunk_boundaries() {
+  const size_t pieces[] = {1023, 1024, 1025};
+  for (size_t piece : pieces) {
+    tearDown();
+    setUp();
+    TEST_ASSERT_TRUE(upload(4100, piece, 0, GOOD_MD5));  // Size not declared
+    assertImage(4100);
+    TEST_ASSERT_EQUAL(5, writer->writes);
+    for (int i = 0; i < 4; i++) TEST_ASSERT_EQUAL_UINT32(OTA_CHUNK_SIZE, writer->writeSize[i]);
+    TEST_ASSERT_EQUAL_UINT32(4, writer->writeSize[4]);
+    TEST_ASSERT_EQUAL(-1, ota->percent());
+  }
+}
+
+void test_md5_mismatch_not_committed() {
+  TEST_ASSERT_FALSE(upload(3000, 512, 3000, BAD_MD5));
+  TEST_ASSERT_EQUAL(OTA_FAILED, ota->status());
+  TEST_ASSERT_FALSE(writer->committed);
+  TEST_ASSERT_FALSE(writer->open);
+}
+
+void test_malformed_md5_rejected_before_the_writer() {
+  TEST_ASSERT_FALSE(ota->begin(1000, MAX_IMAGE, "1234", 0));
+  TEST_ASSERT_EQUAL(OTA_FAILED, ota->status());
+  TEST_ASSERT_EQUAL(0, writer->ends);
+  TEST_ASSERT_FALSE(writer->open);
+}
+
+void test_oversize_input_fails() {
+  // More than declared
+  TEST_ASSERT_FALSE(upload(2049, 1024, 2048, GOOD_MD5));
+  TEST_ASSERT_EQUAL(OTA_FAILED, ota->status());
+  TEST_ASSERT_EQUAL_STRING("image larger than declared size", ota->error());
+  TEST_ASSERT_FALSE(writer->open);
+  TEST_ASSERT_FALSE(writer->committed);
+
+  // Declared larger than the partition
+  TEST_ASSERT_FALSE(ota->begin(MAX_IMAGE + 1, MAX_IMAGE, GOOD_MD5, 0));
+  TEST_ASSERT_EQUAL_STRING("image larger than the update partition", ota->error());
+}
+
+void test_short_input_fails() {
+  TEST_ASSERT_FALSE(upload(2000, 500, 2048, GOOD_MD5));
+  TEST_ASSERT_EQUAL(OTA_FAILED, ota->status());
+  TEST_ASSERT_EQUAL_STRING("upload shorter than declared size", ota->error());
+  TEST_ASSERT_FALSE(writer->committed);
+  TEST_ASSERT_FALSE(writer->open);
+  TEST_ASSERT_EQUAL(1, writer->ends);
+}
+
+void test_short_flash_write_fails() {
+  writer->failWriteAt = 2;
+  TEST_ASSERT_FALSE(upload(4096, 1024, 4096, GOOD_MD5));
+  TEST_ASSERT_EQUAL_STRING("flash write failed", ota->error());
+  TEST_ASSERT_EQUAL(7, ota->writerError());
+  TEST_ASSERT_FALSE(writer->open);
+  TEST_ASSERT_FALSE(writer->committed);
+}
+
+void test_abort_releases_partition() {
+  TEST_ASSERT_TRUE(ota->begin(4096, MAX_IMAGE, GOOD_MD5, 0));
+  TEST_ASSERT_TRUE(ota->feed(payload, 1500, 10));
+  TEST_ASSERT_TRUE(writer->open);
+  ota->abort(20);
+  TEST_ASSERT_EQUAL(OTA_FAILED, ota->status());
+  TEST_ASSERT_FALSE(writer->open);
+  TEST_ASSERT_FALSE(writer->committed);
+  TEST_ASSERT_EQUAL(1, writer->ends);
+  TEST_ASSERT_FALSE(ota->feed(payload, 10, 30));  // Later pieces are ignored
+  TEST_ASSERT_FALSE(ota->finish(40));
+  TEST_ASSERT_EQUAL(1, writer->ends);
+}
+
+void test_reject_never_touches_writer() {
+  ota->reject("unauthorized", 5);
+  TEST_ASSERT_EQUAL(OTA_FAILED, ota->status());
+  TEST_ASSERT_EQUAL_STRING("unauthorized", ota->error());
+  TEST_ASSERT_FALSE(ota->feed(payload, 100, 6));
+  TEST_ASSERT_FALSE(ota->finish(7));
+  TEST_ASSERT_EQUAL(0, writer->writes);
+  TEST_ASSERT_EQUAL(0, writer->ends);
+}
+
+void test_begin_failure() {
+  writer->failBegin = true;
+  TEST_ASSERT_FALSE(ota->begin(1000, MAX_IMAGE, GOOD_MD5, 0));
+  TEST_ASSERT_EQUAL_STRING("update partition unavailable", ota->error());
+  TEST_ASSERT_EQUAL(0, writer->ends);  // Nothing to release
+}
+
+void test_progress() {
+  TEST_ASSERT_TRUE(ota->begin(4000, MAX_IMAGE, GOOD_MD5, 1000));
+  TEST_ASSERT_TRUE(ota->feed(payload, 1000, 1500));
+  TEST_ASSERT_EQUAL(25, ota->percent());
+  TEST_ASSERT_EQUAL_UINT32(500, ota->elapsedMs());
+  TEST_ASSERT_EQUAL_UINT32(2000, ota->bytesPerSecond());
+  TEST_ASSERT_EQUAL_UINT32(0, ota->chunkCount());  // Still staged
+}
+
+int main() {
+  UNITY_BEGIN();
+  RUN_TEST(test_image_one_short_of_a_chunk);
+  RUN_TEST(test_image_exactly_one_chunk);
+  RUN_TEST(test_image_one_over_a_chunk);
+  RUN_TEST(test_pieces_across_chunk_boundaries);
+  RUN_TEST(test_md5_mismatch_not_committed);
+  RUN_TEST(test_malformed_md5_rejected_before_the_writer);
+  RUN_TEST(test_oversize_input_fails);
+  RUN_TEST(test_short_input_fails);
+  RUN_TEST(test_short_flash_write_fails);
+  RUN_TEST(test_abort_releases_partition);
+  RUN_TEST(test_reject_never_touches_writer);
+  RUN_TEST(test_begin_failure);
+  RUN_TEST(test_progress);
+  return UNITY_END();
+}
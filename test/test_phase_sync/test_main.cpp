@@ -0,0 +1,225 @@
+/*
+ * Fleet phase sync (include/phase_sync.h): a simulated leader whose clock
+ * runs a fixed offset ahead of ours, beacons once a second through a
+ * network with jittered one-way delay
+ */
+
+#include <unity.h>
+#include "phase_sync.h"
+
+#define TRUE_OFFSET_US  1234567LL   // Leader clock minus follower clock
+#define LEADER_ID       0x0A000001
+#define MIN_DELAY_US    2000
+
+static PhaseSync* leader;
+static PhaseSync* follower;
+static int64_t leaderOffsetUs;      // Can be changed mid-test (leader stepped)
+static int64_t localUs;             // Follower wall clock at the current beacon
+static uint32_t nowMs;
+static uint32_t rng;
+
+// Delay between MIN_DELAY_US and ~40ms; every 4th beacon gets the minimum
+static uint32_t jitteredDelay(int i) {
+  rng = rng * 1664525UL + 1013904223UL;
+  return (i % 4 == 0) ? MIN_DELAY_US : MIN_DELAY_US + (rng >> 8) % 38000;
+}
+
+// Leader sends at its second edge; follower receives `delayUs` later
+static bool beacon(uint32_t delayUs, uint32_t sourceId = LEADER_ID, PhaseSync* from = nullptr) {
+  int64_t leaderUs = localUs + leaderOffsetUs;
+  uint8_t pkt[PHASE_PKT_SIZE];
+  (from ? from : leader)->buildBeacon(pkt, (uint32_t)(leaderUs / 1000000), (uint32_t)(leaderUs % 1000000));
+  return follower->handleBeacon(pkt, sizeof(pkt), sourceId, localUs + delayUs, nowMs);
+}
+
+static void nextSecond() {
+  localUs += 1000000;
+  nowMs += 1000;
+}
+
+static void run(int n, int firstIndex = 0) {
+  for (int i = 0; i < n; i++) {
+    beacon(jitteredDelay(firstIndex + i));
+    nextSecond();
+  }
+}
+
+void setUp() {
+  leader = new PhaseSync();
+  follower = new PhaseSync();
+  leaderOffsetUs = TRUE_OFFSET_US;
+  localUs = 1760000000LL * 1000000LL;
+  nowMs = 50000;
+  rng = 12345;
+}
+
+void tearDown() {
+  delete leader;
+  delete follower;
+}
+
+void test_first_beacon_locks_by_step() {
+  TEST_ASSERT_FALSE(follower->isLocked());
+  TEST_ASSERT_EQUAL_INT64(0, follower->offsetUs());
+  TEST_ASSERT_TRUE(beacon(10000));
+  TEST_ASSERT_TRUE(follower->isLocked());
+  TEST_ASSERT_EQUAL_UINT32(LEADER_ID, follower->leader());
+  TEST_ASSERT_EQUAL_UINT32(1, follower->stepCount());
+  TEST_ASSERT_EQUAL_INT64(TRUE_OFFSET_US - 10000, follower->offsetUs());
+}
+
+// With jitter up to 40ms the offset settles within a few ms of the truth,
+// and never ahead of it (delay only ever makes samples smaller)
+void test_converges_under_jitter() {
+  run(60);
+  TEST_ASSERT_TRUE(follower->isLocked());
+  TEST_ASSERT_EQUAL_UINT32(1, follower->stepCount());  // Only the initial lock
+  int64_t error = TRUE_OFFSET_US - follower->offsetUs();
+  TEST_ASSERT_TRUE(error >= MIN_DELAY_US);
+  TEST_ASSERT_TRUE(error <= MIN_DELAY_US + 500);
+  TEST_ASSERT_GREATER_THAN(20000, follower->spreadUs());
+  TEST_ASSERT_EQUAL_UINT32(60, follower->beaconCount());
+  TEST_ASSERT_EQUAL_UINT32(0, follower->lostCount());
+}
+
+// The estimate is the largest sample in the window - the least delayed beacon
+void test_max_filter_picks_least_delay() {
+  beacon(20000);  // Lock at T - 20ms
+  nextSecond();
+  for (int i = 0; i < 3; i++) {
+    beacon(i == 1 ? 1000 : 25000);
+    nextSecond();
+  }
+  // Window holds 20, 25, 1, 25 ms: estimate T - 1ms, offset slews a quarter per beacon
+  TEST_ASSERT_EQUAL_INT32(19000 - 19000 / 4, follower->errorUs());
+  int64_t before = follower->offsetUs();
+  beacon(30000);
+  int64_t error = (TRUE_OFFSET_US - 1000) - before;
+  TEST_ASSERT_EQUAL_INT32((int32_t)error, follower->errorUs());
+  TEST_ASSERT_EQUAL_INT64(before + error / 4, follower->offsetUs());
+  TEST_ASSERT_EQUAL_UINT32(1, follower->stepCount());
+
+  // Once the 1ms sample leaves the window the estimate falls back to the next best
+  for (int i = 0; i < PHASE_WINDOW; i++) {
+    nextSecond();
+    beacon(25000 + i);
+  }
+  TEST_ASSERT_TRUE(follower->errorUs() < 0);
+}
+
+void test_small_error_slews_large_error_steps() {
+  run(20);
+  uint32_t steps = follower->stepCount();
+
+  // Leader 20ms later than before: slewed a quarter per beacon
+  leaderOffsetUs += 20000;
+  int64_t before = follower->offsetUs();
+  beacon(MIN_DELAY_US);
+  TEST_ASSERT_EQUAL_UINT32(steps, follower->stepCount());
+  TEST_ASSERT_INT64_WITHIN(10, before + (follower->errorUs() / 4), follower->offsetUs());
+  TEST_ASSERT_TRUE(follower->errorUs() > 15000);
+  nextSecond();
+
+  // 200ms: stepped at once
+  leaderOffsetUs += 200000;
+  beacon(MIN_DELAY_US);
+  TEST_ASSERT_EQUAL_UINT32(steps + 1, follower->stepCount());
+  TEST_ASSERT_EQUAL_INT64(leaderOffsetUs - MIN_DELAY_US, follower->offsetUs());
+}
+
+// Our own clock stepped back (NTP): old samples would hold the estimate up,
+// so clockStepped() drops them and the next beacon steps
+void test_local_clock_step_resyncs() {
+  run(20);
+  leaderOffsetUs -= 300000;  // Same as our clock jumping 300ms forward
+  follower->clockStepped();
+  uint32_t steps = follower->stepCount();
+  beacon(MIN_DELAY_US);
+  TEST_ASSERT_EQUAL_UINT32(steps + 1, follower->stepCount());
+  TEST_ASSERT_EQUAL_INT64(leaderOffsetUs - MIN_DELAY_US, follower->offsetUs());
+}
+
+void test_timeout_loses_lock() {
+  run(10);
+  TEST_ASSERT_TRUE(follower->isLocked());
+  nowMs += PHASE_TIMEOUT_MS - 1001;  // Last beacon was 1s ago
+  follower->expire(nowMs);
+  TEST_ASSERT_TRUE(follower->isLocked());
+  nowMs += 1;
+  follower->expire(nowMs);
+  TEST_ASSERT_FALSE(follower->isLocked());
+  TEST_ASSERT_EQUAL_INT64(0, follower->offsetUs());
+
+  // Relocks by step on the next beacon
+  uint32_t steps = follower->stepCount();
+  beacon(5000);
+  TEST_ASSERT_TRUE(follower->isLocked());
+  TEST_ASSERT_EQUAL_UINT32(steps + 1, follower->stepCount());
+}
+
+void test_sequence_lost_and_stale() {
+  beacon(5000);
+  nextSecond();
+  uint8_t pkt[PHASE_PKT_SIZE];
+  leader->buildBeacon(pkt, 0, 0);  // Sent but never delivered (seq 1)
+  leader->buildBeacon(pkt, 0, 0);  // seq 2
+  beacon(5000);                     // seq 3
+  TEST_ASSERT_EQUAL_UINT32(2, follower->lostCount());
+
+  // Replay of an old beacon is stale
+  PhaseSync old;
+  TEST_ASSERT_FALSE(beacon(5000, LEADER_ID, &old));  // seq 0
+  TEST_ASSERT_EQUAL_UINT32(1, follower->staleCount());
+}
+
+// Sequence wraps 65535 -> 0 without anything counted lost or stale
+void test_sequence_wrap() {
+  uint8_t pkt[PHASE_PKT_SIZE];
+  while (leader->sentCount() != 0xFFFE) leader->buildBeacon(pkt, 0, 0);
+  run(4);  // seq 65534, 65535, 0, 1
+  TEST_ASSERT_EQUAL_UINT32(4, follower->beaconCount());
+  TEST_ASSERT_EQUAL_UINT32(0, follower->lostCount());
+  TEST_ASSERT_EQUAL_UINT32(0, follower->staleCount());
+  TEST_ASSERT_TRUE(follower->isLocked());
+}
+
+void test_second_leader_ignored_while_locked() {
+  run(5);
+  PhaseSync other;
+  leaderOffsetUs += 400000;
+  TEST_ASSERT_FALSE(beacon(2000, 0x0A000002, &other));
+  TEST_ASSERT_EQUAL_UINT32(LEADER_ID, follower->leader());
+
+  // Once ours goes quiet, the other one is taken
+  nowMs += PHASE_TIMEOUT_MS;
+  TEST_ASSERT_TRUE(beacon(2000, 0x0A000002, &other));
+  TEST_ASSERT_EQUAL_UINT32(0x0A000002, follower->leader());
+}
+
+void test_malformed_packets() {
+  uint8_t pkt[PHASE_PKT_SIZE];
+  leader->buildBeacon(pkt, 1, 2);
+  TEST_ASSERT_FALSE(follower->handleBeacon(pkt, PHASE_PKT_SIZE - 1, LEADER_ID, 0, nowMs));
+  pkt[0] = 'X';
+  TEST_ASSERT_FALSE(follower->handleBeacon(pkt, PHASE_PKT_SIZE, LEADER_ID, 0, nowMs));
+  pkt[0] = 'P';
+  pkt[2] = PHASE_VERSION + 1;
+  TEST_ASSERT_FALSE(follower->handleBeacon(pkt, PHASE_PKT_SIZE, LEADER_ID, 0, nowMs));
+  TEST_ASSERT_EQUAL_UINT32(3, follower->malformedCount());
+  TEST_ASSERT_FALSE(follower->isLocked());
+}
+
+int main() {
+  UNITY_BEGIN();
+  RUN_TEST(test_first_beacon_locks_by_step);
+  RUN_TEST(test_converges_under_jitter);
+  RUN_TEST(test_max_filter_picks_least_delay);
+  RUN_TEST(test_small_error_slews_large_error_steps);
+  RUN_TEST(test_local_clock_step_resyncs);
+  RUN_TEST(test_timeout_loses_lock);
+  RUN_TEST(test_sequence_lost_and_stale);
+  RUN_TEST(test_sequence_wrap);
+  RUN_TEST(test_second_leader_ignored_while_locked);
+  RUN_TEST(test_malformed_packets);
+  return UNITY_END();
+}
@@ -0,0 +1,147 @@
+/*
+ * Warm-boot snapshot in RTC user memory (saveRtcState/restoreRtcState):
+ * which reset reasons restore it, that boot time is added to the clock,
+ * and that a damaged or missing snapshot is ignored. The host ESP keeps
+ * rtcMemory across "resets"; test/support/sys/time.h keeps settimeofday()
+ * off the build machine's clock.
+ */
+
+#include <unity.h>
+#include "../../src/main_tft.cpp"
+
+#define SNAPSHOT_UTC  1767225600UL  // 2026-01-01 00:00:00 UTC
+#define BOOT_US       1500000ULL    // millis() when the restored firmware gets to restoreRtcState()
+
+static void setWallClock(uint32_t sec, uint32_t usec) {
+  struct timeval tv;
+  tv.tv_sec = sec;
+  tv.tv_usec = usec;
+  settimeofday(&tv, nullptr);
+}
+
+// Running firmware with non-default settings takes a snapshot
+static void takeSnapshot() {
+  setWallClock(SNAPSHOT_UTC, 250000);
+  currentMode = 2;
+  currentTimezone = 3;
+  displayStyle = 1;
+  use24HourFormat = true;
+  useFahrenheit = true;
+  ledOnColor = COLOR_GREEN;
+  clockDriftPpm = -42;
+  lastNTPUtc = SNAPSHOT_UTC - 600;
+  saveRtcState();
+}
+
+// What a reset leaves behind: RAM back at its defaults, RTC memory intact
+static void reset(uint32_t reason) {
+  currentMode = 0;
+  currentTimezone = 0;
+  displayStyle = 0;
+  use24HourFormat = false;
+  useFahrenheit = false;
+  ledOnColor = COLOR_RED;
+  clockDriftPpm = 0;
+  lastNTPUtc = 0;
+  setWallClock(0, 0);
+  hostMicros = BOOT_US;
+  ESP.resetInfo.reason = reason;
+}
+
+static void assertDefaults() {
+  TEST_ASSERT_EQUAL(0, currentTimezone);
+  TEST_ASSERT_EQUAL(0, displayStyle);
+  TEST_ASSERT_FALSE(use24HourFormat);
+  TEST_ASSERT_EQUAL_HEX16(COLOR_RED, ledOnColor);
+  TEST_ASSERT_EQUAL_UINT32(0, lastNTPUtc);
+  struct timeval tv;
+  gettimeofday(&tv, nullptr);
+  TEST_ASSERT_EQUAL_UINT32(0, tv.tv_sec);  // Clock left unset for NTP
+}
+
+void setUp() {
+  memset(ESP.rtcMemory, 0, sizeof(ESP.rtcMemory));
+  hostMicros = 0;
+}
+
+void tearDown() {}
+
+void test_warm_resets_restore() {
+  const uint32_t reasons[] = {REASON_SOFT_RESTART, REASON_WDT_RST, REASON_EXCEPTION_RST, REASON_SOFT_WDT_RST};
+  TEST_ASSERT_NOT_EQUAL(0, displayModes[2].dwellMs);  // Only rotation modes are restored
+  for (uint32_t reason : reasons) {
+    takeSnapshot();
+    reset(reason);
+    TEST_ASSERT_TRUE(restoreRtcState());
+    TEST_ASSERT_EQUAL(2, currentMode);
+    TEST_ASSERT_EQUAL(3, currentTimezone);
+    TEST_ASSERT_EQUAL(1, displayStyle);
+    TEST_ASSERT_TRUE(use24HourFormat);
+    TEST_ASSERT_TRUE(useFahrenheit);
+    TEST_ASSERT_EQUAL_HEX16(COLOR_GREEN, ledOnColor);
+    TEST_ASSERT_EQUAL_INT32(-42, clockDriftPpm);
+    TEST_ASSERT_EQUAL_UINT32(SNAPSHOT_UTC - 600, lastNTPUtc);
+
+    // Snapshot time + 250ms + 1.5s of boot
+    struct timeval tv;
+    gettimeofday(&tv, nullptr);
+    TEST_ASSERT_EQUAL_UINT32(SNAPSHOT_UTC + 1, tv.tv_sec);
+    TEST_ASSERT_EQUAL_UINT32(750000, tv.tv_usec);
+  }
+}
+
+// Power-on, deep sleep wake and the reset pin: the snapshot is valid but
+// could be any age, so nothing is restored
+void test_other_resets_ignore_snapshot() {
+  const uint32_t reasons[] = {REASON_DEFAULT_RST, REASON_DEEP_SLEEP_AWAKE, REASON_EXT_SYS_RST};
+  for (uint32_t reason : reasons) {
+    takeSnapshot();
+    reset(reason);
+    TEST_ASSERT_FALSE(restoreRtcState());
+    assertDefaults();
+  }
+}
+
+void test_damaged_snapshot_ignored() {
+  takeSnapshot();
+  ESP.rtcMemory[2] ^= 0x100;  // utc field: CRC no longer matches
+  reset(REASON_SOFT_RESTART);
+  TEST_ASSERT_FALSE(restoreRtcState());
+  assertDefaults();
+
+  // Power-on garbage
+  for (int i = 0; i < 128; i++) ESP.rtcMemory[i] = i * 2654435761UL;
+  TEST_ASSERT_FALSE(restoreRtcState());
+  assertDefaults();
+}
+
+// No snapshot is taken before the clock is valid
+void test_nothing_saved_without_time() {
+  setWallClock(1000, 0);
+  saveRtcState();
+  for (int i = 0; i < 128; i++) TEST_ASSERT_EQUAL_HEX32(0, ESP.rtcMemory[i]);
+  reset(REASON_SOFT_RESTART);
+  TEST_ASSERT_FALSE(restoreRtcState());
+}
+
+// setup() end to end after a watchdog reset: warm boot, settings back
+// before anything is drawn
+void test_setup_after_watchdog_reset() {
+  takeSnapshot();
+  reset(REASON_WDT_RST);
+  setup();
+  TEST_ASSERT_TRUE(warmBoot);
+  TEST_ASSERT_EQUAL(3, currentTimezone);
+  TEST_ASSERT_EQUAL_HEX16(COLOR_GREEN, ledOnColor);
+  TEST_ASSERT_EQUAL(SCHED_MAX_TASKS, scheduler.count());  // Every task registered, table exactly full
+}
+
+int main() {
+  UNITY_BEGIN();
+  RUN_TEST(test_warm_resets_restore);
+  RUN_TEST(test_other_resets_ignore_snapshot);
+  RUN_TEST(test_damaged_snapshot_ignored);
+  RUN_TEST(test_nothing_saved_without_time);
+  RUN_TEST(test_setup_after_watchdog_reset);  // Last: setup() runs once per binary
+  return UNITY_END();
+}
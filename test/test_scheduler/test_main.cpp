@@ -0,0 +1,186 @@
+/*
+ * Scheduler on a fake clock: ordering, priority, one-shots, runIn(),
+ * missed periods and load accounting (include/scheduler.h)
+ */
+
+#include <unity.h>
+#include "scheduler.h"
+
+static uint32_t now;
+static uint32_t fakeClock() { return now; }
+
+static Scheduler* sched;
+static char order[16];
+static int orderLen;
+
+static void record(char c) {
+  if (orderLen < (int)sizeof(order) - 1) order[orderLen++] = c;
+  order[orderLen] = 0;
+}
+
+static void taskA() { record('A'); }
+static void taskB() { record('B'); }
+static void taskC() { record('C'); }
+static void taskBusy() { record('W'); now += 25; }  // Takes 25ms of "CPU"
+
+static int selfId;
+static void taskSelfDelay() { record('S'); sched->runIn(selfId, 7); }
+
+void setUp() {
+  now = 1000;
+  orderLen = 0;
+  order[0] = 0;
+  sched = new Scheduler(fakeClock);
+}
+
+void tearDown() {
+  delete sched;
+}
+
+void test_nothing_runs_before_its_deadline() {
+  sched->addPeriodic("a", taskA, 100, 0);
+  TEST_ASSERT_EQUAL_UINT32(100, sched->runDue());
+  now += 99;
+  TEST_ASSERT_EQUAL_UINT32(1, sched->runDue());
+  TEST_ASSERT_EQUAL_STRING("", order);
+  now += 1;
+  sched->runDue();
+  TEST_ASSERT_EQUAL_STRING("A", order);
+}
+
+void test_earliest_deadline_first_at_equal_priority() {
+  sched->addPeriodic("b", taskB, 50, 1, 20);
+  sched->addPeriodic("a", taskA, 50, 1, 10);
+  sched->addPeriodic("c", taskC, 50, 1, 30);
+  now += 30;
+  sched->runDue();
+  TEST_ASSERT_EQUAL_STRING("ABC", order);
+}
+
+void test_higher_priority_runs_first() {
+  sched->addPeriodic("a", taskA, 50, 0, 0);
+  sched->addPeriodic("b", taskB, 50, 3, 10);
+  sched->addPeriodic("c", taskC, 50, 1, 5);
+  now += 10;
+  sched->runDue();
+  TEST_ASSERT_EQUAL_STRING("BCA", order);
+}
+
+void test_one_shot_runs_once_until_rearmed() {
+  int id = sched->addOneShot("a", taskA, 10, 0);
+  now += 10;
+  sched->runDue();
+  now += 100;
+  TEST_ASSERT_EQUAL_UINT32(1000, sched->runDue());
+  TEST_ASSERT_EQUAL_STRING("A", order);
+  TEST_ASSERT_FALSE(sched->task(id).active);
+
+  sched->runIn(id, 5);
+  TEST_ASSERT_EQUAL_UINT32(5, sched->runDue());
+  now += 5;
+  sched->runDue();
+  TEST_ASSERT_EQUAL_STRING("AA", order);
+}
+
+void test_run_in_from_inside_the_task_replaces_the_period() {
+  selfId = sched->addPeriodic("s", taskSelfDelay, 100, 0, 0);
+  sched->runDue();
+  TEST_ASSERT_EQUAL_UINT32(now + 7, sched->task(selfId).deadline);
+  TEST_ASSERT_EQUAL_UINT32(7, sched->timeUntilNext(1000));
+}
+
+void test_run_in_moves_another_task() {
+  int a = sched->addPeriodic("a", taskA, 100, 0);
+  sched->runIn(a, 3);
+  now += 3;
+  sched->runDue();
+  TEST_ASSERT_EQUAL_STRING("A", order);
+  TEST_ASSERT_EQUAL_UINT32(now + 100, sched->task(a).deadline);  // Period resumes from the new phase
+}
+
+void test_missed_periods_are_skipped_not_burst() {
+  int a = sched->addPeriodic("a", taskA, 10, 0, 0);
+  sched->runDue();
+  now += 35;  // Next deadline was +10: 25ms (2.5 periods) late
+  sched->runDue();
+  TEST_ASSERT_EQUAL_STRING("AA", order);
+  TEST_ASSERT_EQUAL_UINT32(1, sched->task(a).overruns);
+  TEST_ASSERT_EQUAL_UINT32(25, sched->task(a).maxLatency);
+  TEST_ASSERT_EQUAL_UINT32(now + 10, sched->task(a).deadline);
+}
+
+void test_periodic_keeps_its_phase() {
+  int a = sched->addPeriodic("a", taskA, 10, 0, 0);
+  sched->runDue();
+  now += 13;  // Late, but within one period
+  sched->runDue();
+  TEST_ASSERT_EQUAL_UINT32(1020, sched->task(a).deadline);
+  TEST_ASSERT_EQUAL_UINT32(0, sched->task(a).overruns);
+}
+
+void test_inactive_task_does_not_run_or_wake() {
+  int a = sched->addPeriodic("a", taskA, 10, 0, 0);
+  sched->setActive(a, false);
+  now += 50;
+  TEST_ASSERT_EQUAL_UINT32(500, sched->runDue(500));
+  TEST_ASSERT_EQUAL_STRING("", order);
+}
+
+void test_sleep_is_capped_and_zero_when_due() {
+  sched->addPeriodic("a", taskA, 5000, 0);
+  TEST_ASSERT_EQUAL_UINT32(1000, sched->runDue(1000));
+  now += 5000;
+  TEST_ASSERT_EQUAL_UINT32(0, sched->timeUntilNext(1000));
+}
+
+void test_deadlines_survive_clock_wrap() {
+  now = 0xFFFFFFF0UL;
+  sched->addPeriodic("a", taskA, 32, 0);
+  now += 31;  // Wrapped past zero
+  sched->runDue();
+  TEST_ASSERT_EQUAL_STRING("", order);
+  now += 1;
+  sched->runDue();
+  TEST_ASSERT_EQUAL_STRING("A", order);
+}
+
+void test_load_percent_counts_time_inside_tasks() {
+  int w = sched->addPeriodic("w", taskBusy, 100, 0, 0);
+  sched->runDue();                 // Runs at t=0 for 25ms
+  now = 1100;
+  sched->runDue();                 // t=100, another 25ms
+  now = 1200;
+  TEST_ASSERT_EQUAL_UINT8(25, sched->loadPercent());
+  TEST_ASSERT_EQUAL_UINT32(2, sched->task(w).runs);
+  TEST_ASSERT_EQUAL_UINT32(25, sched->task(w).maxRunTime);
+
+  sched->resetStats();
+  TEST_ASSERT_EQUAL_UINT8(0, sched->loadPercent());
+  TEST_ASSERT_EQUAL_UINT32(0, sched->task(w).runs);
+}
+
+void test_table_is_bounded() {
+  for (int i = 0; i < SCHED_MAX_TASKS; i++) {
+    TEST_ASSERT_EQUAL_INT(i, sched->addPeriodic("a", taskA, 10, 0));
+  }
+  TEST_ASSERT_EQUAL_INT(SCHED_INVALID, sched->addPeriodic("a", taskA, 10, 0));
+  TEST_ASSERT_EQUAL_INT(SCHED_INVALID, Scheduler(fakeClock).addPeriodic("x", nullptr, 10, 0));
+}
+
+int main() {
+  UNITY_BEGIN();
+  RUN_TEST(test_nothing_runs_before_its_deadline);
+  RUN_TEST(test_earliest_deadline_first_at_equal_priority);
+  RUN_TEST(test_higher_priority_runs_first);
+  RUN_TEST(test_one_shot_runs_once_until_rearmed);
+  RUN_TEST(test_run_in_from_inside_the_task_replaces_the_period);
+  RUN_TEST(test_run_in_moves_another_task);
+  RUN_TEST(test_missed_periods_are_skipped_not_burst);
+  RUN_TEST(test_periodic_keeps_its_phase);
+  RUN_TEST(test_inactive_task_does_not_run_or_wake);
+  RUN_TEST(test_sleep_is_capped_and_zero_when_due);
+  RUN_TEST(test_deadlines_survive_clock_wrap);
+  RUN_TEST(test_load_percent_counts_time_inside_tasks);
+  RUN_TEST(test_table_is_bounded);
+  return UNITY_END();
+}
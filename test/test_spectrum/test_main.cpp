@@ -0,0 +1,155 @@
+/*
+ * Spectrum analyser (include/spectrum.h) on synthetic 10-bit ADC windows:
+ * tones land in their bin and column, silence lights nothing, and the
+ * capture window fills once and waits for compute()
+ */
+
+#include <unity.h>
+#include "spectrum.h"
+
+#define SAMPLE_RATE 8000   // Same as SPECTRUM_SAMPLE_RATE: 62.5Hz per bin
+#define MID_SCALE   512
+
+static SpectrumAnalyzer* spectrum;
+static uint8_t heights[SPECTRUM_COLUMNS];
+
+// One full window of a tone at `hz`, amplitude in ADC counts, around mid-scale
+static void captureTone(double hz, int amplitude) {
+  for (int i = 0; i < SPECTRUM_FFT_SIZE; i++) {
+    spectrum->pushSample(MID_SCALE + (int16_t)lround(amplitude * sin(2 * M_PI * hz * i / SAMPLE_RATE)));
+  }
+}
+
+static int columnOfBin(int bin) {
+  for (int c = 0; c < SPECTRUM_COLUMNS; c++) {
+    if (bin >= spectrum->columnFirstBin(c) && bin < spectrum->columnEndBin(c)) return c;
+  }
+  return -1;
+}
+
+static int loudestBin() {
+  int best = 1;
+  for (int k = 1; k < SPECTRUM_FFT_SIZE / 2; k++) {
+    if (spectrum->magnitude(k) > spectrum->magnitude(best)) best = k;
+  }
+  return best;
+}
+
+void setUp() {
+  spectrum = new SpectrumAnalyzer();
+  spectrum->begin();
+  spectrum->setNoiseFloor(2);
+  memset(heights, 0, sizeof(heights));
+}
+
+void tearDown() {
+  delete spectrum;
+}
+
+// Every bin 1..N/2-1 in exactly one column, in order
+void test_columns_cover_every_bin() {
+  TEST_ASSERT_EQUAL(1, spectrum->columnFirstBin(0));
+  TEST_ASSERT_EQUAL(SPECTRUM_FFT_SIZE / 2, spectrum->columnEndBin(SPECTRUM_COLUMNS - 1));
+  for (int c = 0; c < SPECTRUM_COLUMNS; c++) {
+    TEST_ASSERT_TRUE(spectrum->columnEndBin(c) > spectrum->columnFirstBin(c));
+    if (c > 0) TEST_ASSERT_EQUAL(spectrum->columnEndBin(c - 1), spectrum->columnFirstBin(c));
+  }
+}
+
+// 1kHz = bin 16 exactly: that bin is the loudest and its column the tallest
+// (quiet enough that the bars don't clip at SPECTRUM_HEIGHT)
+void test_sine_lands_in_its_bin() {
+  captureTone(1000, 50);
+  spectrum->compute(heights);
+  TEST_ASSERT_EQUAL(16, loudestBin());
+  int column = columnOfBin(16);
+  TEST_ASSERT_TRUE(column >= 0);
+  for (int c = 0; c < SPECTRUM_COLUMNS; c++) {
+    if (c != column) TEST_ASSERT_TRUE(heights[c] < heights[column]);
+  }
+  TEST_ASSERT_TRUE(heights[column] >= SPECTRUM_HEIGHT / 2);
+}
+
+// Higher tones further right, a tone between bins still peaks at the nearest
+void test_tones_across_the_band() {
+  const double tones[] = {250, 1590, 2500, 3500};  // 1590Hz = bin 25.4
+  int lastColumn = -1;
+  for (double hz : tones) {
+    captureTone(hz, 300);
+    spectrum->compute(heights);
+    int bin = (int)lround(hz * SPECTRUM_FFT_SIZE / SAMPLE_RATE);
+    TEST_ASSERT_INT_WITHIN(1, bin, loudestBin());
+    int column = columnOfBin(loudestBin());
+    TEST_ASSERT_TRUE(column > lastColumn);
+    lastColumn = column;
+  }
+}
+
+// Silence (any DC level) gives no bars and no peaks
+void test_silence_gives_no_bars() {
+  const int levels[] = {0, MID_SCALE, 1023};
+  for (int level : levels) {
+    for (int i = 0; i < SPECTRUM_FFT_SIZE; i++) spectrum->pushSample(level);
+    spectrum->compute(heights);
+    for (int c = 0; c < SPECTRUM_COLUMNS; c++) {
+      TEST_ASSERT_EQUAL(0, heights[c]);
+      TEST_ASSERT_EQUAL(0, spectrum->peak(c));
+    }
+  }
+  uint8_t frame[SPECTRUM_COLUMNS * 2];
+  memset(frame, 0xAA, sizeof(frame));
+  spectrum->draw(heights, frame, SPECTRUM_COLUMNS);
+  for (unsigned i = 0; i < sizeof(frame); i++) TEST_ASSERT_EQUAL_HEX8(0, frame[i]);
+}
+
+// The window fills once, later samples are dropped until compute() empties it
+void test_capture_window() {
+  TEST_ASSERT_FALSE(spectrum->ready());
+  for (int i = 0; i < SPECTRUM_FFT_SIZE - 1; i++) TEST_ASSERT_FALSE(spectrum->pushSample(MID_SCALE));
+  TEST_ASSERT_TRUE(spectrum->pushSample(MID_SCALE));
+  TEST_ASSERT_TRUE(spectrum->ready());
+
+  // A loud tone arriving now doesn't reach the full window
+  captureTone(1000, 400);
+  spectrum->compute(heights);
+  for (int c = 0; c < SPECTRUM_COLUMNS; c++) TEST_ASSERT_EQUAL(0, heights[c]);
+  TEST_ASSERT_FALSE(spectrum->ready());
+  TEST_ASSERT_EQUAL_UINT32(1, spectrum->windowCount());
+
+  captureTone(1000, 400);
+  TEST_ASSERT_TRUE(spectrum->ready());
+  spectrum->compute(heights);
+  TEST_ASSERT_EQUAL(16, loudestBin());
+}
+
+// Peak dot holds above a falling bar and drops one row per decay
+void test_peak_hold_decays() {
+  captureTone(1000, 300);
+  spectrum->compute(heights);
+  int column = columnOfBin(16);
+  uint8_t top = heights[column];
+  TEST_ASSERT_EQUAL(top, spectrum->peak(column));
+
+  for (int i = 0; i < SPECTRUM_FFT_SIZE; i++) spectrum->pushSample(MID_SCALE);
+  spectrum->compute(heights);
+  TEST_ASSERT_EQUAL(0, heights[column]);
+  TEST_ASSERT_EQUAL(top, spectrum->peak(column));
+  spectrum->decayPeaks();
+  TEST_ASSERT_EQUAL(top - 1, spectrum->peak(column));
+
+  uint8_t frame[SPECTRUM_COLUMNS * 2];
+  spectrum->draw(heights, frame, SPECTRUM_COLUMNS);
+  uint16_t col = frame[column] | (frame[column + SPECTRUM_COLUMNS] << 8);
+  TEST_ASSERT_EQUAL_HEX16(1 << (SPECTRUM_HEIGHT - (top - 1)), col);
+}
+
+int main() {
+  UNITY_BEGIN();
+  RUN_TEST(test_columns_cover_every_bin);
+  RUN_TEST(test_sine_lands_in_its_bin);
+  RUN_TEST(test_tones_across_the_band);
+  RUN_TEST(test_silence_gives_no_bars);
+  RUN_TEST(test_capture_window);
+  RUN_TEST(test_peak_hold_decays);
+  return UNITY_END();
+}
@@ -0,0 +1,180 @@
+/*
+ * SPI clock calibration (include/spi_calibration.h) against a mock panel
+ * that corrupts read-back at chosen clocks: baseline failure, the cutoff
+ * at the first failing clock, and manual clocks through verify()
+ */
+
+#include <unity.h>
+#include "spi_calibration.h"
+
+#define NUM_CLOCKS 5
+
+static const uint32_t clocks[NUM_CLOCKS] = {16000000, 20000000, 26666667, 40000000, 80000000};
+
+// Remembers the last block written and reads it back, flipping a bit in
+// every `errorEvery`-th pixel when the write clock is one of the bad ones
+struct MockPanel {
+  uint32_t hz = 0;
+  uint32_t badHz[NUM_CLOCKS] = {0};
+  int numBad = 0;
+  int errorEvery = 1;
+  bool noMiso = false;
+  uint16_t block[SPI_CAL_PIXELS];
+  int writes = 0;
+  int redraws = 0;
+  uint32_t clockSets = 0;
+
+  void setClock(uint32_t clock) {
+    hz = clock;
+    clockSets++;
+  }
+  void writePixels(const uint16_t* px, int n) {
+    writes++;
+    for (int i = 0; i < n; i++) block[i] = px[i];
+    if (!isBad()) return;
+    for (int i = 0; i < n; i += errorEvery) block[i] ^= 0x0100;
+  }
+  bool readPixels(uint16_t* px, int n) {
+    if (noMiso) return false;
+    for (int i = 0; i < n; i++) px[i] = block[i];
+    return true;
+  }
+  uint32_t redrawUs() {
+    redraws++;
+    return 1000000000UL / hz;  // Faster clock, faster redraw
+  }
+
+  void fail(uint32_t clock) { badHz[numBad++] = clock; }
+  bool isBad() const {
+    for (int i = 0; i < numBad; i++) {
+      if (badHz[i] == hz) return true;
+    }
+    return false;
+  }
+};
+
+static MockPanel* panel;
+static SpiCalibrator<MockPanel>* cal;
+
+void setUp() {
+  panel = new MockPanel();
+  cal = new SpiCalibrator<MockPanel>(*panel);
+}
+
+void tearDown() {
+  delete cal;
+  delete panel;
+}
+
+void test_clean_panel_takes_fastest() {
+  TEST_ASSERT_EQUAL_UINT32(80000000, cal->run(clocks, NUM_CLOCKS, 40000000));
+  TEST_ASSERT_EQUAL_UINT32(80000000, panel->hz);
+  TEST_ASSERT_TRUE(cal->baselinePassed());
+  TEST_ASSERT_FALSE(cal->anyFailed());
+  TEST_ASSERT_EQUAL(NUM_CLOCKS, cal->trialCount());
+  TEST_ASSERT_EQUAL(NUM_CLOCKS, panel->redraws);
+  TEST_ASSERT_EQUAL_UINT32(1000000000UL / 80000000, cal->chosenRedrawUs());
+  for (int i = 0; i < NUM_CLOCKS; i++) {
+    TEST_ASSERT_EQUAL_UINT32(0, cal->result(i).errors);
+    TEST_ASSERT_EQUAL_UINT32(SPI_CAL_ROUNDS * SPI_CAL_PATTERNS * SPI_CAL_PIXELS, cal->result(i).pixels);
+  }
+  TEST_ASSERT_EQUAL(NUM_CLOCKS * SPI_CAL_ROUNDS * SPI_CAL_PATTERNS, panel->writes);
+}
+
+// 40MHz corrupts: stop there, nothing above it is tried
+void test_first_failure_cuts_off() {
+  panel->fail(40000000);
+  panel->fail(80000000);
+  TEST_ASSERT_EQUAL_UINT32(26666667, cal->run(clocks, NUM_CLOCKS, 40000000));
+  TEST_ASSERT_EQUAL_UINT32(26666667, panel->hz);
+  TEST_ASSERT_TRUE(cal->anyFailed());
+  TEST_ASSERT_EQUAL(4, cal->trialCount());
+  TEST_ASSERT_EQUAL_UINT32(40000000, cal->result(3).hz);
+  TEST_ASSERT_EQUAL_UINT32(SPI_CAL_ROUNDS * SPI_CAL_PATTERNS * SPI_CAL_PIXELS, cal->result(3).errors);
+  TEST_ASSERT_EQUAL_UINT32(0, cal->result(3).redrawUs);  // Not timed
+  TEST_ASSERT_EQUAL(3, panel->redraws);
+}
+
+// 80MHz reads back clean above a failing 26.67MHz - still not trusted
+void test_faster_pass_above_failure_not_trusted() {
+  panel->fail(26666667);
+  TEST_ASSERT_EQUAL_UINT32(20000000, cal->run(clocks, NUM_CLOCKS, 40000000));
+  TEST_ASSERT_EQUAL_UINT32(20000000, panel->hz);
+  TEST_ASSERT_EQUAL(3, cal->trialCount());
+  TEST_ASSERT_EQUAL_UINT32(1000000000UL / 20000000, cal->chosenRedrawUs());
+}
+
+// One wrong pixel in a whole run is enough to fail a clock
+void test_single_pixel_error_fails() {
+  panel->fail(80000000);
+  panel->errorEvery = SPI_CAL_PIXELS;
+  TEST_ASSERT_EQUAL_UINT32(40000000, cal->run(clocks, NUM_CLOCKS, 40000000));
+  TEST_ASSERT_EQUAL_UINT32(SPI_CAL_ROUNDS * SPI_CAL_PATTERNS, cal->result(4).errors);
+}
+
+// Baseline corrupts: nothing chosen, panel back at the fallback
+void test_baseline_failure() {
+  panel->fail(16000000);
+  TEST_ASSERT_EQUAL_UINT32(0, cal->run(clocks, NUM_CLOCKS, 40000000));
+  TEST_ASSERT_FALSE(cal->baselinePassed());
+  TEST_ASSERT_TRUE(cal->anyFailed());
+  TEST_ASSERT_EQUAL(1, cal->trialCount());
+  TEST_ASSERT_EQUAL_UINT32(40000000, panel->hz);
+  TEST_ASSERT_EQUAL_UINT32(0, cal->chosenRedrawUs());
+  TEST_ASSERT_EQUAL(0, panel->redraws);
+}
+
+void test_no_read_path() {
+  panel->noMiso = true;
+  TEST_ASSERT_EQUAL_UINT32(0, cal->run(clocks, NUM_CLOCKS, 26666667));
+  TEST_ASSERT_EQUAL_UINT32(26666667, panel->hz);
+  TEST_ASSERT_EQUAL_UINT32(SPI_CAL_ROUNDS * SPI_CAL_PATTERNS * SPI_CAL_PIXELS, cal->result(0).errors);
+}
+
+// A later run starts from scratch
+void test_rerun_replaces_results() {
+  panel->fail(40000000);
+  cal->run(clocks, NUM_CLOCKS, 40000000);
+  panel->numBad = 0;
+  TEST_ASSERT_EQUAL_UINT32(80000000, cal->run(clocks, NUM_CLOCKS, 40000000));
+  TEST_ASSERT_EQUAL(NUM_CLOCKS, cal->trialCount());
+  TEST_ASSERT_FALSE(cal->anyFailed());
+  TEST_ASSERT_EQUAL_UINT32(2, cal->runCount());
+}
+
+void test_verify_clean_clock() {
+  TEST_ASSERT_EQUAL_UINT32(0, cal->verify(26666667, clocks[0], 40000000));
+  TEST_ASSERT_EQUAL_UINT32(26666667, panel->hz);
+  TEST_ASSERT_EQUAL(0, cal->trialCount());  // Last run's results untouched
+  TEST_ASSERT_EQUAL(0, panel->redraws);
+}
+
+void test_verify_bad_clock_falls_back() {
+  panel->fail(80000000);
+  uint32_t errors = cal->verify(80000000, clocks[0], 40000000);
+  TEST_ASSERT_EQUAL_UINT32(SPI_CAL_ROUNDS * SPI_CAL_PATTERNS * SPI_CAL_PIXELS, errors);
+  TEST_ASSERT_EQUAL_UINT32(40000000, panel->hz);
+}
+
+// Without a working baseline the manual clock isn't even tried
+void test_verify_without_read_path() {
+  panel->noMiso = true;
+  TEST_ASSERT_EQUAL_UINT32(SPI_CAL_UNVERIFIED, cal->verify(26666667, clocks[0], 40000000));
+  TEST_ASSERT_EQUAL_UINT32(40000000, panel->hz);
+  TEST_ASSERT_EQUAL(SPI_CAL_ROUNDS * SPI_CAL_PATTERNS, panel->writes);
+}
+
+int main() {
+  UNITY_BEGIN();
+  RUN_TEST(test_clean_panel_takes_fastest);
+  RUN_TEST(test_first_failure_cuts_off);
+  RUN_TEST(test_faster_pass_above_failure_not_trusted);
+  RUN_TEST(test_single_pixel_error_fails);
+  RUN_TEST(test_baseline_failure);
+  RUN_TEST(test_no_read_path);
+  RUN_TEST(test_rerun_replaces_results);
+  RUN_TEST(test_verify_clean_clock);
+  RUN_TEST(test_verify_bad_clock_falls_back);
+  RUN_TEST(test_verify_without_read_path);
+  return UNITY_END();
+}